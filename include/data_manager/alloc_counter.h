@@ -0,0 +1,15 @@
+#ifndef RM2024_DATA_MANAGER_ALLOC_COUNTER_H_
+#define RM2024_DATA_MANAGER_ALLOC_COUNTER_H_
+
+#include <cstdint>
+
+// 堆分配计数: 定义 TJURM_ALLOC_COUNT 时重载全局 operator new 并替换 cv::Mat 默认分配器，
+// 按线程统计分配次数，用于确认跟踪线程稳态循环不再访问堆；未定义时两个函数均为空操作
+
+// 安装 cv::Mat 计数分配器，需在创建任何线程之前调用
+void initAllocCounter();
+
+// 当前线程累计的堆分配次数 (operator new 与 cv::Mat 数据区)
+uint64_t getThreadAllocCount();
+
+#endif
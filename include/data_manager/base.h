@@ -14,7 +14,7 @@ extern rm::ArmorColor self_color;
 extern rm::ArmorID self_id;
 extern rm::ArmorID target_id;
 extern double target_omega;
-extern double target_dist;
+extern std::atomic<double> target_dist;
 
 extern std::vector<rm::Camera*> camera;
 extern int camera_index;
@@ -58,6 +58,7 @@ extern bool histogram_flag;
 extern bool reprojection_flag;
 extern bool pipeline_delay_flag;
 extern bool point_skip_flag;
+extern bool benchmark_flag;
 
 extern bool state_delay_flag;
 extern double state_delay_time;
@@ -68,6 +69,8 @@ extern int send_wait_time;
 
 void init_debug();
 bool init_camera();
+bool init_camera_offline(int width, int height);
+bool init_camera_replay(const std::string& video_path);
 bool deinit_camera();
 void init_serial();
 void init_attack();
@@ -0,0 +1,129 @@
+#ifndef RM2024_DATA_MANAGER_CONFIG_H_
+#define RM2024_DATA_MANAGER_CONFIG_H_
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+// 热路径使用的配置项解析、校验为定长类型的只读快照，启动时构建，热更新时整体替换
+// 路径以 '/' 分隔，"$Type" 表示取同级 "Type" 字段的值作为键名
+namespace config {
+using Vec1  = std::array<double, 1>;
+using Vec2  = std::array<double, 2>;
+using Vec3  = std::array<double, 3>;
+using Vec4  = std::array<double, 4>;
+using Vec5  = std::array<double, 5>;
+using Vec6  = std::array<double, 6>;
+using Vec8  = std::array<double, 8>;
+using Vec9  = std::array<double, 9>;
+using Vec11 = std::array<double, 11>;
+using IntList = std::vector<int>;
+
+#if defined(TJURM_DRONSE)
+using OutpostQ = Vec8;
+#else
+using OutpostQ = Vec5;
+#endif
+}
+
+#define CONFIG_SNAPSHOT_FIELDS(X)                                                                   \
+    /* pointer */                                                                                   \
+    X(double,           ratio_red,                  "Points/Threshold/RatioRed")                    \
+    X(double,           ratio_blue,                 "Points/Threshold/RatioBlue")                   \
+    X(double,           lb_min_rect_side,           "Points/Lightbar/MinRectSide")                  \
+    X(double,           lb_max_rect_side,           "Points/Lightbar/MaxRectSide")                  \
+    X(double,           lb_min_area,                "Points/Lightbar/MinArea")                      \
+    X(double,           lb_min_ratio_area,          "Points/Lightbar/MinRatioArea")                 \
+    X(double,           lb_max_angle,               "Points/Lightbar/MaxAngle")                     \
+    /* 发弹延迟 */                                                                                   \
+    X(double,           shoot_speed,                "Car/ShootSpeed")                               \
+    X(double,           shoot_delay,                "Car/ShootDelay")                               \
+    X(double,           rotate_delay,               "Car/RotateDelay")                              \
+    X(double,           rotate_delay_outpost,       "Car/RotateDelayOutpost")                       \
+    X(double,           rotate_delay_rune,          "Car/RotateDelayRune")                          \
+    X(double,           start_fire_delay,           "Car/StartFireDelay")                           \
+    /* 检测类别映射 */                                                                               \
+    X(config::IntList,  armor_class_map,            "Model/YoloArmor/$Type/ClassMap")               \
+    /* 跟踪队列 */                                                                                   \
+    X(double,           track_count,                "Kalman/TrackQueue/Count")                      \
+    X(double,           track_dist,                 "Kalman/TrackQueue/Distance")                   \
+    X(double,           track_delay,                "Kalman/TrackQueue/Delay")                      \
+    X(config::Vec8,     track_car_q,                "Kalman/TrackQueue/CarQ")                       \
+    X(config::Vec3,     track_car_r,                "Kalman/TrackQueue/CarR")                       \
+    X(config::Vec11,    track_tower_q,              "Kalman/TrackQueue/TowerQ")                     \
+    X(config::Vec4,     track_tower_r,              "Kalman/TrackQueue/TowerR")                     \
+    /* 整车模型 */                                                                                   \
+    X(double,           antitop_min_r,              "Kalman/Antitop/MinR")                          \
+    X(double,           antitop_max_r,              "Kalman/Antitop/MaxR")                          \
+    X(int,              antitop_fire_update,        "Kalman/Antitop/FireUpdate")                    \
+    X(double,           antitop_fire_delay,         "Kalman/Antitop/FireDelay")                     \
+    X(double,           antitop_fire_angle,         "Kalman/Antitop/FireAngle/Armor")               \
+    X(double,           antitop_fire_angle_big,     "Kalman/Antitop/FireAngle/CenterBig")           \
+    X(double,           antitop_fire_angle_small,   "Kalman/Antitop/FireAngle/CenterSmall")         \
+    X(config::Vec9,     antitop_q,                  "Kalman/Antitop/Q")                             \
+    X(config::Vec4,     antitop_r,                  "Kalman/Antitop/R")                             \
+    X(config::Vec4,     antitop_center_q,           "Kalman/Antitop/CenterQ")                       \
+    X(config::Vec2,     antitop_center_r,           "Kalman/Antitop/CenterR")                       \
+    X(config::Vec3,     antitop_omega_q,            "Kalman/Antitop/OmegaQ")                        \
+    X(config::Vec1,     antitop_omega_r,            "Kalman/Antitop/OmegaR")                        \
+    X(config::Vec3,     antitop_balance_omega_q,    "Kalman/Antitop/BalanceOmegaQ")                 \
+    X(config::Vec1,     antitop_balance_omega_r,    "Kalman/Antitop/BalanceOmegaR")                 \
+    X(double,           switch_track_to_antitop,    "Kalman/Switch/TrackToAntitop")                 \
+    X(double,           switch_antitop_to_track,    "Kalman/Switch/AntitopToTrack")                 \
+    X(double,           switch_armor_to_center,     "Kalman/Switch/ArmorToCenter")                  \
+    X(double,           switch_center_to_armor,     "Kalman/Switch/CenterToArmor")                  \
+    /* 前哨站模型 */                                                                                 \
+    X(int,              outpost_fire_update,        "Kalman/Outpost/FireUpdate")                    \
+    X(double,           outpost_fire_delay,         "Kalman/Outpost/FireDelay")                     \
+    X(double,           outpost_fire_angle,         "Kalman/Outpost/FireAngle/Armor")               \
+    X(double,           outpost_fire_angle_center,  "Kalman/Outpost/FireAngle/Center")              \
+    X(config::OutpostQ, outpost_q,                  "Kalman/Outpost/Q")                             \
+    X(config::Vec4,     outpost_r,                  "Kalman/Outpost/R")                             \
+    X(config::Vec2,     outpost_omega_q,            "Kalman/Outpost/OmegaQ")                        \
+    X(config::Vec1,     outpost_omega_r,            "Kalman/Outpost/OmegaR")                        \
+    /* 能量机关模型 */                                                                               \
+    X(config::Vec6,     rune_small_q,               "Kalman/Rune/SmallQ")                           \
+    X(config::Vec5,     rune_small_r,               "Kalman/Rune/SmallR")                           \
+    X(config::Vec8,     rune_big_q,                 "Kalman/Rune/BigQ")                             \
+    X(config::Vec5,     rune_big_r,                 "Kalman/Rune/BigR")                             \
+    X(config::Vec2,     rune_spd_q,                 "Kalman/Rune/SpdQ")                             \
+    X(config::Vec1,     rune_spd_r,                 "Kalman/Rune/SpdR")                             \
+    X(double,           rune_big_fire_spd,          "Kalman/Rune/BigRuneFireSpd")                   \
+    X(double,           rune_fire_after_trans,      "Kalman/Rune/FireAfterTransDelay")              \
+    X(double,           rune_fire_flag_keep,        "Kalman/Rune/FireFlagKeepDelay")                \
+    X(double,           rune_fire_interval,         "Kalman/Rune/FireIntervalDelay")                \
+    X(double,           rune_turn_to_center,        "Kalman/Rune/TureToCenterDelay")                \
+    /* 录像 */                                                                                       \
+    X(std::string,      video_save_dir,             "Camera/VideoSaveDir")
+
+struct ConfigSnapshot {
+#define CONFIG_SNAPSHOT_DECLARE(type, name, path) type name{};
+    CONFIG_SNAPSHOT_FIELDS(CONFIG_SNAPSHOT_DECLARE)
+#undef CONFIG_SNAPSHOT_DECLARE
+
+    int version = 0;                                        // 发布序号，启动时为 1，每次热更新加一
+    std::chrono::steady_clock::time_point publish_time;     // 发布时刻，用于统计生效延迟
+};
+
+using ConfigPtr = std::shared_ptr<const ConfigSnapshot>;
+
+// 按字段表解析 root，缺失或类型、长度不符的键逐条写入 errors，有错误时返回 nullptr
+ConfigPtr buildConfigSnapshot(const nlohmann::json& root, std::vector<std::string>& errors);
+
+// 由 Param 构建并发布快照，失败时打印全部错误，须在各线程启动前调用
+bool initConfigSnapshot();
+
+// 当前快照，各阶段每帧取一次并在本帧内持有
+ConfigPtr getConfigSnapshot();
+
+// 两个快照间取值不同的字段路径
+std::vector<std::string> diffConfigSnapshot(const ConfigSnapshot& a, const ConfigSnapshot& b);
+
+// 后台监视配置文件，保存后重新解析、校验并发布新快照；校验失败时保留旧快照
+// 快照字段在各阶段下一帧生效，其余键变更只提示需重启
+void startConfigWatch();
+
+#endif
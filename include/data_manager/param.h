@@ -19,6 +19,8 @@ public:
     void dump(const std::string&);
 
     nlohmann::json& operator[](const std::string&);
+    const nlohmann::json& root() const { return params_; }
+    const std::string& path() const { return path_; }
 
     static void from_json(const nlohmann::json& j, cv::Mat& p);
     static void to_json(nlohmann::json& j, const cv::Mat& p);
@@ -30,6 +32,7 @@ private:
 
 private:
     nlohmann::json params_;
+    std::string path_;
     std::string default_path_ = "/home/hero/DUST_Hero/data/uniconfig/Config.json";
 
 
@@ -0,0 +1,45 @@
+#ifndef RM2024_DATA_MANAGER_STARTUP_H_
+#define RM2024_DATA_MANAGER_STARTUP_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include "data_manager/base.h"
+
+// 启动编排: 各组件在依赖全部就绪后于独立线程中初始化，互不依赖的组件并行执行
+// 依赖必须先于自身注册，保证依赖关系无环
+class Startup {
+public:
+    // func 返回 false 表示初始化失败，依赖它的组件将被跳过
+    void add(const std::string& name, const std::vector<std::string>& deps, std::function<bool()> func);
+
+    // 执行全部组件并等待结束，全部就绪时返回 true
+    bool run();
+
+    // 打印各组件相对 run() 调用时刻的开始与就绪时间线
+    void report();
+
+private:
+    enum State { kPending, kRunning, kReady, kFailed, kSkipped };
+
+    struct Stage {
+        std::string name;
+        std::vector<int> deps;
+        std::function<bool()> func;
+        State state = kPending;
+        double start_ms = 0.0;
+        double end_ms = 0.0;
+    };
+
+    void runStage(int index);
+
+    std::vector<Stage> stages_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    TimePoint start_time_;
+    double total_ms_ = 0.0;
+};
+
+#endif
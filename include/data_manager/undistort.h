@@ -0,0 +1,40 @@
+#ifndef RM2024_DATA_MANAGER_UNDISTORT_H_
+#define RM2024_DATA_MANAGER_UNDISTORT_H_
+
+#include <vector>
+#include "data_manager/base.h"
+
+// 降采样去畸变表: 以 step 像素为间隔的网格节点存放该像素对应的归一化坐标 (无畸变、单位内参)，
+// 任意像素由所在网格的四个节点双线性插值得到，替代每次 PnP 前的迭代去畸变
+class UndistortMap {
+public:
+    bool build(const rm::Camera* camera, int step);
+
+    bool empty() const { return grid_.empty(); }
+
+    cv::Point2f lookup(const cv::Point2f& pixel) const;
+    void lookup(const std::vector<cv::Point2f>& pixels, std::vector<cv::Point2f>& normalized) const;
+
+    // 在随机像素上与 cv::undistortPoints 默认迭代结果比较，误差换算为像素
+    void evaluate(const rm::Camera* camera, int samples, double& mean_error, double& max_error) const;
+
+private:
+    int step_ = 0;
+    int cols_ = 0, rows_ = 0;
+    std::vector<cv::Point2f> grid_;
+};
+
+// 为 Data::camera[camera_id] 建表并打印插值误差，须在流水线线程启动前调用
+bool buildUndistortMap(int camera_id, int step);
+
+// 第 camera_id 个相机的去畸变表，未建表时返回 nullptr
+const UndistortMap* getUndistortMap(int camera_id);
+
+// 查表后的点所对应的单位内参与空畸变系数，直接传给 cv::solvePnP
+const cv::Mat& getNormalizedIntrinsic();
+const cv::Mat& getNormalizedDistortion();
+
+// 打印单块装甲板四点查表与 cv::undistortPoints 的平均耗时
+void benchmarkUndistortMap(int camera_id, int iterations);
+
+#endif
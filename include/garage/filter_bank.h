@@ -0,0 +1,263 @@
+#ifndef RM2024_GARAGE_FILTER_BANK_H_
+#define RM2024_GARAGE_FILTER_BANK_H_
+
+#include <algorithm>
+#include <opencv2/core/hal/intrin.hpp>
+#include "garage/kalman.h"
+
+// 按通道 (目标) 连续存放的逐元素运算，长度 n，CV_SIMD_64F 可用时按向量宽度处理
+namespace bank_kernel {
+
+inline void fill(double* dst, double value, int n) {
+    for (int l = 0; l < n; l++) dst[l] = value;
+}
+
+// acc += a * b
+inline void fma(double* acc, const double* a, const double* b, int n) {
+    int l = 0;
+#if CV_SIMD_64F
+    for (; l <= n - cv::v_float64::nlanes; l += cv::v_float64::nlanes) {
+        cv::v_store(acc + l, cv::v_fma(cv::vx_load(a + l), cv::vx_load(b + l), cv::vx_load(acc + l)));
+    }
+#endif
+    for (; l < n; l++) acc[l] += a[l] * b[l];
+}
+
+// acc -= a * b
+inline void fnma(double* acc, const double* a, const double* b, int n) {
+    int l = 0;
+#if CV_SIMD_64F
+    for (; l <= n - cv::v_float64::nlanes; l += cv::v_float64::nlanes) {
+        cv::v_store(acc + l, cv::vx_load(acc + l) - cv::vx_load(a + l) * cv::vx_load(b + l));
+    }
+#endif
+    for (; l < n; l++) acc[l] -= a[l] * b[l];
+}
+
+// dst = a * b
+inline void mul(double* dst, const double* a, const double* b, int n) {
+    int l = 0;
+#if CV_SIMD_64F
+    for (; l <= n - cv::v_float64::nlanes; l += cv::v_float64::nlanes) {
+        cv::v_store(dst + l, cv::vx_load(a + l) * cv::vx_load(b + l));
+    }
+#endif
+    for (; l < n; l++) dst[l] = a[l] * b[l];
+}
+
+// dst = 1 / a
+inline void reciprocal(double* dst, const double* a, int n) {
+    int l = 0;
+#if CV_SIMD_64F
+    for (; l <= n - cv::v_float64::nlanes; l += cv::v_float64::nlanes) {
+        cv::v_store(dst + l, cv::vx_setall_f64(1.0) / cv::vx_load(a + l));
+    }
+#endif
+    for (; l < n; l++) dst[l] = 1.0 / a[l];
+}
+
+}
+
+// 多个同型滤波器的结构数组 (SoA) 存储: 每个状态、协方差元素按目标连续排列，
+// 预测与更新对所有已登记观测的目标一次完成，矩阵运算沿目标维向量化
+// 模型的状态转移、观测及其雅可比仍逐目标以标量代码计算，与单目标 EKF 共用同一模型
+// 更新采用 P = Pp - K H Pp 并对称化，与单目标 EKF 的 Joseph 形式数学等价
+template<int N, int M, class Model, int L = 16>
+class FilterBank {
+public:
+    using Types   = KalmanTypes<N, M>;
+    using VectorN = typename Types::VectorN;
+    using VectorM = typename Types::VectorM;
+    using MatrixN = typename Types::MatrixN;
+    using MatrixM = typename Types::MatrixM;
+    using MatrixMN = typename Types::MatrixMN;
+    static constexpr int kCapacity = L;
+
+    explicit FilterBank(const Model& model = Model()) : model_(model) {
+        for (int l = 0; l < L; l++) reset(l);
+    }
+
+    const Model& model() const { return model_; }
+
+    void init(int slot, const VectorN& x, const MatrixN& P) {
+        for (int i = 0; i < N; i++) {
+            x_[i][slot] = x(i);
+            for (int j = 0; j < N; j++) P_[i][j][slot] = P(i, j);
+        }
+        initialized_[slot] = true;
+        staged_[slot] = false;
+    }
+    // flush 会把所有通道一起送入向量运算，空闲通道保持零状态与单位协方差，避免读到未初始化的值
+    void reset(int slot) {
+        for (int i = 0; i < N; i++) {
+            x_[i][slot] = 0.0;
+            for (int j = 0; j < N; j++) P_[i][j][slot] = (i == j) ? 1.0 : 0.0;
+        }
+        initialized_[slot] = staged_[slot] = false;
+    }
+
+    bool initialized(int slot) const { return initialized_[slot]; }
+    bool staged(int slot) const { return staged_[slot]; }
+
+    VectorN state(int slot) const {
+        VectorN x;
+        for (int i = 0; i < N; i++) x(i) = x_[i][slot];
+        return x;
+    }
+    double& stateAt(int slot, int i) { return x_[i][slot]; }
+
+    // 登记一次观测，下一次 flush 时与其他目标一起预测 dt 秒并更新
+    void stage(int slot, const VectorM& z, double dt) {
+        for (int i = 0; i < M; i++) z_[i][slot] = z(i);
+        dt_[slot] = dt;
+        staged_[slot] = true;
+        lanes_ = std::max(lanes_, slot + 1);
+    }
+
+    // 返回本次更新的目标数
+    int flush() {
+        int n = lanes_;
+        if (n == 0) return 0;
+        int count = 0;
+
+        // 逐目标求预测状态、雅可比与噪声；未登记的通道填入不影响结果的单位量
+        for (int l = 0; l < n; l++) {
+            if (!staged_[l]) {
+                for (int i = 0; i < N; i++) {
+                    xp_[i][l] = x_[i][l];
+                    for (int j = 0; j < N; j++) F_[i][j][l] = (i == j) ? 1.0 : 0.0;
+                    for (int j = 0; j < N; j++) Q_[i][j][l] = 0.0;
+                }
+                for (int i = 0; i < M; i++) {
+                    y_[i][l] = 0.0;
+                    for (int j = 0; j < N; j++) H_[i][j][l] = 0.0;
+                    for (int j = 0; j < M; j++) R_[i][j][l] = (i == j) ? 1.0 : 0.0;
+                }
+                continue;
+            }
+            count++;
+            VectorN x = state(l), x_next;
+            VectorM z, z_pred;
+            MatrixN F, Q;
+            MatrixMN H;
+            MatrixM R;
+            for (int i = 0; i < M; i++) z(i) = z_[i][l];
+            model_.predict(x, dt_[l], x_next, F);
+            model_.normalize(x_next);
+            model_.processNoise(dt_[l], Q);
+            model_.measure(x_next, z_pred, H);
+            model_.measureNoise(z, R);
+            VectorM y = model_.residual(z, z_pred);
+            for (int i = 0; i < N; i++) {
+                xp_[i][l] = x_next(i);
+                for (int j = 0; j < N; j++) {
+                    F_[i][j][l] = F(i, j);
+                    Q_[i][j][l] = Q(i, j);
+                }
+            }
+            for (int i = 0; i < M; i++) {
+                y_[i][l] = y(i);
+                for (int j = 0; j < N; j++) H_[i][j][l] = H(i, j);
+                for (int j = 0; j < M; j++) R_[i][j][l] = R(i, j);
+            }
+        }
+
+        // Pp = F P F^T + Q
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                bank_kernel::fill(T_[i][j], 0.0, n);
+                for (int k = 0; k < N; k++) bank_kernel::fma(T_[i][j], F_[i][k], P_[k][j], n);
+            }
+        }
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                std::copy(Q_[i][j], Q_[i][j] + n, Pp_[i][j]);
+                for (int k = 0; k < N; k++) bank_kernel::fma(Pp_[i][j], T_[i][k], F_[j][k], n);
+            }
+        }
+
+        // U = H Pp, S = U H^T + R
+        for (int i = 0; i < M; i++) {
+            for (int j = 0; j < N; j++) {
+                bank_kernel::fill(U_[i][j], 0.0, n);
+                for (int k = 0; k < N; k++) bank_kernel::fma(U_[i][j], H_[i][k], Pp_[k][j], n);
+            }
+        }
+        for (int i = 0; i < M; i++) {
+            for (int j = 0; j < M; j++) {
+                std::copy(R_[i][j], R_[i][j] + n, S_[i][j]);
+                for (int k = 0; k < N; k++) bank_kernel::fma(S_[i][j], U_[i][k], H_[j][k], n);
+            }
+        }
+
+        // S 对称正定，不选主元的 Gauss-Jordan 求逆
+        for (int i = 0; i < M; i++) {
+            for (int j = 0; j < M; j++) bank_kernel::fill(Sinv_[i][j], (i == j) ? 1.0 : 0.0, n);
+        }
+        double pivot[L], factor[L];
+        for (int p = 0; p < M; p++) {
+            bank_kernel::reciprocal(pivot, S_[p][p], n);
+            for (int j = 0; j < M; j++) {
+                bank_kernel::mul(S_[p][j], S_[p][j], pivot, n);
+                bank_kernel::mul(Sinv_[p][j], Sinv_[p][j], pivot, n);
+            }
+            for (int r = 0; r < M; r++) {
+                if (r == p) continue;
+                std::copy(S_[r][p], S_[r][p] + n, factor);
+                for (int j = 0; j < M; j++) {
+                    bank_kernel::fnma(S_[r][j], factor, S_[p][j], n);
+                    bank_kernel::fnma(Sinv_[r][j], factor, Sinv_[p][j], n);
+                }
+            }
+        }
+
+        // K = U^T S^-1，x = xp + K y，P = Pp - K U
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < M; j++) {
+                bank_kernel::fill(K_[i][j], 0.0, n);
+                for (int k = 0; k < M; k++) bank_kernel::fma(K_[i][j], U_[k][i], Sinv_[k][j], n);
+            }
+        }
+        for (int i = 0; i < N; i++) {
+            for (int k = 0; k < M; k++) bank_kernel::fma(xp_[i], K_[i][k], y_[k], n);
+        }
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                for (int k = 0; k < M; k++) bank_kernel::fnma(Pp_[i][j], K_[i][k], U_[k][j], n);
+            }
+        }
+
+        // 写回已登记的通道
+        for (int l = 0; l < n; l++) {
+            if (!staged_[l]) continue;
+            VectorN x;
+            for (int i = 0; i < N; i++) x(i) = xp_[i][l];
+            model_.normalize(x);
+            for (int i = 0; i < N; i++) {
+                x_[i][l] = x(i);
+                for (int j = 0; j < N; j++) P_[i][j][l] = 0.5 * (Pp_[i][j][l] + Pp_[j][i][l]);
+            }
+            staged_[l] = false;
+        }
+        lanes_ = 0;
+        return count;
+    }
+
+private:
+    Model model_;
+    bool  initialized_[L], staged_[L];
+    int   lanes_ = 0;
+
+    alignas(64) double x_[N][L];
+    alignas(64) double P_[N][N][L];
+    alignas(64) double z_[M][L];
+    alignas(64) double dt_[L];
+
+    // flush 的中间量
+    alignas(64) double xp_[N][L], y_[M][L];
+    alignas(64) double F_[N][N][L], Q_[N][N][L], T_[N][N][L], Pp_[N][N][L];
+    alignas(64) double H_[M][N][L], R_[M][M][L], U_[M][N][L], S_[M][M][L], Sinv_[M][M][L];
+    alignas(64) double K_[N][M][L];
+};
+
+#endif
@@ -3,7 +3,9 @@
 
 #include "data_manager/base.h"
 #include "data_manager/param.h"
+#include "data_manager/config.h"
 #include "garage/interface.h"
+#include <mutex>
 
 class Garage {
 public:
@@ -14,14 +16,38 @@ public:
     
     ObjPtr getObj(rm::ArmorID id);
 
+    // 由跟踪线程在帧开始时调用，配置快照更新后重建参数有变化的目标模型
+    void applyConfig();
+
+    // 活跃集: 目标被观测时置位，超过 horizon 未再观测则移出，仅活跃目标每帧 update
+    // 以下两个函数只由跟踪线程调用，t 取帧时间戳
+    void markActive(rm::ArmorID id, TimePoint t);
+    int updateActive(TimePoint t);
+
 private:
     Garage();
     Garage(const Garage&) = delete;
     Garage& operator=(const Garage&) = delete;
 
 public:
+    // 元素以 std::atomic_load / atomic_store 读写，热更新替换时其他线程仍持有旧对象
     std::vector<ObjPtr> obj_;
-    
+
+private:
+    std::mutex config_mutex_;
+    ConfigPtr config_;
+
+    bool     active_enabled_ = true;
+    double   active_horizon_ = 1.0;
+    uint32_t active_mask_ = 0;
+    std::vector<TimePoint> active_last_;
+
 };
 
+// 可见目标数从 1 到全部时，全量 update 与活跃集 update 的单帧耗时
+void benchmarkGarageUpdate(int iterations);
+
+// 跟踪与查询两个线程满速并发 seconds 秒，检查加锁模型读到的状态是否完整，统计查询与发送端等锁的最长耗时
+void stressGuardedModel(double seconds);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef RM2024_GARAGE_GUARDED_MODEL_H_
+#define RM2024_GARAGE_GUARDED_MODEL_H_
+
+#include <mutex>
+#include <utility>
+#include "data_manager/base.h"
+
+// 目标模型的互斥保护: 跟踪线程写入，发送线程与界面线程查询，同一时刻只有一方访问
+//
+// OpenRM 的查询接口并非只读: AntitopV3 / OutpostV1 的 getFireArmor / getFireCenter 维护开火计数与延时，
+// TrackQueue 的 getFireFlag、RuneV2 的 setRuneType / getFireFlag 维护计时器。这些状态必须只有一份，
+// 因此模型不做多副本，查询与更新在同一把锁下串行，单次持锁为微秒级
+//
+// Model 须提供:
+//   void push(const rm::Target& target, TimePoint t);
+//   void update();
+template<class Model>
+class GuardedModel {
+public:
+    template<class... Args>
+    explicit GuardedModel(const Args&... args) : model_(args...) {}
+
+    // 以下两个函数只由跟踪线程调用
+    void push(const rm::Target& target, TimePoint t) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        model_.push(target, t);
+    }
+
+    void update() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        model_.update();
+    }
+
+    // 持锁在模型上执行 f 并返回其结果，f 内可调用带开火状态的查询接口
+    template<class F>
+    auto read(F&& f) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return f(model_);
+    }
+
+private:
+    std::mutex mutex_;
+    Model      model_;
+};
+
+#endif
@@ -24,6 +24,7 @@ public:
 
 public:
     TimePoint last_t_;
+    double last_yaw_ = 0.0;             // 最近一次观测的装甲板世界系偏航，供 PnP 热启动
     rm::ArmorSize size_ = rm::ARMOR_SIZE_UNKNOWN;
     rm::ArmorID id_ = rm::ARMOR_ID_UNKNOWN;
 };
@@ -0,0 +1,153 @@
+#ifndef RM2024_GARAGE_KALMAN_H_
+#define RM2024_GARAGE_KALMAN_H_
+
+#include <Eigen/Dense>
+
+// 定长卡尔曼滤波，状态与观测维数在编译期确定，predict / update 全部使用栈上的定长矩阵
+//
+// 模型以策略类型给出，线性模型 (KalmanFilter) 提供:
+//   void transition(double dt, MatrixN& F) const;                               状态转移矩阵
+//   void measurement(MatrixMN& H) const;                                        观测矩阵
+// 非线性模型 (EKF) 提供:
+//   void predict(const VectorN& x, double dt, VectorN& x_next, MatrixN& F) const;   状态转移及其雅可比
+//   void measure(const VectorN& x, VectorM& z, MatrixMN& H) const;                  观测函数及其雅可比
+// 两者共同提供:
+//   void processNoise(double dt, MatrixN& Q) const;
+//   void measureNoise(const VectorM& z, MatrixM& R) const;
+//   VectorM residual(const VectorM& z, const VectorM& z_pred) const;            角度分量在此归一化
+//   void normalize(VectorN& x) const;
+template<int N, int M>
+struct KalmanTypes {
+    using VectorN  = Eigen::Matrix<double, N, 1>;
+    using VectorM  = Eigen::Matrix<double, M, 1>;
+    using MatrixN  = Eigen::Matrix<double, N, N>;
+    using MatrixM  = Eigen::Matrix<double, M, M>;
+    using MatrixMN = Eigen::Matrix<double, M, N>;
+    using MatrixNM = Eigen::Matrix<double, N, M>;
+};
+
+template<int N, int M, class Model>
+class KalmanBase : public KalmanTypes<N, M> {
+public:
+    using typename KalmanTypes<N, M>::VectorN;
+    using typename KalmanTypes<N, M>::VectorM;
+    using typename KalmanTypes<N, M>::MatrixN;
+    using typename KalmanTypes<N, M>::MatrixM;
+    using typename KalmanTypes<N, M>::MatrixMN;
+    using typename KalmanTypes<N, M>::MatrixNM;
+
+    explicit KalmanBase(const Model& model) : model_(model) {}
+
+    void init(const VectorN& x, const MatrixN& P) {
+        x_ = x;
+        P_ = P;
+        initialized_ = true;
+    }
+    void reset() { initialized_ = false; }
+
+    bool initialized() const { return initialized_; }
+    const VectorN& state() const { return x_; }
+    const MatrixN& covariance() const { return P_; }
+    const Model& model() const { return model_; }
+    Model& model() { return model_; }
+
+    // 状态的直接修改 (如装甲板切换时的相位平移) 后由调用方保证协方差仍然合理
+    VectorN& mutableState() { return x_; }
+
+protected:
+    // Joseph 形式的观测更新，S 较小时 LDLT 直接展开为定长运算
+    void correct(const VectorM& z, const VectorM& z_pred, const MatrixMN& H) {
+        MatrixM R;
+        model_.measureNoise(z, R);
+        MatrixM S = H * P_ * H.transpose() + R;
+        MatrixNM K = S.ldlt().solve(H * P_).transpose();
+
+        x_ += K * model_.residual(z, z_pred);
+        MatrixN I_KH = MatrixN::Identity() - K * H;
+        P_ = I_KH * P_ * I_KH.transpose() + K * R * K.transpose();
+        model_.normalize(x_);
+    }
+
+    void propagate(const VectorN& x_next, const MatrixN& F, double dt) {
+        MatrixN Q;
+        model_.processNoise(dt, Q);
+        x_ = x_next;
+        P_ = F * P_ * F.transpose() + Q;
+        model_.normalize(x_);
+    }
+
+protected:
+    Model   model_;
+    VectorN x_ = VectorN::Zero();
+    MatrixN P_ = MatrixN::Identity();
+    bool    initialized_ = false;
+};
+
+template<int N, int M, class Model>
+class KalmanFilter : public KalmanBase<N, M, Model> {
+public:
+    using Base = KalmanBase<N, M, Model>;
+    using typename Base::VectorN;
+    using typename Base::VectorM;
+    using typename Base::MatrixN;
+    using typename Base::MatrixMN;
+
+    explicit KalmanFilter(const Model& model = Model()) : Base(model) {}
+
+    void predict(double dt) {
+        MatrixN F;
+        this->model_.transition(dt, F);
+        this->propagate(F * this->x_, F, dt);
+    }
+
+    void update(const VectorM& z) {
+        MatrixMN H;
+        this->model_.measurement(H);
+        this->correct(z, H * this->x_, H);
+    }
+
+    // dt 秒后的状态外推，不改变滤波器
+    VectorN extrapolate(double dt) const {
+        MatrixN F;
+        this->model_.transition(dt, F);
+        VectorN x = F * this->x_;
+        this->model_.normalize(x);
+        return x;
+    }
+};
+
+template<int N, int M, class Model>
+class EKF : public KalmanBase<N, M, Model> {
+public:
+    using Base = KalmanBase<N, M, Model>;
+    using typename Base::VectorN;
+    using typename Base::VectorM;
+    using typename Base::MatrixN;
+    using typename Base::MatrixMN;
+
+    explicit EKF(const Model& model = Model()) : Base(model) {}
+
+    void predict(double dt) {
+        VectorN x_next;
+        MatrixN F;
+        this->model_.predict(this->x_, dt, x_next, F);
+        this->propagate(x_next, F, dt);
+    }
+
+    void update(const VectorM& z) {
+        VectorM z_pred;
+        MatrixMN H;
+        this->model_.measure(this->x_, z_pred, H);
+        this->correct(z, z_pred, H);
+    }
+
+    VectorN extrapolate(double dt) const {
+        VectorN x_next;
+        MatrixN F;
+        this->model_.predict(this->x_, dt, x_next, F);
+        this->model_.normalize(x_next);
+        return x_next;
+    }
+};
+
+#endif
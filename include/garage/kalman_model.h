@@ -0,0 +1,125 @@
+#ifndef RM2024_GARAGE_KALMAN_MODEL_H_
+#define RM2024_GARAGE_KALMAN_MODEL_H_
+
+#include "data_manager/base.h"
+#include "data_manager/config.h"
+#include "garage/kalman.h"
+#include "garage/filter_bank.h"
+
+// 整车平动模型，状态与 Kalman.TrackQueue.CarDef 一致: [x y z v vz angle w a]
+// 水平面内按恒定转向率、恒定加速度外推，观测为装甲板位置 [x y z]
+struct TrackModel {
+    using Types = KalmanTypes<8, 3>;
+
+    config::Vec8 q{};
+    config::Vec3 r{};
+
+    void predict(const Types::VectorN& x, double dt, Types::VectorN& x_next, Types::MatrixN& F) const;
+    void measure(const Types::VectorN& x, Types::VectorM& z, Types::MatrixMN& H) const;
+    void processNoise(double dt, Types::MatrixN& Q) const;
+    void measureNoise(const Types::VectorM& z, Types::MatrixM& R) const;
+    Types::VectorM residual(const Types::VectorM& z, const Types::VectorM& z_pred) const { return z - z_pred; }
+    void normalize(Types::VectorN& x) const;
+};
+
+// 小陀螺模型，状态与 Kalman.Antitop.Qdef 一致: [x y z theta vx vy vz omega r]，(x, y, z) 为旋转中心
+// 观测为装甲板 [x y z yaw]，装甲板位于中心沿 -(cos theta, sin theta) 方向 r 处
+struct AntitopModel {
+    using Types = KalmanTypes<9, 4>;
+
+    config::Vec9 q{};
+    config::Vec4 r{};
+    double min_r = 0.15, max_r = 0.4;
+
+    void predict(const Types::VectorN& x, double dt, Types::VectorN& x_next, Types::MatrixN& F) const;
+    void measure(const Types::VectorN& x, Types::VectorM& z, Types::MatrixMN& H) const;
+    void processNoise(double dt, Types::MatrixN& Q) const;
+    void measureNoise(const Types::VectorM& z, Types::MatrixM& R) const;
+    Types::VectorM residual(const Types::VectorM& z, const Types::VectorM& z_pred) const;
+    void normalize(Types::VectorN& x) const;
+};
+
+// 单目标平动跟踪，间隔超过 max_delay 秒未观测时重新初始化
+class TrackFilter {
+public:
+    TrackFilter(const config::Vec8& q, const config::Vec3& r, double max_delay);
+
+    void push(const Eigen::Vector4d& pose, TimePoint t);
+    bool getPose(Eigen::Vector4d& pose, double delay) const;
+
+private:
+    EKF<8, 3, TrackModel> ekf_;
+    double    max_delay_;
+    TimePoint last_t_;
+    double    last_yaw_ = 0.0;
+};
+
+// 小陀螺跟踪，装甲板切换时把相位平移 2π / armor_num 后继续同一条轨迹
+class AntitopFilter {
+public:
+    AntitopFilter(const config::Vec9& q, const config::Vec4& r, double min_r, double max_r, int armor_num, double max_delay);
+
+    void push(const Eigen::Vector4d& pose, TimePoint t);
+    bool initialized() const { return ekf_.initialized(); }
+    double getOmega() const { return ekf_.state()(7); }
+    Eigen::Vector4d getCenter(double delay) const;
+    Eigen::Vector4d getPose(double delay) const;
+
+private:
+    EKF<9, 4, AntitopModel> ekf_;
+    int       armor_num_;
+    double    max_delay_;
+    TimePoint last_t_;
+};
+
+// TrackFilter 的批量版本，每个槽位对应一辆车，push 只登记观测，flush 后状态才更新
+class TrackBank {
+public:
+    static constexpr int kCapacity = 16;
+
+    TrackBank(const config::Vec8& q, const config::Vec3& r, double max_delay);
+
+    void push(int slot, const Eigen::Vector4d& pose, TimePoint t);
+    int flush() { return bank_.flush(); }
+    bool getPose(int slot, Eigen::Vector4d& pose, double delay) const;
+
+private:
+    FilterBank<8, 3, TrackModel, kCapacity> bank_;
+    double    max_delay_;
+    TimePoint last_t_[kCapacity];
+    double    last_yaw_[kCapacity] = {};
+};
+
+// AntitopFilter 的批量版本，装甲板数随观测给出，同一槽位须始终使用相同的装甲板数
+class AntitopBank {
+public:
+    static constexpr int kCapacity = 16;
+
+    AntitopBank(const config::Vec9& q, const config::Vec4& r, double min_r, double max_r, double max_delay);
+
+    void push(int slot, const Eigen::Vector4d& pose, TimePoint t, int armor_num);
+    int flush() { return bank_.flush(); }
+    bool initialized(int slot) const { return bank_.initialized(slot); }
+    double getOmega(int slot) const { return bank_.state(slot)(7); }
+    Eigen::Vector4d getCenter(int slot, double delay) const;
+
+private:
+    FilterBank<9, 4, AntitopModel, kCapacity> bank_;
+    double    max_delay_;
+    TimePoint last_t_[kCapacity];
+};
+
+// 一次观测，t 为相对录制起点的秒数
+struct KalmanPush {
+    Eigen::Vector4d pose;
+    double t;
+};
+
+// 把 Kalman.PushLog 中录制的观测 (不存在时为合成的小陀螺序列) 同时回放给树内滤波与 OpenRM TrackQueueV4 / AntitopV3，
+// 比较单次更新耗时以及两者的跟踪位置、角速度与旋转中心之差
+void benchmarkKalman(int iterations);
+
+// 同时跟踪 1 到 16 个目标时，逐目标 AntitopFilter/TrackFilter 与 AntitopBank/TrackBank 批量更新的单目标耗时及两者的状态差
+void benchmarkFilterBank(int iterations);
+
+#endif
@@ -2,12 +2,40 @@
 #define RM2024_GARAGE_WRAPPER_CAR_H_
 
 #include "garage/interface.h"
+#include "garage/guarded_model.h"
+#include "data_manager/config.h"
+#include <memory>
+
+// 车辆的 OpenRM 滤波状态，由 WrapperCar 加锁持有
+class CarModel {
+public:
+    CarModel(rm::ArmorID id, const ConfigPtr& config);
+    ~CarModel() { delete antitop_2_; delete antitop_4_; }
+    CarModel(const CarModel&) = delete;
+    CarModel& operator=(const CarModel&) = delete;
+
+    void push(const rm::Target& target, TimePoint t);
+    void update();
+
+    // 步兵出现大装甲板时按两装甲板 (平衡) 模型跟踪，其余情况为四装甲板
+    bool balance() const;
+    rm::AntitopV3* antitop() { return balance() ? antitop_2_ : antitop_4_; }
+
+public:
+    rm::ArmorID id_;
+    rm::TrackQueueV4 track_queue_;
+    rm::AntitopV3* antitop_2_;
+    rm::AntitopV3* antitop_4_;
+
+    int    armor_size_count_ = 0;           // 装甲板尺寸计数
+    int    curr_armor_num_ = 0;             // 当前一次更新内观测的装甲板数量
+};
 
 class WrapperCar : public ObjInterface {
 
 public:
     WrapperCar(rm::ArmorID id);
-    ~WrapperCar() {};
+    ~WrapperCar() {}
     void push(const rm::Target& target, TimePoint t) override;
     void update() override;
     bool getTarget(Eigen::Vector4d& pose, const double fly_delay, const double rotate_delay, const double shoot_delay) override;
@@ -16,16 +44,14 @@ public:
     void setState(int state) override {}
 
 public:
-    rm::TrackQueueV4 track_queue_;
-    rm::AntitopV3* antitop_2_;
-    rm::AntitopV3* antitop_4_;
+    // push / update 由跟踪线程写入，getTarget 等查询与其在同一把锁下串行
+    GuardedModel<CarModel> model_;
 
     bool   flag_big_armor_ = false;         // 是否为大装甲板
-    int    armor_size_count_ = 0;           // 装甲板尺寸计数
-    int    curr_armor_num_ = 0;             // 当前一次更新内观测的装甲板数量
 
-    bool flag_antitop_ = false;
-    bool flag_center_ = false;
+    // 模式滞回只在 model_ 的锁内读写
+    bool   flag_antitop_ = false;
+    bool   flag_center_ = false;
 
     double antitop_to_track_ = 0.6;
     double track_to_antitop_ = 1.0;
@@ -33,4 +59,4 @@ public:
     double center_to_armor_ = 0.6;
 };
 
-#endif
\ No newline at end of file
+#endif
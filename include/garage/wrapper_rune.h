@@ -2,6 +2,20 @@
 #define RM2024_GARAGE_WRAPPER_OUTPOSTS_H_
 
 #include "garage/interface.h"
+#include "garage/guarded_model.h"
+#include "data_manager/config.h"
+
+// 能量机关的 OpenRM 滤波状态，由 WrapperRune 加锁持有
+class RuneModel {
+public:
+    RuneModel(const ConfigPtr& config);
+
+    void push(const rm::Target& target, TimePoint t);
+    void update() {}
+
+public:
+    rm::RuneV2 rune_;
+};
 
 class WrapperRune : public ObjInterface {
 public:
@@ -16,7 +30,8 @@ public:
     void setState(int state) override {};
 
 public:
-    rm::RuneV2 rune_;
+    // 符的跟踪线程 push 与 getTarget 在同一把锁下串行
+    GuardedModel<RuneModel> model_;
 
 };
 
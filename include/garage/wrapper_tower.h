@@ -2,6 +2,28 @@
 #define RM2024_GARAGE_WRAPPER_TOWER_H_
 
 #include "garage/interface.h"
+#include "garage/guarded_model.h"
+#include "data_manager/config.h"
+
+// 前哨站的 OpenRM 滤波状态，由 WrapperTower 加锁持有
+class TowerModel {
+public:
+    TowerModel(const ConfigPtr& config);
+
+    void push(const rm::Target& target, TimePoint t);
+    void update();
+
+public:
+    rm::TrackQueueV3 track_queue_;
+
+    #if defined(TJURM_INFANTRY) || defined(TJURM_BALANCE) || defined(TJURM_HERO) || defined(TJURM_SENTRY)
+    rm::OutpostV1 outpost_;
+    #endif
+
+    #if defined(TJURM_DRONSE)
+    rm::OutpostV2 outpost_;
+    #endif
+};
 
 class WrapperTower : public ObjInterface {
     
@@ -16,15 +38,8 @@ public:
     void setState(int state) override {};
     
 public:
-    rm::TrackQueueV3 track_queue_;
-
-    #if defined(TJURM_INFANTRY) || defined(TJURM_BALANCE) || defined(TJURM_HERO) || defined(TJURM_SENTRY)
-    rm::OutpostV1 outpost_;
-    #endif
-
-    #if defined(TJURM_DRONSE)
-    rm::OutpostV2 outpost_;
-    #endif
+    // push / update 由跟踪线程写入，getTarget 等查询与其在同一把锁下串行
+    GuardedModel<TowerModel> model_;
 
 };
 
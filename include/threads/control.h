@@ -107,7 +107,7 @@ public:
     StateBytes              state_bytes_;             // 电控 -> 自瞄
     OperateBytes            operate_bytes_;           // 自瞄 -> 电控
 
-    int                     file_descriptor_;
+    int                     file_descriptor_ = -1;     // 无效 (重新扫描串口期间) 时为 -1
     std::string             port_name_;
     std::mutex              serial_mutex_;            // 保护串口操作的互斥锁
 
@@ -0,0 +1,52 @@
+#ifndef RM2024_THREADS_CONTROL_BALLISTIC_H_
+#define RM2024_THREADS_CONTROL_BALLISTIC_H_
+
+#include <string>
+#include <vector>
+#include "data_manager/base.h"
+
+// 弹道参数，阻力按二次型 a = -k |v| v，k = 0.5 * 空气密度 * 阻力系数 * 截面积 / 质量
+struct BallisticParam {
+    double gravity = 9.8;
+    double drag = 0.0;                      // k，单位 1/m
+    double distance[3] = {0.5, 20.0, 0.25}; // 水平距离 [最小, 最大, 步长]，m
+    double height[3] = {-2.0, 3.0, 0.1};    // 目标相对枪口高度，m
+    double speed[3] = {10.0, 30.0, 0.5};    // 初速，m/s
+};
+
+// (水平距离, 高度, 初速) 到 (仰角, 飞行时间) 的预计算表
+// 同一初速切片内按 (距离, 高度) 双线性插值，相邻两个初速切片之间再线性插值
+class BallisticTable {
+public:
+    bool build(const BallisticParam& param);
+    bool load(const std::string& path, const BallisticParam& param);
+    bool save(const std::string& path) const;
+
+    bool empty() const { return pitch_.empty(); }
+
+    // 仰角 (弧度，向上为正) 与飞行时间 (s)，超出表范围或目标不可达时返回 false
+    bool lookup(double distance, double height, double speed, double& pitch, double& fly_time) const;
+
+    // 在随机点上与直接积分求解比较，误差为仰角 (度) 与飞行时间 (ms)
+    void evaluate(int samples, double& pitch_mean, double& pitch_max, double& time_mean, double& time_max) const;
+
+private:
+    BallisticParam param_;
+    int cols_ = 0, rows_ = 0, slices_ = 0;     // 距离、高度、初速方向的节点数
+    std::vector<float> pitch_, time_;          // [slice][row][col]，不可达为 NaN
+};
+
+// 直接积分求解: 对仰角二分使弹道在给定水平距离处经过目标高度 (取低弹道)
+bool solveBallistic(const BallisticParam& param, double distance, double height, double speed,
+                    double& pitch, double& fly_time);
+
+// 按 Car.Ballistic 读缓存或建表，并与 rm::getFlyDelay 核对输出的角度约定，失败时发送线程回退到 rm::getFlyDelay
+void initBallisticTable();
+
+// 与 rm::getFlyDelay 相同的接口，表可用且目标在表内时查表，否则调用 rm::getFlyDelay
+double getBallisticFlyDelay(double& yaw, double& pitch, double speed, double x, double y, double z);
+
+// 打印查表与 rm::getFlyDelay、直接积分的平均耗时及查表误差
+void benchmarkBallisticTable(int iterations);
+
+#endif
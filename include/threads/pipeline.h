@@ -2,11 +2,15 @@
 #define RM2024_THREADS_PIPELINE_H_
 
 #include <mutex>
+#include <string>
+#include <atomic>
 #include <memory>
 #include <condition_variable>
 
 #include "data_manager/base.h"
 #include "data_manager/param.h"
+#include "threads/pipeline/tiny_resnet.h"
+#include "threads/pipeline/roi_cache.h"
 
 #include "garage/garage.h"
 #include "garage/wrapper_car.h"
@@ -23,18 +27,22 @@ public:
     void autoaim_baseline();
     void autoaim_rune();
     void autoaim_combine();
+    bool autoaim_offline(const std::string& video_path);
 
     void init_pointer();
     void init_locater();
     void init_updater();
     void init_fourpoints();
     void init_classifier();
+    void init_tiler();
+    bool init_armor_model();
 
     bool pointer(std::shared_ptr<rm::Frame> frame);
     bool locater(std::shared_ptr<rm::Frame> frame);
     bool updater(std::shared_ptr<rm::Frame> frame);
     bool rector(std::shared_ptr<rm::Frame> frame);
     bool classifier(std::shared_ptr<rm::Frame> frame);
+    bool tiler(std::shared_ptr<rm::Frame> frame);
     bool fourpoints(std::shared_ptr<rm::Frame> frame);
     bool UI(std::shared_ptr<rm::Frame> frame);
     bool monitor(std::shared_ptr<rm::Frame> frame);
@@ -79,6 +87,8 @@ public:
     void imshow(std::shared_ptr<rm::Frame> frame_show);
     void imshow(std::shared_ptr<rm::Frame> frame_show, std::string& frame_msg);
 
+    bool first_frame_ready() const { return first_frame_ready_; }
+
 
 
 private:
@@ -139,6 +149,46 @@ private:
     int classifier_infer_width_ = 32;
     int classifier_infer_height_ = 32;
     int classifier_class_num_ = 10;
+    TinyResNet classifier_native_;
+    std::vector<float> classifier_native_output_;
+    bool classifier_native_enabled_ = false;
+    bool classifier_initialized_ = false;
+    int classifier_padding_ = 5;
+
+    // 每帧每个检测框的 ROI 缓存，pointer 创建，classifier 与显示复用，一帧处理结束后释放
+    RoiCache roi_cache_;
+
+    // Tiler (原生分辨率切片推理) related members
+    cudaStream_t tile_stream_;
+    nvinfer1::IExecutionContext* tile_context_ = nullptr;
+    uint8_t* tile_host_buffer_ = nullptr;
+    uint8_t* tile_device_buffer_ = nullptr;
+    float* tile_input_device_buffer_ = nullptr;
+    float* tile_output_device_buffer_ = nullptr;
+    float* tile_output_host_buffer_ = nullptr;
+    bool tile_enabled_ = false;
+    bool tile_dnn_ = false;             // CPU 后端与离线模式下切片经 cv::dnn 推理
+    cv::dnn::Net tile_net_;
+    cv::Mat tile_blob_;
+
+    // 装甲板模型与推理缓冲区是否已加载 (启动编排中预先加载，或由预处理线程加载)
+    bool armor_model_ready_ = false;
+    std::atomic<bool> first_frame_ready_{false};
+
+    // 隔帧检测: 关键帧标志随帧寄存器一起传递 (由同一把锁保护)，检测线程跟踪失败时请求下一帧检测
+    bool keyframe_register_ = true;
+    std::atomic<bool> force_detect_{true};
+
+    // 距离级联: 远距离模型的执行上下文与缓冲区，本帧使用的模型随帧寄存器传递
+    nvinfer1::IExecutionContext* armor_far_context_ = nullptr;
+    float* armor_far_input_device_buffer_ = nullptr;
+    float* armor_far_output_device_buffer_ = nullptr;
+    float* armor_far_output_host_buffer_ = nullptr;
+    bool far_model_register_ = false;
+    std::atomic<bool> cascade_far_{false};
+
+    // 离线批处理时各帧并行进入 pointer，不使用上一帧的灯条时序窗口
+    bool offline_mode_ = false;
 
 private:
     Pipeline() = default;
@@ -0,0 +1,44 @@
+#ifndef RM2024_THREADS_PIPELINE_LIGHTBAR_H_
+#define RM2024_THREADS_PIPELINE_LIGHTBAR_H_
+
+#include <vector>
+#include "data_manager/base.h"
+
+// 全图传统灯条检测的配置，对应 Model.YoloArmor.Classical 与 Points.Lightbar / Points.Armor
+struct LightbarDetectConfig {
+    double scale;               // 全图缩放比例
+    int    threshold;           // 通道相减后的二值化阈值
+    double box_height_ratio;    // 输出检测框高度 / 灯条平均长度
+    int    class_id;            // 输出检测框的类别，由分类器或 pointer 进一步确定
+    std::vector<int> color_map; // 当前网络类型的 ColorMap，用于换算 color_id
+
+    double lb_min_rect_side;
+    double lb_max_rect_side;
+    double lb_min_area;
+    double lb_min_ratio_area;
+    double lb_max_angle;
+
+    double armor_max_ratio_length;
+    double armor_min_ratio_side;
+    double armor_max_ratio_side;
+    double armor_max_angle_diff;
+    double armor_max_offset;
+};
+
+LightbarDetectConfig getLightbarDetectConfig();
+
+// 在缩放后的整幅图像上做敌方颜色通道相减、二值化与灯条配对
+// 每个灯条对输出一个与 YOLO 输出格式一致的候选框，四点为两灯条端点
+void lightbarDetect(
+    const cv::Mat& image,
+    std::vector<rm::YoloRect>& yolo_list,
+    rm::ArmorColor enemy_color,
+    const LightbarDetectConfig& config);
+
+// reference 中与 candidates 的 IoU 超过阈值的比例，reference 为空时返回 -1
+double getYoloRecall(
+    const std::vector<rm::YoloRect>& candidates,
+    const std::vector<rm::YoloRect>& reference,
+    double iou_thresh);
+
+#endif
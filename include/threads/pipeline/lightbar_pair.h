@@ -0,0 +1,41 @@
+#ifndef RM2024_THREADS_PIPELINE_LIGHTBAR_PAIR_H_
+#define RM2024_THREADS_PIPELINE_LIGHTBAR_PAIR_H_
+
+#include <vector>
+#include "data_manager/base.h"
+
+// 按中心 x 排序后扫描，仅保留存在几何上可配对邻居的灯条，输出保持原顺序
+// 只使用 rm::getBestMatchedLightbarPair 门限的必要条件 (长度比、中心距 / 灯条长度)，
+// 被剔除的灯条不可能出现在任何合法灯条对中，最优配对结果不变
+void sweepLightbarCandidates(
+    const std::vector<rm::Lightbar>& lightbar_list,
+    std::vector<rm::Lightbar>& candidate_list,
+    double max_ratio_length,
+    double max_ratio_side);
+
+// 灯条两端点的灰度重心，对应 rm::findPointPairBarycenter(lightbar, gray, line_dist, radius_ratio)
+// 以名义端点为圆心、length * radius_ratio 为半径，逐行求圆与灯条轴线 line_dist 邻域的交集区间，
+// 区间内灰度加权累加使用 SIMD 完成
+std::pair<cv::Point2f, cv::Point2f> findLightbarEndpoints(
+    const rm::Lightbar& lightbar,
+    const cv::Mat& gray,
+    double line_dist,
+    double radius_ratio);
+
+// 在合成灯条上与 rm::findPointPairBarycenter 比较端点，最大偏差不超过 tolerance 像素时返回 true
+bool checkLightbarEndpointParity(int samples, double line_dist, double radius_ratio, double tolerance);
+
+// 打印不同灯条数量下扫描剪枝前后的配对耗时，以及端点重心两种实现的耗时
+void benchmarkLightbarPair(
+    double max_ratio_length,
+    double max_ratio_area,
+    double min_ratio_side,
+    double max_ratio_side,
+    double max_angle_diff,
+    double max_angle_avg,
+    double max_offset,
+    double line_dist,
+    double radius_ratio,
+    int iterations);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef RM2024_THREADS_PIPELINE_MOTION_H_
+#define RM2024_THREADS_PIPELINE_MOTION_H_
+
+#include <vector>
+#include "data_manager/base.h"
+
+// 由两帧间云台角度 (度) 的变化估计静止目标在图像上的平移
+// 与 check_armor_detection 的约定一致: 目标角度 = 云台角度 + atan(像素偏移 / 焦距)
+cv::Point2f getGimbalShift(const rm::Camera* camera, float yaw0, float pitch0, float yaw1, float pitch1);
+
+// 在运动补偿后的 ROI 内用金字塔 LK 光流传播上一帧检测框的四点
+// 正反向光流误差超过 max_error 像素的检测框被丢弃，返回成功传播的检测框
+std::vector<rm::YoloRect> propagateYoloRects(
+    const cv::Mat& prev_image,
+    const cv::Mat& image,
+    const std::vector<rm::YoloRect>& prev_list,
+    const cv::Point2f& shift,
+    double max_error);
+
+// 传播结果与同帧检测结果按 IoU 匹配后的四点平均误差 (像素)，无匹配时返回 -1
+double getYoloCornerError(const std::vector<rm::YoloRect>& propagated, const std::vector<rm::YoloRect>& detected);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef RM2024_THREADS_PIPELINE_PLANAR_PNP_H_
+#define RM2024_THREADS_PIPELINE_PLANAR_PNP_H_
+
+#include <vector>
+#include "data_manager/base.h"
+
+// 相机内参与畸变系数 (k1, k2, p1, p2, k3) 的定长副本
+struct PnPCamera {
+    double fx = 1, fy = 1, cx = 0, cy = 0;
+    double k1 = 0, k2 = 0, p1 = 0, p2 = 0, k3 = 0;
+    bool   supported = false;       // 含更高阶畸变项时为 false，应回退到 cv::solvePnP
+};
+
+// 单块装甲板的输入: 四个模型点 (z = 0 的平面矩形) 与对应的像素点
+struct PlanarPnPInput {
+    const std::vector<cv::Point3f>* object;
+    const std::vector<cv::Point2f>* image;
+};
+
+// 相机坐标系下的位姿，与 cv::solvePnP 的 Rodrigues(rvec) / tvec 含义相同
+struct PlanarPose {
+    Eigen::Matrix3d rotation;
+    Eigen::Vector3d translation;
+    double error = 0;               // 归一化平面上的均方根重投影误差
+    bool   valid = false;
+};
+
+PnPCamera getPnPCamera(const rm::Camera* camera);
+
+// 四点平面 PnP 的闭式解 (IPPE): 去畸变后由四点单应求模型中心处的雅可比，
+// 得到两个候选旋转并各自最小二乘求平移，取重投影误差较小者；一帧内所有装甲板一次求解
+void solvePlanarPnP(const PnPCamera& camera, const std::vector<PlanarPnPInput>& inputs, std::vector<PlanarPose>& poses);
+
+// 两个位姿的旋转夹角 (度) 与平移距离
+void getPoseDiff(const PlanarPose& a, const PlanarPose& b, double& angle_diff, double& trans_diff);
+
+// 启动时的一致性检查: 在随机合成位姿上与 cv::solvePnP(SOLVEPNP_IPPE) 比较，
+// 输出最大旋转夹角 (度) 与平移距离，相机不支持或闭式解失败时返回 false
+bool checkPlanarPnP(const rm::Camera* camera, const std::vector<cv::Point3f>& object, double& max_angle, double& max_trans);
+
+// 在随机合成位姿上比较闭式解与 cv::solvePnP(SOLVEPNP_IPPE) + Rodrigues 的单块装甲板耗时与最大偏差
+void benchmarkPlanarPnP(const rm::Camera* camera, const std::vector<cv::Point3f>& object, int iterations);
+
+#endif
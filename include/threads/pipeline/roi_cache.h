@@ -0,0 +1,81 @@
+#ifndef RM2024_THREADS_PIPELINE_ROI_CACHE_H_
+#define RM2024_THREADS_PIPELINE_ROI_CACHE_H_
+
+#include <map>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include "data_manager/base.h"
+#include "threads/pipeline/roi_kernel.h"
+
+// pointer 在某个矩形上得到的灰度、二值平面与统计量
+struct RoiPlanes {
+    cv::Rect rect;
+    cv::Mat  gray, binary;
+    RoiStats stats;
+    int      threshold = 0;
+    bool     ready = false;
+
+    cv::Mat  gray_buffer, binary_buffer;
+};
+
+// 单个检测框的 ROI，由 pointer / classifier / 显示共用
+// BGR 为原图视图不复制，灰度 / 二值平面与分类器输入在首次使用时计算，之后直接复用
+class DetectionRoi {
+public:
+    void reset(const cv::Mat& image, const cv::Rect& box);
+
+    const cv::Rect& box() const { return box_; }
+    cv::Mat bgr(const cv::Rect& rect) const { return image_(rect); }
+
+    // 取 rect 对应的平面，未计算过时返回 ready = false 的槽位，由调用方填充后置 ready
+    RoiPlanes& planes(const cv::Rect& rect);
+    const RoiPlanes* lastPlanes() const;
+
+    // 检测框外扩 padding 后缩放到 size 的分类器输入，须在原图上绘制前取得
+    const cv::Mat& patch(const cv::Size& size, int padding);
+    bool hasPatch() const { return patch_ready_; }
+    const cv::Mat& cachedPatch() const { return patch_; }
+
+    // 本检测框各阶段读写的像素数
+    void touch(int pixels) { pixels_ += pixels; }
+    int pixels() const { return pixels_; }
+
+private:
+    cv::Mat  image_;
+    cv::Rect box_;
+    std::vector<RoiPlanes> planes_;
+    int      planes_count_ = 0;
+    int      last_planes_ = -1;
+    cv::Mat  patch_;
+    bool     patch_ready_ = false;
+    int      pixels_ = 0;
+};
+
+// 一帧内的检测框 ROI，下标与 frame->yolo_list 一致
+struct FrameRois {
+    std::vector<DetectionRoi> rois;
+    size_t count = 0;
+
+    DetectionRoi& operator[](size_t i) { return rois[i]; }
+    const DetectionRoi& operator[](size_t i) const { return rois[i]; }
+    size_t size() const { return count; }
+
+    // 每个检测框平均读写的像素数
+    double getPixelsPerRoi() const;
+};
+
+// 按帧登记 ROI，离线模式下多帧并行时各帧互不影响；释放后对象留在池中复用，平面缓冲区不再重新分配
+class RoiCache {
+public:
+    FrameRois& acquire(const rm::Frame& frame);
+    FrameRois* find(const rm::Frame& frame);
+    void release(const rm::Frame& frame);
+
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<FrameRois>> pool_;
+    std::map<const rm::Frame*, std::unique_ptr<FrameRois>> active_;
+};
+
+#endif
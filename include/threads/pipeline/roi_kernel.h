@@ -0,0 +1,32 @@
+#ifndef RM2024_THREADS_PIPELINE_ROI_KERNEL_H_
+#define RM2024_THREADS_PIPELINE_ROI_KERNEL_H_
+
+#include <vector>
+#include "data_manager/base.h"
+
+// 单次遍历 BGR ROI 得到的统计量
+struct RoiStats {
+    int hist[256];                  // 灰度直方图
+    std::vector<int> col_count;     // 每列亮像素 (灰度 >= color_floor) 个数
+    std::vector<int> col_red;       // 每列亮像素 R 通道之和
+    std::vector<int> col_blue;      // 每列亮像素 B 通道之和
+};
+
+// 一次读取 BGR ROI，输出与 cv::cvtColor(COLOR_BGR2GRAY) 逐位一致的灰度图，同时统计直方图与逐列颜色和
+void fuseRoiGray(const cv::Mat& roi, cv::Mat& gray, RoiStats& stats, int color_floor);
+
+// 由直方图计算二值化阈值，对应 rm::getThresholdFromHist(roi, bin, ratio)
+// 以 bin 为宽度分组，自高亮度向下累计像素数，达到总数的 ratio% 时返回该组下界
+int getThresholdFromRoiHist(const RoiStats& stats, int bin, double ratio);
+
+// 按灯条覆盖的列范围比较亮像素 R/B 之和确定颜色，无亮像素时返回 ARMOR_COLOR_NONE
+rm::ArmorColor getLightbarPairColor(const RoiStats& stats, const rm::LightbarPair& pair);
+
+// 在随机合成 ROI 上与 OpenRM 逐步实现 (getGrayScale / getThresholdFromHist) 比较灰度与阈值
+// 全部逐位一致时返回 true，否则应回退到逐步实现
+bool checkRoiKernelParity(int samples, rm::ArmorColor enemy_color, double ratio);
+
+// 打印不同 ROI 尺寸下融合实现与逐步实现 (含 HSV 颜色判断) 的平均耗时
+void benchmarkRoiKernel(rm::ArmorColor enemy_color, double ratio, int iterations);
+
+#endif
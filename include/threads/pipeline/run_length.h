@@ -0,0 +1,30 @@
+#ifndef RM2024_THREADS_PIPELINE_RUN_LENGTH_H_
+#define RM2024_THREADS_PIPELINE_RUN_LENGTH_H_
+
+#include <vector>
+#include "data_manager/base.h"
+
+// 游程连通域 (8 邻域) 的一次扫描统计量
+struct RunComponent {
+    int    area = 0;                // 像素数
+    int    top = 0, bottom = 0;     // 行范围
+    double cx = 0, cy = 0;          // 质心
+    double mu20 = 0, mu02 = 0, mu11 = 0;    // 归一化二阶中心矩
+    double angle = 0;               // 主轴与竖直方向夹角 (度)
+    double length = 0, width = 0;   // 按等效矩形估计的主轴 / 次轴长度
+};
+
+// 二值图游程连通域标记: 逐行提取游程并用并查集合并相邻行重叠的游程
+// 每个连通域输出一条外轮廓多边形，对逐行连续的连通域与 findContours(RETR_LIST, CHAIN_APPROX_NONE)
+// 的外轮廓逐点覆盖相同的边界像素；像素数不足 min_area 的连通域直接丢弃
+// 临时数组取自 FrameArena，contours 中原有元素的容量留作后续调用复用
+void getRunLengthContours(
+    const cv::Mat& binary,
+    std::vector<std::vector<cv::Point>>& contours,
+    std::vector<RunComponent>& components,
+    int min_area);
+
+// 对比游程标记与 findContours 在合成灯条二值图上的耗时与轮廓面积差异
+void benchmarkRunLength(int iterations);
+
+#endif
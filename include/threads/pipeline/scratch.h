@@ -0,0 +1,58 @@
+#ifndef RM2024_THREADS_PIPELINE_SCRATCH_H_
+#define RM2024_THREADS_PIPELINE_SCRATCH_H_
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include "data_manager/base.h"
+#include "threads/pipeline/run_length.h"
+#include "threads/pipeline/planar_pnp.h"
+
+// 每线程单调分配区: 帧内临时数组从线程私有缓冲区顺序分配，不单独释放，每帧开始时整体重置
+// 上一帧用量超出缓冲区时，超出部分从堆上分配并在重置时按峰值扩容，稳态下不再访问堆
+class FrameArena {
+public:
+    static FrameArena& local();
+
+    std::pmr::memory_resource* resource() { return resource_.get(); }
+
+    void reset();
+
+private:
+    // 统计溢出到堆上的字节数
+    class Upstream : public std::pmr::memory_resource {
+    public:
+        size_t overflow = 0;
+    private:
+        void* do_allocate(size_t bytes, size_t align) override;
+        void do_deallocate(void* ptr, size_t bytes, size_t align) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    FrameArena();
+
+    std::unique_ptr<std::byte[]> buffer_;
+    size_t size_ = 0;
+    Upstream upstream_;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> resource_;
+};
+
+// pointer / locater 每线程复用的临时对象，容器 clear 后保留容量；灰度与二值平面归检测框 ROI 所有
+struct TrackerScratch {
+    static TrackerScratch& local();
+
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<RunComponent> components;
+    std::vector<rm::Lightbar> lightbar_list;
+    std::vector<rm::Lightbar> candidate_list;
+
+    cv::Mat rvec, tvec, rotate_cv;
+    std::vector<PlanarPnPInput> pnp_inputs;
+    std::vector<PlanarPose> pnp_poses;
+    std::vector<std::vector<cv::Point2f>> normalized_points;
+};
+
+// 取 buffer 左上角 rows x cols 的子矩阵，buffer 不足时扩大，之后 create 同尺寸同类型时不再分配
+cv::Mat getScratchMat(cv::Mat& buffer, int rows, int cols, int type);
+
+#endif
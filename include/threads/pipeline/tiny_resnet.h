@@ -0,0 +1,72 @@
+#ifndef RM2024_THREADS_PIPELINE_TINY_RESNET_H_
+#define RM2024_THREADS_PIPELINE_TINY_RESNET_H_
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <opencv2/opencv.hpp>
+
+// 数字分类器 (tiny_resnet) 的进程内 CPU 实现
+// 权重与拓扑从 ONNX 文件读取，BN 折叠进卷积，ReLU 融合进前驱算子
+// 中间特征使用 HWC 布局并将通道补齐到 SIMD 宽度，卷积沿输出通道向量化
+class TinyResNet {
+public:
+    // 读取 ONNX 并构建算子序列，遇到不支持的层时返回 false
+    bool load(const std::string& onnx_file, int infer_width, int infer_height, double scale, bool swap_rb);
+
+    // 在录制的分类器输入上与参考推理 (TensorRT) 对比输出，返回最大绝对误差
+    // reference 对同一 patch 走参考推理的完整预处理，结果写入长度为 classNum() 的 output
+    double parity(
+        const std::vector<cv::Mat>& patches,
+        const std::function<void(const cv::Mat&, float*)>& reference);
+
+    // 打印本实现与 cv::dnn 参考实现的单 ROI 平均耗时
+    void benchmark(int iterations);
+
+    // roi 为已缩放到输入尺寸的 BGR 图像，输出写入 output (长度为 classNum())
+    void forward(const cv::Mat& roi, float* output);
+
+    bool ready() const { return ready_; }
+    int classNum() const { return class_num_; }
+
+private:
+    enum OpType { kConv, kMaxPool, kAvgPool, kAdd, kDense, kSoftmax };
+
+    struct Shape {
+        int c = 0, h = 0, w = 0;
+        int cp = 0;     // 补齐后的通道数
+        size_t size() const { return (size_t)h * w * cp; }
+    };
+
+    struct Op {
+        OpType type;
+        int src0 = -1, src1 = -1, dst = -1;
+        int kh = 1, kw = 1, sh = 1, sw = 1, ph = 0, pw = 0;
+        bool relu = false;
+        std::vector<float> weight;  // 卷积: [kh][kw][ic][ocp]  全连接: [h][w][ic][ocp]
+        std::vector<float> bias;    // [ocp]
+    };
+
+    void setInput(const cv::Mat& roi);
+    void runConv(const Op& op);
+    void runPool(const Op& op);
+    void runAdd(const Op& op);
+    void runDense(const Op& op);
+    void runSoftmax(const Op& op);
+
+    cv::dnn::Net net_;
+    std::vector<Op> ops_;
+    std::vector<Shape> shapes_;
+    std::vector<std::vector<float>> tensors_;
+    cv::Mat input_;
+
+    int infer_width_ = 0;
+    int infer_height_ = 0;
+    int output_tensor_ = 0;
+    int class_num_ = 0;
+    double scale_ = 1.0 / 255.0;
+    bool swap_rb_ = true;
+    bool ready_ = false;
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef RM2024_THREADS_PIPELINE_YAW_PNP_H_
+#define RM2024_THREADS_PIPELINE_YAW_PNP_H_
+
+#include <vector>
+#include "data_manager/base.h"
+
+// 装甲板俯仰固定、仅搜索世界系偏航角的 PnP 参数
+struct YawSearchParam {
+    double armor_pitch = 15.0;      // 装甲板外法线仰角 (度)
+    double warm_window = 20.0;      // 热启动搜索半宽 (度)
+    double tolerance   = 0.01;      // 搜索区间收敛宽度 (度)
+    int    max_iterations = 16;
+};
+
+struct YawPose {
+    Eigen::Matrix3d rotation;       // 相机坐标系下的旋转，与 cv::solvePnP 的 Rodrigues(rvec) 含义相同
+    Eigen::Vector3d translation;    // 相机坐标系下的平移，与 tvec 含义相同
+    double armor_yaw = 0;           // 世界系装甲板偏航，与 rm::tf_rotation2armoryaw 约定一致
+    double error = 0;               // 归一化平面上的重投影误差平方和
+    int    iterations = 0;          // 多点划分搜索的轮数
+    bool   warm = false;            // 是否由热启动区间得到
+    bool   valid = false;
+};
+
+// 世界系 z 轴竖直向上，装甲板旋转 = Rz(偏航) * 固定仰角的基准姿态
+// 给定偏航时平移由线性最小二乘闭式求出，重投影点对 (cos, sin) 是线性的，
+// 因而每轮可用 SIMD 同时评估多个候选偏航；区间按最优候选收缩，最后做一次抛物线 (Newton) 修正
+// normalized 为去畸变后的归一化像点，rotate_pnp2world = rotate_head2world * rotate_pnp2head
+// warm_yaw 非空时先在其 ±warm_window 内搜索，最优解落在区间端点时退回冷启动区间 (朝向相机 ±90°)
+YawPose searchArmorYaw(
+    const std::vector<cv::Point3f>& object,
+    const std::vector<cv::Point2f>& normalized,
+    const Eigen::Matrix3d& rotate_pnp2world,
+    const YawSearchParam& param,
+    const double* warm_yaw);
+
+// 启动时的一致性检查: 在合成位姿上比较冷启动搜索与 rm::solveYawPnP 的偏航，输出最大偏差 (度)
+// 相机参数不可用或搜索失败时返回 false
+bool checkYawPnP(rm::Camera* camera, const std::vector<cv::Point3f>& object, const YawSearchParam& param, double& max_diff);
+
+// 在合成位姿上比较冷启动、热启动与 rm::solveYawPnP 的单块装甲板耗时，以及与真值的偏航偏差
+void benchmarkYawPnP(rm::Camera* camera, const std::vector<cv::Point3f>& object, const YawSearchParam& param, int iterations);
+
+#endif
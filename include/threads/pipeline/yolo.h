@@ -0,0 +1,61 @@
+#ifndef RM2024_THREADS_PIPELINE_YOLO_H_
+#define RM2024_THREADS_PIPELINE_YOLO_H_
+
+#include <string>
+#include <vector>
+#include "data_manager/base.h"
+
+// 单个装甲板检测网络的配置，对应 Model.YoloArmor.<Type>
+struct YoloConfig {
+    std::string type;
+    std::string onnx_file;
+    std::string engine_file;
+    int    infer_width;
+    int    infer_height;
+    int    class_num;
+    int    bboxes_num;
+    double confidence_thresh;
+    double nms_thresh;
+    size_t yolo_struct_size;
+};
+
+YoloConfig getYoloConfig(const std::string& yolo_type);
+
+// 按网络类型 (V5 / FP / FPX) 解码网络输出并执行 NMS，类型非法时返回 false
+bool yoloArmorNMS(
+    const std::string& yolo_type,
+    std::vector<rm::YoloRect>& yolo_list,
+    float* output_host_buffer,
+    int bboxes_num,
+    int class_num,
+    double confidence_thresh,
+    double nms_thresh,
+    int width,
+    int height,
+    int infer_width,
+    int infer_height);
+
+// 将整幅图像划分为带重叠的切片，切片尺寸即网络输入尺寸（原生分辨率，不缩放）
+std::vector<cv::Rect> getYoloTiles(int width, int height, int tile_width, int tile_height, double overlap);
+
+// 将切片坐标系下的检测结果平移到整幅图像坐标系
+void offsetYoloRect(rm::YoloRect& yolo_rect, const cv::Point& offset);
+
+// 跨切片合并检测结果，同类别且交集占较小框面积超过阈值时只保留置信度最高者
+void mergeYoloRects(std::vector<rm::YoloRect>& yolo_list, double merge_thresh);
+
+// CPU 推理的输入预处理: 一次遍历完成居中 letterbox、双线性缩放、归一化与 HWC->CHW
+// src 为 BGR 图像或单通道 BayerBG 原始图像，dst 为 3 x infer_height x infer_width 的平面浮点张量
+void letterboxBlob(
+    const cv::Mat& src,
+    float* dst,
+    int infer_width,
+    int infer_height,
+    bool swap_rb,
+    float pad_value,
+    float norm_scale);
+
+// 对比 letterboxBlob 与 OpenCV 逐步实现 (resize / copyMakeBorder / convertTo / split) 的耗时与误差
+void benchmarkLetterbox(int src_width, int src_height, int infer_width, int infer_height, int iterations);
+
+#endif
@@ -0,0 +1,63 @@
+#include "data_manager/alloc_counter.h"
+#include <opencv2/opencv.hpp>
+#include <cstdlib>
+#include <new>
+
+#ifdef TJURM_ALLOC_COUNT
+
+static thread_local uint64_t alloc_count = 0;
+
+void* operator new(std::size_t size) {
+    alloc_count++;
+    void* ptr = std::malloc(size ? size : 1);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+// cv::Mat 数据区经 fastMalloc 分配，不经过 operator new，在默认分配器外包一层计数
+// 释放由 UMatData 记录的标准分配器完成
+class CountingMatAllocator : public cv::MatAllocator {
+public:
+    cv::UMatData* allocate(
+        int dims, const int* sizes, int type, void* data, size_t* step,
+        cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override {
+        if (data == nullptr) alloc_count++;
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usage_flags);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override {
+        return cv::Mat::getStdAllocator()->allocate(data, flags, usage_flags);
+    }
+
+    void deallocate(cv::UMatData* data) const override {
+        cv::Mat::getStdAllocator()->deallocate(data);
+    }
+};
+
+void initAllocCounter() {
+    static CountingMatAllocator allocator;
+    cv::Mat::setDefaultAllocator(&allocator);
+}
+
+uint64_t getThreadAllocCount() {
+    return alloc_count;
+}
+
+#else
+
+void initAllocCounter() {}
+
+uint64_t getThreadAllocCount() {
+    return 0;
+}
+
+#endif
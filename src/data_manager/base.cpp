@@ -10,7 +10,7 @@ rm::ArmorID Data::self_id;
 // 当前核心打击目标
 rm::ArmorID Data::target_id;
 double Data::target_omega;
-double Data::target_dist;
+std::atomic<double> Data::target_dist(0.0);
 
 // 相机的参数记录
 std::vector<rm::Camera*> Data::camera;
@@ -58,6 +58,7 @@ bool Data::histogram_flag;
 bool Data::reprojection_flag;
 bool Data::pipeline_delay_flag;
 bool Data::point_skip_flag;
+bool Data::benchmark_flag;
 
 bool Data::state_delay_flag;
 double Data::state_delay_time;
@@ -0,0 +1,318 @@
+#include "data_manager/config.h"
+#include "data_manager/param.h"
+#include <atomic>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <thread>
+#include <set>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+extern std::atomic<bool> g_running;
+
+using nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+static ConfigPtr config_snapshot;
+
+// 沿路径查找节点，失败时返回 nullptr 并在 error 中给出已走到的位置
+// walked 为解析 "$Type" 后的实际路径
+static const json* findNode(const json& root, const std::string& path, std::string& walked, std::string& error) {
+    const json* node = &root;
+    walked.clear();
+    std::stringstream stream(path);
+    std::string key;
+    while (std::getline(stream, key, '/')) {
+        if (key == "$Type") {
+            auto it = node->find("Type");
+            if (it == node->end() || !it->is_string()) {
+                error = "缺少字符串字段 " + walked + "/Type";
+                return nullptr;
+            }
+            key = it->get<std::string>();
+        }
+        walked += walked.empty() ? key : "/" + key;
+        if (!node->is_object()) {
+            error = "父节点不是对象: " + walked;
+            return nullptr;
+        }
+        auto it = node->find(key);
+        if (it == node->end()) {
+            error = "缺少键 " + walked;
+            return nullptr;
+        }
+        node = &(*it);
+    }
+    return node;
+}
+
+static bool readValue(const json& node, double& value, std::string& expect) {
+    expect = "数值";
+    if (!node.is_number()) return false;
+    value = node.get<double>();
+    return true;
+}
+
+static bool readValue(const json& node, int& value, std::string& expect) {
+    expect = "整数";
+    if (!node.is_number_integer()) return false;
+    value = node.get<int>();
+    return true;
+}
+
+static bool readValue(const json& node, bool& value, std::string& expect) {
+    expect = "布尔";
+    if (!node.is_boolean()) return false;
+    value = node.get<bool>();
+    return true;
+}
+
+static bool readValue(const json& node, std::string& value, std::string& expect) {
+    expect = "字符串";
+    if (!node.is_string()) return false;
+    value = node.get<std::string>();
+    return true;
+}
+
+template<size_t N>
+static bool readValue(const json& node, std::array<double, N>& value, std::string& expect) {
+    expect = "长度为 " + std::to_string(N) + " 的数值数组";
+    if (!node.is_array() || node.size() != N) return false;
+    for (size_t i = 0; i < N; i++) {
+        if (!node[i].is_number()) return false;
+        value[i] = node[i].get<double>();
+    }
+    return true;
+}
+
+static bool readValue(const json& node, std::vector<int>& value, std::string& expect) {
+    expect = "非空整数数组";
+    if (!node.is_array() || node.empty()) return false;
+    value.clear();
+    for (const auto& item : node) {
+        if (!item.is_number_integer()) return false;
+        value.push_back(item.get<int>());
+    }
+    return true;
+}
+
+template<typename T>
+static void readField(const json& root, const char* path, T& value, std::vector<std::string>& errors) {
+    std::string walked, error, expect;
+    const json* node = findNode(root, path, walked, error);
+    if (node == nullptr) {
+        errors.push_back(std::string(path) + ": " + error);
+        return;
+    }
+    if (!readValue(*node, value, expect)) {
+        errors.push_back(std::string(path) + ": 应为" + expect + "，实际为 " + node->dump());
+    }
+}
+
+static std::shared_ptr<ConfigSnapshot> buildSnapshot(const json& root, std::vector<std::string>& errors) {
+    auto snapshot = std::make_shared<ConfigSnapshot>();
+    size_t error_count = errors.size();
+
+#define CONFIG_SNAPSHOT_READ(type, name, path) readField(root, path, snapshot->name, errors);
+    CONFIG_SNAPSHOT_FIELDS(CONFIG_SNAPSHOT_READ)
+#undef CONFIG_SNAPSHOT_READ
+
+    if (errors.size() != error_count) return nullptr;
+    return snapshot;
+}
+
+ConfigPtr buildConfigSnapshot(const json& root, std::vector<std::string>& errors) {
+    return buildSnapshot(root, errors);
+}
+
+// 序号接续当前快照，由启动流程与监视线程调用
+static void publishSnapshot(const std::shared_ptr<ConfigSnapshot>& snapshot) {
+    ConfigPtr current = std::atomic_load(&config_snapshot);
+    snapshot->version = (current == nullptr) ? 1 : current->version + 1;
+    snapshot->publish_time = Clock::now();
+    std::atomic_store(&config_snapshot, ConfigPtr(snapshot));
+}
+
+bool initConfigSnapshot() {
+    auto param = Param::get_instance();
+    std::vector<std::string> errors;
+    auto snapshot = buildSnapshot(param->root(), errors);
+    if (snapshot == nullptr) {
+        for (const auto& error : errors) std::cout << "[CONFIG] " << error << std::endl;
+        std::cout << "[CONFIG] 配置校验失败，共 " << errors.size() << " 项" << std::endl;
+        return false;
+    }
+    publishSnapshot(snapshot);
+    return true;
+}
+
+ConfigPtr getConfigSnapshot() {
+    return std::atomic_load(&config_snapshot);
+}
+
+std::vector<std::string> diffConfigSnapshot(const ConfigSnapshot& a, const ConfigSnapshot& b) {
+    std::vector<std::string> paths;
+#define CONFIG_SNAPSHOT_DIFF(type, name, path) if (a.name != b.name) paths.push_back(path);
+    CONFIG_SNAPSHOT_FIELDS(CONFIG_SNAPSHOT_DIFF)
+#undef CONFIG_SNAPSHOT_DIFF
+    return paths;
+}
+
+// 快照字段按顶层键归属的阶段，仅用于热更新报告
+static const char* getSubsystem(const std::string& path) {
+    static const std::pair<const char*, const char*> table[] = {
+        {"Points", "pointer"}, {"Car", "control"}, {"Model", "control"},
+        {"Kalman", "garage"},  {"Camera", "recording"},
+    };
+    for (const auto& item : table) {
+        if (path.compare(0, strlen(item.first), item.first) == 0) return item.second;
+    }
+    return "unknown";
+}
+
+// 在本兵种上被运行时数据覆盖的快照字段，改动不会生效，热更新报告中单独列出
+static bool isInertField(const std::string& path) {
+    #ifdef TJURM_HERO
+    // 英雄的弹速每帧取裁判系统弹速均值 (Control::shootspeed)
+    if (path == "Car/ShootSpeed") return true;
+    #endif
+    return false;
+}
+
+static std::string joinPaths(const std::vector<std::string>& paths) {
+    std::string text;
+    for (const auto& path : paths) text += (text.empty() ? "" : ", ") + path;
+    return text;
+}
+
+// 重新读取配置文件，校验通过且有变化时发布；latency 自文件最后一次写入事件起算
+static void reloadConfig(const std::string& path, json& last, Clock::time_point event_time) {
+    Clock::time_point tp0 = Clock::now();
+    ConfigPtr current = getConfigSnapshot();
+
+    json root;
+    try {
+        std::ifstream input(path);
+        input >> root;
+    } catch (const json::exception& e) {
+        std::cout << "[CONFIG] 解析失败，保留 v" << current->version << ": " << e.what() << std::endl;
+        return;
+    }
+
+    std::vector<std::string> errors;
+    auto snapshot = buildSnapshot(root, errors);
+    if (snapshot == nullptr) {
+        for (const auto& error : errors) std::cout << "[CONFIG] " << error << std::endl;
+        std::cout << "[CONFIG] 校验失败 " << errors.size() << " 项，保留 v" << current->version << std::endl;
+        return;
+    }
+
+    // 变化的键按是否落在快照字段内划分为热更新与需重启两类
+    json patch = json::diff(last, root);
+    if (patch.empty()) return;
+
+    std::vector<std::string> field_pointers;
+    for (const char* field : {
+#define CONFIG_SNAPSHOT_PATH(type, name, path) path,
+        CONFIG_SNAPSHOT_FIELDS(CONFIG_SNAPSHOT_PATH)
+#undef CONFIG_SNAPSHOT_PATH
+    }) {
+        std::string walked, error;
+        if (findNode(root, field, walked, error) != nullptr) field_pointers.push_back("/" + walked);
+    }
+
+    std::vector<std::string> restart_paths;
+    std::set<std::string> subsystems;
+    for (const auto& op : patch) {
+        std::string pointer = op["path"];
+        bool hot = false;
+        for (const auto& field : field_pointers) {
+            if (pointer.compare(0, field.size(), field) == 0 &&
+                (pointer.size() == field.size() || pointer[field.size()] == '/')) {
+                hot = true;
+                break;
+            }
+        }
+        if (!hot) restart_paths.push_back(pointer);
+    }
+    std::vector<std::string> hot_paths, inert_paths;
+    for (const auto& field : diffConfigSnapshot(*current, *snapshot)) {
+        if (isInertField(field)) inert_paths.push_back(field);
+        else hot_paths.push_back(field);
+    }
+    for (const auto& field : hot_paths) subsystems.insert(getSubsystem(field));
+
+    last = root;
+    if (!hot_paths.empty() || !inert_paths.empty()) publishSnapshot(snapshot);
+
+    Clock::time_point tp1 = Clock::now();
+    double build_ms = std::chrono::duration<double, std::milli>(tp1 - tp0).count();
+    double latency_ms = std::chrono::duration<double, std::milli>(tp1 - event_time).count();
+    if (!hot_paths.empty()) {
+        std::cout << "[CONFIG] v" << snapshot->version << " 已发布: 解析校验 " << build_ms
+                  << " ms, 写入到发布 " << latency_ms << " ms" << std::endl;
+        std::cout << "[CONFIG] 下一帧生效 (" << joinPaths({subsystems.begin(), subsystems.end()})
+                  << "): " << joinPaths(hot_paths) << std::endl;
+    }
+    if (!restart_paths.empty()) {
+        std::cout << "[CONFIG] 以下键不支持热更新，需重启生效: " << joinPaths(restart_paths) << std::endl;
+    }
+    if (!inert_paths.empty()) {
+        std::cout << "[CONFIG] 以下键在本兵种上不生效 (被运行时数据覆盖): " << joinPaths(inert_paths) << std::endl;
+    }
+}
+
+void startConfigWatch() {
+    auto param = Param::get_instance();
+    bool enable = (*param)["Debug"]["HotReload"]["Enable"];
+    double debounce = (*param)["Debug"]["HotReload"]["Debounce"];
+    if (!enable) return;
+
+    // 监视所在目录而非文件本身，编辑器以重命名方式保存时文件的 inode 会变化
+    std::string path = param->path();
+    size_t slash = path.find_last_of('/');
+    std::string dir  = (slash == std::string::npos) ? "." : path.substr(0, slash);
+    std::string name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        std::cout << "[CONFIG] 无法监视 " << dir << "，热更新关闭" << std::endl;
+        if (fd >= 0) close(fd);
+        return;
+    }
+    std::cout << "[CONFIG] 监视 " << path << std::endl;
+
+    json last = param->root();
+    std::thread([fd, path, name, debounce, last]() mutable {
+        alignas(inotify_event) char buffer[4096];
+        bool pending = false;
+        Clock::time_point event_time;
+
+        while (g_running) {
+            pollfd poll_fd = {fd, POLLIN, 0};
+            if (poll(&poll_fd, 1, 100) > 0) {
+                ssize_t len;
+                while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+                    for (char* ptr = buffer; ptr < buffer + len; ) {
+                        const inotify_event* event = (const inotify_event*)ptr;
+                        if (event->len > 0 && name == event->name) {
+                            pending = true;
+                            event_time = Clock::now();
+                        }
+                        ptr += sizeof(inotify_event) + event->len;
+                    }
+                }
+            }
+
+            // 保存往往触发多次写入事件，静默 debounce 秒后再读取
+            if (pending && std::chrono::duration<double>(Clock::now() - event_time).count() > debounce) {
+                pending = false;
+                reloadConfig(path, last, event_time);
+            }
+        }
+        close(fd);
+    }).detach();
+}
@@ -5,8 +5,10 @@
 #include <fstream>
 #include <chrono>
 #include <mutex>
+#include <atomic>
 #include "data_manager/base.h"
 #include "data_manager/param.h"
+#include "data_manager/undistort.h"
 #include "threads/pipeline.h"
 #include "threads/control.h"
 #include "garage/garage.h"
@@ -15,6 +17,8 @@
 
 using namespace std;
 
+extern std::atomic<bool> g_running;
+
 // 全局相机句柄和帧缓冲
 static void* g_camera_handle = NULL;
 std::mutex g_frame_mutex;
@@ -107,6 +111,7 @@ void init_debug() {
     Data::reprojection_flag = (*param)["Debug"]["Display"]["Reprojection"];
     Data::pipeline_delay_flag = (*param)["Debug"]["Display"]["PipelineDelay"];
     Data::point_skip_flag = (*param)["Debug"]["Display"]["PointSkip"];
+    Data::benchmark_flag = (*param)["Debug"]["Display"]["Benchmark"];
 
     Data::state_delay_flag = (*param)["Debug"]["StateDelay"]["Enable"];
     Data::state_delay_time = (*param)["Debug"]["StateDelay"]["TimeS"];
@@ -114,6 +119,14 @@ void init_debug() {
     Data::send_wait_time = (*param)["Debug"]["StateDelay"]["SendWait"];
 }
 
+// 按 Camera.Undistort 为相机建立去畸变查表，失败时各模块回退到带畸变系数的求解
+static void init_undistort(int camera_id) {
+    auto param = Param::get_instance();
+    if (!(*param)["Camera"]["Undistort"]["Enable"]) return;
+    int step = (*param)["Camera"]["Undistort"]["Step"];
+    buildUndistortMap(camera_id, step);
+}
+
 bool init_camera() {
     auto param = Param::get_instance();
     auto control = Control::get_instance();
@@ -303,6 +316,7 @@ bool init_camera() {
             }
         }
         
+        init_undistort(0);
         rm::message("Camera initialized successfully", rm::MSG_NOTE);
         return true;
         
@@ -312,6 +326,115 @@ bool init_camera() {
     }
 }
 
+// 离线模式: 不打开相机，仅按 Camera.Base 加载标定参数，分辨率取自录像
+bool init_camera_offline(int width, int height) {
+    auto param = Param::get_instance();
+
+    nlohmann::json camlens;
+    std::string camlen_path = (*param)["Camera"]["CamLensDir"];
+    try {
+        std::ifstream camlens_json(camlen_path);
+        camlens_json >> camlens;
+        camlens_json.close();
+    } catch (std::exception& e) {
+        std::string err_str = "Failed to load CamLens json: " + std::string(e.what());
+        rm::message(err_str, rm::MSG_ERROR);
+        return false;
+    }
+
+    std::string camera_type = (*param)["Camera"]["Base"]["CameraType"];
+    std::string lens_type = (*param)["Camera"]["Base"]["LensType"];
+    std::vector<double> camera_offset = (*param)["Car"]["CameraOffset"]["Base"];
+
+    Data::camera.clear();
+    Data::camera.resize(1, nullptr);
+    Data::camera_index = 0;
+    Data::camera_base = 0;
+    Data::camera_far = 0;
+
+    Data::camera[0] = new rm::Camera();
+    Data::camera[0]->width = width;
+    Data::camera[0]->height = height;
+
+    Param::from_json(camlens[camera_type][lens_type]["Intrinsic"], Data::camera[0]->intrinsic_matrix);
+    Param::from_json(camlens[camera_type][lens_type]["Distortion"], Data::camera[0]->distortion_coeffs);
+    if (Data::camera[0]->intrinsic_matrix.rows != 3 || Data::camera[0]->intrinsic_matrix.cols != 3) {
+        rm::message("Invalid intrinsic matrix for offline camera", rm::MSG_ERROR);
+        delete Data::camera[0];
+        Data::camera[0] = nullptr;
+        return false;
+    }
+
+    rm::tf_rotate_pnp2head(Data::camera[0]->Rotate_pnp2head, camera_offset[3], camera_offset[4], 0.0);
+    rm::tf_trans_pnp2head(Data::camera[0]->Trans_pnp2head, camera_offset[0], camera_offset[1],
+                        camera_offset[2], camera_offset[3], camera_offset[4], 0.0);
+
+    init_undistort(0);
+    rm::message("Offline camera: " + std::to_string(width) + "x" + std::to_string(height), rm::MSG_NOTE);
+    return true;
+}
+
+// 回放相机: 按录像帧率循环推送录像帧，替代海康相机用于启动与整条流水线的端到端测试
+bool init_camera_replay(const std::string& video_path) {
+    auto param = Param::get_instance();
+
+    auto capture = std::make_shared<cv::VideoCapture>(video_path);
+    if (!capture->isOpened()) {
+        rm::message("Failed to open replay video: " + video_path, rm::MSG_ERROR);
+        return false;
+    }
+    int width = (int)capture->get(cv::CAP_PROP_FRAME_WIDTH);
+    int height = (int)capture->get(cv::CAP_PROP_FRAME_HEIGHT);
+    double fps = capture->get(cv::CAP_PROP_FPS);
+    if (fps <= 0) fps = (*param)["Camera"]["Base"]["FrameRate"];
+
+    if (!init_camera_offline(width, height)) return false;
+    Data::camera[0]->buffer = new rm::SwapBuffer<rm::Frame>();
+    rm::mallocYoloCameraBuffer(&Data::camera[0]->rgb_host_buffer, &Data::camera[0]->rgb_device_buffer,
+                              width, height);
+
+    std::thread([capture, fps]() {
+        auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / fps));
+        auto next = std::chrono::steady_clock::now();
+        int fail_count = 0;
+        while (g_running) {
+            cv::Mat image;
+            if (!capture->read(image) || image.empty()) {
+                // 播放结束后从头循环，连续读取失败说明录像损坏
+                if (++fail_count > 1) break;
+                capture->set(cv::CAP_PROP_POS_FRAMES, 0);
+                continue;
+            }
+            fail_count = 0;
+
+            auto frame = std::make_shared<rm::Frame>();
+            frame->image = std::make_shared<cv::Mat>(image);
+            frame->time_point = getTime();
+            frame->camera_id = 0;
+            frame->width = image.cols;
+            frame->height = image.rows;
+            frame->yaw = 0.f;
+            frame->pitch = 0.f;
+            frame->roll = 0.f;
+            Data::camera[0]->buffer->push(frame);
+
+            {
+                std::lock_guard<std::mutex> lock(g_frame_mutex);
+                image.copyTo(g_display_frame);
+                g_new_frame_available = true;
+            }
+
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+        rm::message("Replay camera stopped", rm::MSG_WARNING);
+    }).detach();
+
+    rm::message("Replay camera: " + video_path + " @ " + std::to_string(fps) + "fps", rm::MSG_NOTE);
+    return true;
+}
+
 bool deinit_camera() {
     // 首先停止相机采集 - 这会停止回调函数被调用
     if (g_camera_handle != nullptr) {
@@ -358,52 +481,60 @@ void init_serial() {
     int status;
     std::vector<std::string> port_list;
     auto control = Control::get_instance();
+    auto param = Param::get_instance();
 
-    // 获取互斥锁以保护串口操作
-    std::lock_guard<std::mutex> lock(control->serial_mutex_);
+    // 指定端口时跳过枚举，可用于 pty 等虚拟串口
+    std::string port_override = (*param)["Debug"]["Control"]["SerialPort"];
 
     // 关闭已打开的文件描述符（如果存在）
-    if (control->file_descriptor_ > 0) {
-        rm::closeSerialPort(control->file_descriptor_);
-        control->file_descriptor_ = -1;
+    {
+        std::lock_guard<std::mutex> lock(control->serial_mutex_);
+        if (control->file_descriptor_ > 0) {
+            rm::closeSerialPort(control->file_descriptor_);
+            control->file_descriptor_ = -1;
+        }
     }
 
-    while(true) {
-
-        #if defined(TJURM_HERO)
-        status = (int)rm::getSerialPortList(port_list, rm::SERIAL_TYPE_TTY_ACM);
-        #endif
-
-        #if defined(TJURM_BALANCE) || defined(TJURM_INFANTRY) || defined(TJURM_DRONSE) || defined(TJURM_SENTRY)
-        status = (int)rm::getSerialPortList(port_list, rm::SERIAL_TYPE_TTY_USB);
-        #endif
+    // 枚举与打开串口期间不持有互斥锁，避免重试等待阻塞发送线程
+    int file_descriptor = -1;
+    std::string port_name;
+    while(g_running) {
+        port_list.clear();
+        if (!port_override.empty()) {
+            port_list.push_back(port_override);
+            status = 0;
+        } else {
+            #if defined(TJURM_HERO)
+            status = (int)rm::getSerialPortList(port_list, rm::SERIAL_TYPE_TTY_ACM);
+            #endif
+
+            #if defined(TJURM_BALANCE) || defined(TJURM_INFANTRY) || defined(TJURM_DRONSE) || defined(TJURM_SENTRY)
+            status = (int)rm::getSerialPortList(port_list, rm::SERIAL_TYPE_TTY_USB);
+            #endif
+        }
 
         if (status != 0 || port_list.empty()) {
             rm::message("Control port list failed", rm::MSG_ERROR);
             std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            port_list.clear();
             continue;
         }
 
-        control->port_name_ = port_list[0];
-        status = (int)rm::openSerialPort(control->file_descriptor_, control->port_name_);
+        port_name = port_list[0];
+        status = (int)rm::openSerialPort(file_descriptor, port_name);
         if (status != 0) {
             rm::message("Control port open failed", rm::MSG_ERROR);
             std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            port_list.clear();
             continue;
         }
-        if(status == 0) {
-            rm::message("Serial port initialized successfully: " + control->port_name_, rm::MSG_WARNING);
-            break;
-        }
+        break;
     }
-}
-
-
-
-
+    if (!g_running) return;
 
+    std::lock_guard<std::mutex> lock(control->serial_mutex_);
+    control->port_name_ = port_name;
+    control->file_descriptor_ = file_descriptor;
+    rm::message("Serial port initialized successfully: " + control->port_name_, rm::MSG_WARNING);
+}
 
 void init_attack() {
     #ifdef TJURM_SENTRY
@@ -11,6 +11,7 @@ using std::string;
 
 // 加载json文件
 bool Param::load(const string& path) {
+    path_ = path;
     ifstream input_json(path);
     input_json >> params_;
     return !params_.is_null();
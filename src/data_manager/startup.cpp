@@ -0,0 +1,102 @@
+#include "data_manager/startup.h"
+#include <thread>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+void Startup::add(const std::string& name, const std::vector<std::string>& deps, std::function<bool()> func) {
+    Stage stage;
+    stage.name = name;
+    stage.func = func;
+    for (const auto& dep : deps) {
+        auto it = std::find_if(stages_.begin(), stages_.end(), [&](const Stage& s) { return s.name == dep; });
+        if (it == stages_.end()) {
+            rm::message("Startup dependency not registered: " + name + " -> " + dep, rm::MSG_ERROR);
+            stage.state = kFailed;
+            continue;
+        }
+        stage.deps.push_back(it - stages_.begin());
+    }
+    stages_.push_back(stage);
+}
+
+void Startup::runStage(int index) {
+    Stage& stage = stages_[index];
+
+    // 等待所有依赖结束，任一依赖未就绪则跳过本组件
+    bool deps_ready = true;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (stage.state == kFailed) {
+            cv_.notify_all();
+            return;
+        }
+        cv_.wait(lock, [&]() {
+            for (int dep : stage.deps) {
+                State state = stages_[dep].state;
+                if (state == kPending || state == kRunning) return false;
+            }
+            return true;
+        });
+        for (int dep : stage.deps) deps_ready = deps_ready && (stages_[dep].state == kReady);
+        if (!deps_ready) {
+            stage.state = kSkipped;
+            cv_.notify_all();
+            return;
+        }
+        stage.state = kRunning;
+        stage.start_ms = getDoubleOfS(start_time_, getTime()) * 1000;
+    }
+
+    bool ok = false;
+    try {
+        ok = stage.func();
+    } catch (const std::exception& e) {
+        rm::message("Startup " + stage.name + " exception: " + std::string(e.what()), rm::MSG_ERROR);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stage.end_ms = getDoubleOfS(start_time_, getTime()) * 1000;
+    stage.state = ok ? kReady : kFailed;
+    std::cout << "[STARTUP] " << stage.name << (ok ? " ready" : " failed") << " @ "
+              << std::fixed << std::setprecision(1) << stage.end_ms << "ms" << std::endl;
+    cv_.notify_all();
+}
+
+bool Startup::run() {
+    start_time_ = getTime();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < (int)stages_.size(); i++) {
+        threads.emplace_back(&Startup::runStage, this, i);
+    }
+    for (auto& thread : threads) thread.join();
+    total_ms_ = getDoubleOfS(start_time_, getTime()) * 1000;
+
+    bool all_ready = true;
+    for (const auto& stage : stages_) all_ready = all_ready && (stage.state == kReady);
+    return all_ready;
+}
+
+void Startup::report() {
+    const int bar_width = 40;
+    const char* state_name[] = {"PENDING", "RUNNING", "READY", "FAILED", "SKIPPED"};
+    double scale = (total_ms_ > 0) ? bar_width / total_ms_ : 0.0;
+
+    std::cout << "[STARTUP] ========== 启动时间线 ==========" << std::endl;
+    for (const auto& stage : stages_) {
+        int begin = std::min(bar_width, (int)(stage.start_ms * scale));
+        int end = std::min(bar_width, std::max(begin + 1, (int)(stage.end_ms * scale)));
+        std::string bar(bar_width, ' ');
+        if (stage.state == kReady || stage.state == kFailed) {
+            std::fill(bar.begin() + begin, bar.begin() + end, '=');
+        }
+
+        std::cout << "[STARTUP] " << std::left << std::setw(12) << stage.name << std::right
+                  << " |" << bar << "| "
+                  << std::fixed << std::setprecision(1) << std::setw(8) << stage.start_ms << " -> "
+                  << std::setw(8) << stage.end_ms << "ms  " << state_name[stage.state] << std::endl;
+    }
+    std::cout << "[STARTUP] total " << std::fixed << std::setprecision(1) << total_ms_ << "ms" << std::endl;
+    rm::message("startup time", total_ms_);
+}
@@ -2,6 +2,11 @@
 #include "garage/wrapper_car.h"
 #include "garage/wrapper_rune.h"
 #include "garage/wrapper_tower.h"
+#include <cstring>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <tuple>
 
 static int objmap[10] = {0, 1, 2, 3, 4, 5, 6, 7, 6, 7};
 
@@ -19,9 +24,223 @@ Garage::Garage() {
     obj_[5] = make_shared<WrapperCar>(ARMOR_ID_INFANTRY_5);
     obj_[6] = make_shared<WrapperTower>(ARMOR_ID_TOWER);
     obj_[7] = make_shared<WrapperRune>(ARMOR_ID_RUNE);
+
+    config_ = getConfigSnapshot();
+
+    // 跟踪队列在 Delay 秒内未观测才清空，horizon 不能短于它，否则移出活跃集时滤波器状态仍未过期
+    auto param = Param::get_instance();
+    active_enabled_ = (*param)["Kalman"]["ActiveSet"]["Enable"];
+    active_horizon_ = (*param)["Kalman"]["ActiveSet"]["Horizon"];
+    if (config_ != nullptr && active_horizon_ < config_->track_delay) {
+        std::cout << "[GARAGE] ActiveSet.Horizon " << active_horizon_ << " 短于 TrackQueue.Delay "
+                  << config_->track_delay << "，按后者处理" << std::endl;
+        active_horizon_ = config_->track_delay;
+    }
+    active_last_ = vector<TimePoint>(obj_.size());
 }
 
 ObjPtr Garage::getObj(rm::ArmorID id) {
     int index = objmap[id];
-    return this->obj_[index];
-}
\ No newline at end of file
+    return std::atomic_load(&this->obj_[index]);
+}
+
+void Garage::markActive(rm::ArmorID id, TimePoint t) {
+    int index = objmap[id];
+    active_mask_ |= (1u << index);
+    active_last_[index] = t;
+}
+
+int Garage::updateActive(TimePoint t) {
+    int count = 0;
+    for (size_t i = 0; i < obj_.size(); i++) {
+        if (active_enabled_) {
+            if (!(active_mask_ & (1u << i))) continue;
+            if (getDoubleOfS(active_last_[i], t) > active_horizon_) {
+                active_mask_ &= ~(1u << i);
+                continue;
+            }
+        }
+        std::atomic_load(&obj_[i])->update();
+        count++;
+    }
+    return count;
+}
+
+static bool hasPrefix(const vector<string>& paths, initializer_list<const char*> prefixes) {
+    for (const auto& path : paths) {
+        for (const char* prefix : prefixes) {
+            if (path.compare(0, strlen(prefix), prefix) == 0) return true;
+        }
+    }
+    return false;
+}
+
+void Garage::applyConfig() {
+    ConfigPtr config = getConfigSnapshot();
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (config == config_ || config == nullptr) return;
+
+    vector<string> paths = diffConfigSnapshot(*config_, *config);
+    bool car = hasPrefix(paths, {"Kalman/TrackQueue/Count", "Kalman/TrackQueue/Distance", "Kalman/TrackQueue/Delay",
+                                 "Kalman/TrackQueue/Car", "Kalman/Antitop", "Kalman/Switch"});
+    bool tower = hasPrefix(paths, {"Kalman/TrackQueue/Count", "Kalman/TrackQueue/Distance", "Kalman/TrackQueue/Delay",
+                                   "Kalman/TrackQueue/Tower", "Kalman/Outpost"});
+    bool rune = hasPrefix(paths, {"Kalman/Rune"});
+    config_ = config;
+    if (!car && !tower && !rune) return;
+
+    // 新模型从空状态开始跟踪，旧对象在其他线程用完后释放
+    string rebuilt;
+    if (car) {
+        const ArmorID car_ids[6] = {ARMOR_ID_SENTRY, ARMOR_ID_HERO, ARMOR_ID_ENGINEER,
+                                    ARMOR_ID_INFANTRY_3, ARMOR_ID_INFANTRY_4, ARMOR_ID_INFANTRY_5};
+        for (int i = 0; i < 6; i++) std::atomic_store(&obj_[i], ObjPtr(make_shared<WrapperCar>(car_ids[i])));
+        rebuilt += " car";
+    }
+    if (tower) {
+        std::atomic_store(&obj_[6], ObjPtr(make_shared<WrapperTower>(ARMOR_ID_TOWER)));
+        rebuilt += " tower";
+    }
+    if (rune) {
+        std::atomic_store(&obj_[7], ObjPtr(make_shared<WrapperRune>(ARMOR_ID_RUNE)));
+        rebuilt += " rune";
+    }
+
+    double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - config->publish_time).count();
+    std::cout << "[CONFIG] v" << config->version << " garage 重建:" << rebuilt
+              << ", 发布到生效 " << latency << " ms" << std::endl;
+}
+
+void benchmarkGarageUpdate(int iterations) {
+    const ArmorID car_ids[6] = {ARMOR_ID_SENTRY, ARMOR_ID_HERO, ARMOR_ID_ENGINEER,
+                                ARMOR_ID_INFANTRY_3, ARMOR_ID_INFANTRY_4, ARMOR_ID_INFANTRY_5};
+
+    // 两组独立的模型分别按全量与活跃集更新，前 visible 个目标以 100 Hz 连续观测
+    for (int visible = 1; visible <= 6; visible++) {
+        vector<ObjPtr> full_objs, active_objs;
+        for (ArmorID id : car_ids) {
+            full_objs.push_back(make_shared<WrapperCar>(id));
+            active_objs.push_back(make_shared<WrapperCar>(id));
+        }
+        full_objs.push_back(make_shared<WrapperTower>(ARMOR_ID_TOWER));
+        active_objs.push_back(make_shared<WrapperTower>(ARMOR_ID_TOWER));
+        full_objs.push_back(make_shared<WrapperRune>(ARMOR_ID_RUNE));
+        active_objs.push_back(make_shared<WrapperRune>(ARMOR_ID_RUNE));
+
+        TimePoint t0 = getTime();
+        cv::TickMeter full_meter, active_meter;
+        for (int frame = 0; frame < iterations; frame++) {
+            TimePoint t = t0 + std::chrono::milliseconds(10 * frame);
+            for (int i = 0; i < visible; i++) {
+                double angle = 0.02 * frame + i;
+                Target target;
+                target.armor_id = car_ids[i];
+                target.armor_size = ARMOR_SIZE_SMALL_ARMOR;
+                target.pose_world = Eigen::Vector4d(3.0 + i + 0.25 * std::cos(angle), 0.25 * std::sin(angle), 0.2, 1.0);
+                target.armor_yaw_world = angle;
+                full_objs[i]->push(target, t);
+                active_objs[i]->push(target, t);
+            }
+
+            full_meter.start();
+            for (auto& obj : full_objs) obj->update();
+            full_meter.stop();
+
+            active_meter.start();
+            for (int i = 0; i < visible; i++) active_objs[i]->update();
+            active_meter.stop();
+        }
+
+        std::cout << "[GARAGE] 可见 " << visible << " 个目标 (" << iterations << " 次平均): 全量 "
+                  << full_meter.getTimeMicro() / iterations << " us, 活跃集 "
+                  << active_meter.getTimeMicro() / iterations << " us" << std::endl;
+    }
+}
+
+// 每次 update 把全部字段写成同一序号，读到不一致的字段即为撕裂
+struct ProbeModel {
+    uint64_t pending = 0;
+    uint64_t seq = 0;
+    double   values[64] = {};
+
+    void push(const Target&, TimePoint) { pending++; }
+    void update() {
+        seq += pending + 1;
+        pending = 0;
+        for (double& value : values) value = seq;
+    }
+};
+
+void stressGuardedModel(double seconds) {
+    const ArmorID car_ids[6] = {ARMOR_ID_SENTRY, ARMOR_ID_HERO, ARMOR_ID_ENGINEER,
+                                ARMOR_ID_INFANTRY_3, ARMOR_ID_INFANTRY_4, ARMOR_ID_INFANTRY_5};
+    auto run = [seconds](auto&& write, auto&& read) {
+        std::atomic<bool> stop{false};
+        uint64_t writes = 0;
+        std::thread writer([&]() {
+            while (!stop.load()) write(writes++);
+        });
+        uint64_t reads = 0;
+        double max_read = 0.0;
+        TimePoint start = getTime();
+        while (getDoubleOfS(start, getTime()) < seconds) {
+            TimePoint tp = getTime();
+            read();
+            max_read = std::max(max_read, getDoubleOfS(tp, getTime()) * 1e6);
+            reads++;
+        }
+        stop = true;
+        writer.join();
+        return std::make_tuple(writes, reads, max_read);
+    };
+
+    // 一致性: 读者只应看到完整发布的状态，且序号不回退
+    GuardedModel<ProbeModel> probe;
+    uint64_t last_seq = 0, torn = 0, backward = 0;
+    auto [probe_writes, probe_reads, probe_max] = run(
+        [&](uint64_t i) {
+            Target target;
+            for (uint64_t k = 0; k < i % 3; k++) probe.push(target, getTime());
+            probe.update();
+        },
+        [&]() {
+            probe.read([&](ProbeModel& model) {
+                for (double value : model.values) {
+                    if (value != (double)model.seq) { torn++; break; }
+                }
+                if (model.seq < last_seq) backward++;
+                last_seq = model.seq;
+            });
+        });
+    std::cout << "[GUARDED-MODEL] 一致性 " << seconds << " s: 写 " << probe_writes << " 次, 读 " << probe_reads
+              << " 次, 撕裂 " << torn << ", 回退 " << backward << ", 单次读最长 " << probe_max << " us" << std::endl;
+
+    // 满速: 跟踪线程连续 push / update，发送线程连续按发送循环的方式查询同一目标
+    WrapperCar car(car_ids[1]);
+    TimePoint t0 = getTime();
+    double max_wait = 0.0;
+    auto [car_writes, car_reads, car_max] = run(
+        [&](uint64_t i) {
+            double angle = 0.05 * i;
+            Target target;
+            target.armor_id = car_ids[1];
+            target.armor_size = ARMOR_SIZE_BIG_ARMOR;
+            target.pose_world = Eigen::Vector4d(4.0 + 0.25 * std::cos(angle), 0.25 * std::sin(angle), 0.2, 1.0);
+            target.armor_yaw_world = angle;
+            car.push(target, t0 + std::chrono::milliseconds(5 * i));
+            car.update();
+        },
+        [&]() {
+            // 空读取只含取锁，其耗时即发送端等待跟踪线程释放锁的时间
+            TimePoint tp = getTime();
+            car.model_.read([](CarModel&) {});
+            max_wait = std::max(max_wait, getDoubleOfS(tp, getTime()) * 1e6);
+
+            Eigen::Vector4d pose;
+            car.getTarget(pose, 0.0, 0.0, 0.0);
+            for (int i = 0; i < 3; i++) car.getTarget(pose, 0.3, 0.05, 0.05);
+        });
+    std::cout << "[GUARDED-MODEL] 满速 " << seconds << " s: 跟踪更新 " << car_writes << " 次, 发送查询 " << car_reads
+              << " 次, 单次查询最长 " << car_max << " us, 发送端最长等锁 " << max_wait << " us (发送周期 "
+              << Data::send_wait_time << " ms)" << std::endl;
+}
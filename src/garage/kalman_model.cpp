@@ -0,0 +1,443 @@
+#include "garage/kalman_model.h"
+#include "garage/wrapper_car.h"
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <fstream>
+
+static double wrapAngle(double angle) {
+    return std::remainder(angle, 2.0 * M_PI);
+}
+
+void TrackModel::predict(const Types::VectorN& x, double dt, Types::VectorN& x_next, Types::MatrixN& F) const {
+    double v = x(3), angle = x(5), w = x(6), a = x(7);
+    double c = std::cos(angle), s = std::sin(angle);
+
+    x_next = x;
+    x_next(0) += v * c * dt;
+    x_next(1) += v * s * dt;
+    x_next(2) += x(4) * dt;
+    x_next(3) += a * dt;
+    x_next(5) += w * dt;
+
+    F = Types::MatrixN::Identity();
+    F(0, 3) = c * dt;
+    F(0, 5) = -v * s * dt;
+    F(1, 3) = s * dt;
+    F(1, 5) = v * c * dt;
+    F(2, 4) = dt;
+    F(3, 7) = dt;
+    F(5, 6) = dt;
+}
+
+void TrackModel::measure(const Types::VectorN& x, Types::VectorM& z, Types::MatrixMN& H) const {
+    z = x.head<3>();
+    H = Types::MatrixMN::Zero();
+    H(0, 0) = H(1, 1) = H(2, 2) = 1.0;
+}
+
+// 配置中的 Q 视为各状态每秒的过程噪声方差
+void TrackModel::processNoise(double dt, Types::MatrixN& Q) const {
+    Q = Types::MatrixN::Zero();
+    for (int i = 0; i < 8; i++) Q(i, i) = q[i] * dt;
+}
+
+void TrackModel::measureNoise(const Types::VectorM&, Types::MatrixM& R) const {
+    R = Types::MatrixM::Zero();
+    for (int i = 0; i < 3; i++) R(i, i) = r[i];
+}
+
+void TrackModel::normalize(Types::VectorN& x) const {
+    // 速度保持非负，反向运动由航向角表示
+    if (x(3) < 0) {
+        x(3) = -x(3);
+        x(5) += M_PI;
+        x(7) = -x(7);
+    }
+    x(5) = wrapAngle(x(5));
+}
+
+void AntitopModel::predict(const Types::VectorN& x, double dt, Types::VectorN& x_next, Types::MatrixN& F) const {
+    x_next = x;
+    x_next(0) += x(4) * dt;
+    x_next(1) += x(5) * dt;
+    x_next(2) += x(6) * dt;
+    x_next(3) += x(7) * dt;
+
+    F = Types::MatrixN::Identity();
+    F(0, 4) = F(1, 5) = F(2, 6) = F(3, 7) = dt;
+}
+
+void AntitopModel::measure(const Types::VectorN& x, Types::VectorM& z, Types::MatrixMN& H) const {
+    double c = std::cos(x(3)), s = std::sin(x(3)), radius = x(8);
+    z << x(0) - radius * c, x(1) - radius * s, x(2), x(3);
+
+    H = Types::MatrixMN::Zero();
+    H(0, 0) = 1.0;
+    H(0, 3) = radius * s;
+    H(0, 8) = -c;
+    H(1, 1) = 1.0;
+    H(1, 3) = -radius * c;
+    H(1, 8) = -s;
+    H(2, 2) = 1.0;
+    H(3, 3) = 1.0;
+}
+
+void AntitopModel::processNoise(double dt, Types::MatrixN& Q) const {
+    Q = Types::MatrixN::Zero();
+    for (int i = 0; i < 9; i++) Q(i, i) = q[i] * dt;
+}
+
+void AntitopModel::measureNoise(const Types::VectorM&, Types::MatrixM& R) const {
+    R = Types::MatrixM::Zero();
+    for (int i = 0; i < 4; i++) R(i, i) = r[i];
+}
+
+AntitopModel::Types::VectorM AntitopModel::residual(const Types::VectorM& z, const Types::VectorM& z_pred) const {
+    Types::VectorM diff = z - z_pred;
+    diff(3) = wrapAngle(diff(3));
+    return diff;
+}
+
+void AntitopModel::normalize(Types::VectorN& x) const {
+    x(3) = wrapAngle(x(3));
+    x(8) = std::clamp(x(8), min_r, max_r);
+}
+
+static void initialTrackState(const TrackModel& model, const Eigen::Vector4d& pose,
+                              TrackModel::Types::VectorN& x, TrackModel::Types::MatrixN& P) {
+    x = TrackModel::Types::VectorN::Zero();
+    x.head<3>() = pose.head<3>();
+    P = TrackModel::Types::MatrixN::Identity() * 10.0;
+    for (int i = 0; i < 3; i++) P(i, i) = model.r[i];
+}
+
+static void initialAntitopState(const AntitopModel& model, const Eigen::Vector4d& pose,
+                                AntitopModel::Types::VectorN& x, AntitopModel::Types::MatrixN& P) {
+    double radius = 0.5 * (model.min_r + model.max_r);
+    x << pose(0) + radius * std::cos(pose(3)), pose(1) + radius * std::sin(pose(3)), pose(2), pose(3),
+         0, 0, 0, 0, radius;
+    P = AntitopModel::Types::MatrixN::Identity() * 10.0;
+    for (int i = 0; i < 4; i++) P(i, i) = model.r[i];
+    P(8, 8) = (model.max_r - model.min_r) * (model.max_r - model.min_r);
+}
+
+// 观测偏航与预测相差超过半个装甲板间隔时视为切换到相邻装甲板，把相位 theta 平移到该装甲板
+static bool armorJump(double yaw, double& theta, int armor_num) {
+    double step = 2.0 * M_PI / armor_num;
+    double jump = std::round(wrapAngle(yaw - theta) / step);
+    if (jump == 0) return false;
+    theta = wrapAngle(theta + jump * step);
+    return true;
+}
+
+TrackFilter::TrackFilter(const config::Vec8& q, const config::Vec3& r, double max_delay)
+    : ekf_(TrackModel{q, r}), max_delay_(max_delay) {}
+
+void TrackFilter::push(const Eigen::Vector4d& pose, TimePoint t) {
+    double dt = ekf_.initialized() ? getDoubleOfS(last_t_, t) : 0.0;
+    last_t_ = t;
+    last_yaw_ = pose(3);
+
+    if (!ekf_.initialized() || dt > max_delay_ || dt < 0) {
+        TrackModel::Types::VectorN x;
+        TrackModel::Types::MatrixN P;
+        initialTrackState(ekf_.model(), pose, x, P);
+        ekf_.init(x, P);
+        return;
+    }
+    if (dt > 0) ekf_.predict(dt);
+    ekf_.update(pose.head<3>());
+}
+
+bool TrackFilter::getPose(Eigen::Vector4d& pose, double delay) const {
+    if (!ekf_.initialized()) return false;
+    TrackModel::Types::VectorN x = ekf_.extrapolate(delay);
+    pose << x(0), x(1), x(2), last_yaw_;
+    return true;
+}
+
+AntitopFilter::AntitopFilter(
+    const config::Vec9& q, const config::Vec4& r, double min_r, double max_r, int armor_num, double max_delay
+) : ekf_(AntitopModel{q, r, min_r, max_r}), armor_num_(armor_num), max_delay_(max_delay) {}
+
+void AntitopFilter::push(const Eigen::Vector4d& pose, TimePoint t) {
+    double dt = ekf_.initialized() ? getDoubleOfS(last_t_, t) : 0.0;
+    last_t_ = t;
+
+    if (!ekf_.initialized() || dt > max_delay_ || dt < 0) {
+        AntitopModel::Types::VectorN x;
+        AntitopModel::Types::MatrixN P;
+        initialAntitopState(ekf_.model(), pose, x, P);
+        ekf_.init(x, P);
+        return;
+    }
+    if (dt > 0) ekf_.predict(dt);
+
+    double theta = ekf_.state()(3);
+    if (armorJump(pose(3), theta, armor_num_)) ekf_.mutableState()(3) = theta;
+    ekf_.update(pose);
+}
+
+Eigen::Vector4d AntitopFilter::getCenter(double delay) const {
+    AntitopModel::Types::VectorN x = ekf_.extrapolate(delay);
+    return Eigen::Vector4d(x(0), x(1), x(2), x(3));
+}
+
+Eigen::Vector4d AntitopFilter::getPose(double delay) const {
+    AntitopModel::Types::VectorN x = ekf_.extrapolate(delay);
+    AntitopModel::Types::VectorM z;
+    AntitopModel::Types::MatrixMN H;
+    ekf_.model().measure(x, z, H);
+    return Eigen::Vector4d(z(0), z(1), z(2), z(3));
+}
+
+TrackBank::TrackBank(const config::Vec8& q, const config::Vec3& r, double max_delay)
+    : bank_(TrackModel{q, r}), max_delay_(max_delay) {}
+
+void TrackBank::push(int slot, const Eigen::Vector4d& pose, TimePoint t) {
+    // 同一槽位在 flush 前再次观测时先结算上一次
+    if (bank_.staged(slot)) bank_.flush();
+
+    double dt = bank_.initialized(slot) ? getDoubleOfS(last_t_[slot], t) : 0.0;
+    last_t_[slot] = t;
+    last_yaw_[slot] = pose(3);
+
+    if (!bank_.initialized(slot) || dt > max_delay_ || dt < 0) {
+        TrackModel::Types::VectorN x;
+        TrackModel::Types::MatrixN P;
+        initialTrackState(bank_.model(), pose, x, P);
+        bank_.init(slot, x, P);
+        return;
+    }
+    bank_.stage(slot, pose.head<3>(), dt);
+}
+
+bool TrackBank::getPose(int slot, Eigen::Vector4d& pose, double delay) const {
+    if (!bank_.initialized(slot)) return false;
+    TrackModel::Types::VectorN x_next;
+    TrackModel::Types::MatrixN F;
+    bank_.model().predict(bank_.state(slot), delay, x_next, F);
+    pose << x_next(0), x_next(1), x_next(2), last_yaw_[slot];
+    return true;
+}
+
+AntitopBank::AntitopBank(const config::Vec9& q, const config::Vec4& r, double min_r, double max_r, double max_delay)
+    : bank_(AntitopModel{q, r, min_r, max_r}), max_delay_(max_delay) {}
+
+void AntitopBank::push(int slot, const Eigen::Vector4d& pose, TimePoint t, int armor_num) {
+    if (bank_.staged(slot)) bank_.flush();
+
+    double dt = bank_.initialized(slot) ? getDoubleOfS(last_t_[slot], t) : 0.0;
+    last_t_[slot] = t;
+
+    if (!bank_.initialized(slot) || dt > max_delay_ || dt < 0) {
+        AntitopModel::Types::VectorN x;
+        AntitopModel::Types::MatrixN P;
+        initialAntitopState(bank_.model(), pose, x, P);
+        bank_.init(slot, x, P);
+        return;
+    }
+
+    // 相位平移与匀速预测可交换，先按预测相位判断装甲板切换再登记
+    double& theta = bank_.stateAt(slot, 3);
+    double predicted = wrapAngle(theta + bank_.stateAt(slot, 7) * dt);
+    if (armorJump(pose(3), predicted, armor_num)) {
+        theta = wrapAngle(predicted - bank_.stateAt(slot, 7) * dt);
+    }
+    bank_.stage(slot, pose, dt);
+}
+
+Eigen::Vector4d AntitopBank::getCenter(int slot, double delay) const {
+    AntitopModel::Types::VectorN x_next;
+    AntitopModel::Types::MatrixN F;
+    bank_.model().predict(bank_.state(slot), delay, x_next, F);
+    bank_.model().normalize(x_next);
+    return Eigen::Vector4d(x_next(0), x_next(1), x_next(2), x_next(3));
+}
+
+// 读取录制的观测: 每行 <ID> <秒> <x> <y> <z> <yaw>，只取第一条观测所属目标的序列
+static std::vector<KalmanPush> loadKalmanPushes(const std::string& path) {
+    std::vector<KalmanPush> pushes;
+    std::ifstream in(path);
+    int first_id = -1, id;
+    KalmanPush push;
+    while (in >> id >> push.t >> push.pose(0) >> push.pose(1) >> push.pose(2) >> push.pose(3)) {
+        if (first_id < 0) first_id = id;
+        if (id == first_id) pushes.push_back(push);
+    }
+    return pushes;
+}
+
+// 合成: 中心匀速平移、0.8 转每秒的四装甲板小陀螺，100 Hz 观测最朝向相机的装甲板
+static std::vector<KalmanPush> makeKalmanPushes() {
+    cv::RNG rng(0x5eed);
+    const double omega = 2.0 * M_PI * 0.8, radius = 0.25;
+    std::vector<KalmanPush> pushes;
+    for (int i = 0; i < 300; i++) {
+        double t = 0.01 * i;
+        Eigen::Vector3d center(4.0 + 0.3 * t, 0.5 - 0.2 * t, 0.1);
+        double facing = std::atan2(center.y(), center.x());
+        double theta = omega * t;
+        double best = theta;
+        for (int k = 1; k < 4; k++) {
+            double candidate = theta + k * M_PI / 2;
+            if (std::fabs(wrapAngle(candidate - facing)) < std::fabs(wrapAngle(best - facing))) best = candidate;
+        }
+        best = wrapAngle(best);
+        KalmanPush push;
+        push.pose << center.x() - radius * std::cos(best) + rng.gaussian(0.01),
+                     center.y() - radius * std::sin(best) + rng.gaussian(0.01),
+                     center.z() + rng.gaussian(0.005), best + rng.gaussian(0.02);
+        push.t = t;
+        pushes.push_back(push);
+    }
+    return pushes;
+}
+
+void benchmarkKalman(int iterations) {
+    ConfigPtr config = getConfigSnapshot();
+    auto param = Param::get_instance();
+    std::string push_log = (*param)["Kalman"]["PushLog"];
+
+    std::vector<KalmanPush> pushes = loadKalmanPushes(push_log);
+    bool recorded = !pushes.empty();
+    if (!recorded) pushes = makeKalmanPushes();
+
+    // 回放: 同一观测序列送入树内滤波与 OpenRM，逐帧比较平动跟踪位置，结束时比较角速度与旋转中心
+    cv::TickMeter intree_meter, openrm_meter;
+    double track_diff = 0, omega_diff = 0, center_diff = 0;
+    const int warmup = 20;
+    for (int it = 0; it < iterations; it++) {
+        TrackFilter track(config->track_car_q, config->track_car_r, config->track_delay);
+        AntitopFilter antitop(config->antitop_q, config->antitop_r, config->antitop_min_r, config->antitop_max_r, 4, config->track_delay);
+        WrapperCar car(rm::ARMOR_ID_HERO);
+        TimePoint t0 = getTime();
+
+        for (size_t i = 0; i < pushes.size(); i++) {
+            const KalmanPush& push = pushes[i];
+            TimePoint t = t0 + std::chrono::microseconds((int64_t)((push.t - pushes[0].t) * 1e6));
+            rm::Target target;
+            target.armor_id = rm::ARMOR_ID_HERO;
+            target.armor_size = rm::ARMOR_SIZE_BIG_ARMOR;
+            target.pose_world = Eigen::Vector4d(push.pose(0), push.pose(1), push.pose(2), 1.0);
+            target.armor_yaw_world = push.pose(3);
+
+            intree_meter.start();
+            track.push(push.pose, t);
+            antitop.push(push.pose, t);
+            intree_meter.stop();
+
+            openrm_meter.start();
+            car.push(target, t);
+            car.update();
+            openrm_meter.stop();
+
+            if (it != 0 || (int)i < warmup) continue;
+            Eigen::Vector4d intree_pose;
+            if (!track.getPose(intree_pose, 0.0)) continue;
+            car.model_.read([&](CarModel& model) {
+                Eigen::Vector4d openrm_pose = model.track_queue_.getPose(0.0);
+                track_diff = std::max(track_diff, (intree_pose.head<3>() - openrm_pose.head<3>()).norm());
+            });
+        }
+
+        if (it == 0) {
+            car.model_.read([&](CarModel& model) {
+                omega_diff = std::fabs(std::fabs(antitop.getOmega()) - std::fabs(model.antitop_4_->getOmega()));
+                center_diff = (antitop.getCenter(0.0).head<2>() - model.antitop_4_->getCenter(0.0).head<2>()).norm();
+            });
+        }
+    }
+
+    int count = iterations * pushes.size();
+    std::cout << "[KALMAN] " << (recorded ? "录制观测 " + push_log : std::string("合成观测")) << ", " << pushes.size()
+              << " 帧" << std::endl;
+    std::cout << "[KALMAN] 单次更新 (" << count << " 次平均): 树内 " << intree_meter.getTimeMicro() / count
+              << " us, OpenRM " << openrm_meter.getTimeMicro() / count << " us" << std::endl;
+    std::cout << "[KALMAN] 与 OpenRM 的差: 跟踪位置最大 " << track_diff << " m, 角速度 " << omega_diff
+              << " rad/s, 旋转中心 " << center_diff << " m" << std::endl;
+}
+
+void benchmarkFilterBank(int iterations) {
+    ConfigPtr config = getConfigSnapshot();
+    cv::RNG rng(0x5eed);
+
+    // 录制: 每个目标中心与转速不同的四装甲板小陀螺，100 Hz 观测最朝向相机的装甲板
+    const int frames = 300;
+    std::vector<std::vector<Eigen::Vector4d>> record(AntitopBank::kCapacity);
+    for (int k = 0; k < AntitopBank::kCapacity; k++) {
+        double omega = 2.0 * M_PI * (0.4 + 0.1 * k), radius = 0.2 + 0.01 * k;
+        for (int i = 0; i < frames; i++) {
+            double t = 0.01 * i;
+            Eigen::Vector3d center(3.0 + 0.3 * k + 0.2 * t, -2.0 + 0.25 * k, 0.1);
+            double facing = std::atan2(center.y(), center.x());
+            double theta = omega * t + k;
+            double best = theta;
+            for (int j = 1; j < 4; j++) {
+                double candidate = theta + j * M_PI / 2;
+                if (std::fabs(wrapAngle(candidate - facing)) < std::fabs(wrapAngle(best - facing))) best = candidate;
+            }
+            best = wrapAngle(best);
+            record[k].emplace_back(center.x() - radius * std::cos(best) + rng.gaussian(0.01),
+                                   center.y() - radius * std::sin(best) + rng.gaussian(0.01),
+                                   center.z() + rng.gaussian(0.005), best + rng.gaussian(0.02));
+        }
+    }
+
+    for (int count : {1, 2, 4, 8, 16}) {
+        cv::TickMeter single_meter, bank_meter, track_single_meter, track_bank_meter;
+        double omega_diff = 0, center_diff = 0, track_diff = 0;
+        for (int it = 0; it < iterations; it++) {
+            std::vector<AntitopFilter> singles(count, AntitopFilter(
+                config->antitop_q, config->antitop_r, config->antitop_min_r, config->antitop_max_r, 4, config->track_delay));
+            auto bank = std::make_unique<AntitopBank>(
+                config->antitop_q, config->antitop_r, config->antitop_min_r, config->antitop_max_r, config->track_delay);
+            std::vector<TrackFilter> track_singles(count, TrackFilter(config->track_car_q, config->track_car_r, config->track_delay));
+            auto track_bank = std::make_unique<TrackBank>(config->track_car_q, config->track_car_r, config->track_delay);
+            TimePoint t0 = getTime();
+
+            for (int i = 0; i < frames; i++) {
+                TimePoint t = t0 + std::chrono::milliseconds(10 * i);
+
+                single_meter.start();
+                for (int k = 0; k < count; k++) singles[k].push(record[k][i], t);
+                single_meter.stop();
+
+                bank_meter.start();
+                for (int k = 0; k < count; k++) bank->push(k, record[k][i], t, 4);
+                bank->flush();
+                bank_meter.stop();
+
+                track_single_meter.start();
+                for (int k = 0; k < count; k++) track_singles[k].push(record[k][i], t);
+                track_single_meter.stop();
+
+                track_bank_meter.start();
+                for (int k = 0; k < count; k++) track_bank->push(k, record[k][i], t);
+                track_bank->flush();
+                track_bank_meter.stop();
+            }
+
+            if (it == 0) {
+                for (int k = 0; k < count; k++) {
+                    omega_diff = std::max(omega_diff, std::fabs(singles[k].getOmega() - bank->getOmega(k)));
+                    center_diff = std::max(center_diff, (singles[k].getCenter(0.0) - bank->getCenter(k, 0.0)).head<3>().norm());
+                    Eigen::Vector4d single_pose, bank_pose;
+                    if (track_singles[k].getPose(single_pose, 0.0) && track_bank->getPose(k, bank_pose, 0.0)) {
+                        track_diff = std::max(track_diff, (single_pose - bank_pose).head<3>().norm());
+                    }
+                }
+            }
+        }
+
+        int updates = iterations * frames * count;
+        std::cout << "[FILTER-BANK] " << count << " 个目标 (" << iterations << " 次平均): 小陀螺 逐目标 "
+                  << single_meter.getTimeMicro() / updates << " us/目标, SoA "
+                  << bank_meter.getTimeMicro() / updates << " us/目标, 角速度差 " << omega_diff
+                  << " rad/s, 中心差 " << center_diff << " m; 平动 逐目标 "
+                  << track_single_meter.getTimeMicro() / updates << " us/目标, SoA "
+                  << track_bank_meter.getTimeMicro() / updates << " us/目标, 位置差 " << track_diff
+                  << " m" << std::endl;
+    }
+}
@@ -1,46 +1,30 @@
 #include "garage/wrapper_car.h"
+#include "data_manager/config.h"
 using namespace rm;
 using namespace std;
 
-WrapperCar::WrapperCar(ArmorID id) : ObjInterface(id) {
-    this->id_ = id;
-    auto param = Param::get_instance();
-
-    double track_count = (*param)["Kalman"]["TrackQueue"]["Count"];
-    double track_dist = (*param)["Kalman"]["TrackQueue"]["Distance"];
-    double track_delay = (*param)["Kalman"]["TrackQueue"]["Delay"];
-
-    double antitop_min_r = (*param)["Kalman"]["Antitop"]["MinR"];
-    double antitop_max_r = (*param)["Kalman"]["Antitop"]["MaxR"];
-
-    int antitop_fire_update = (*param)["Kalman"]["Antitop"]["FireUpdate"];
-    double antitop_fire_delay = (*param)["Kalman"]["Antitop"]["FireDelay"];
-    double antitop_fire_angle = (*param)["Kalman"]["Antitop"]["FireAngle"]["Armor"];
-    double antitop_fire_angle_big_ = (*param)["Kalman"]["Antitop"]["FireAngle"]["CenterBig"];
-    double antitop_fire_angle_small_ = (*param)["Kalman"]["Antitop"]["FireAngle"]["CenterSmall"];
-
-    vector<double> antitopQ = (*param)["Kalman"]["Antitop"]["Q"];
-    vector<double> antitopR = (*param)["Kalman"]["Antitop"]["R"];
-    vector<double> antitopCenterQ = (*param)["Kalman"]["Antitop"]["CenterQ"];
-    vector<double> antitopCenterR = (*param)["Kalman"]["Antitop"]["CenterR"];
+CarModel::CarModel(ArmorID id, const ConfigPtr& config) : id_(id) {
+    const auto& antitopQ = config->antitop_q;
+    const auto& antitopR = config->antitop_r;
+    const auto& antitopCenterQ = config->antitop_center_q;
+    const auto& antitopCenterR = config->antitop_center_r;
 
-    vector<double> antitopOmegaQ = (*param)["Kalman"]["Antitop"]["OmegaQ"];
-    vector<double> antitopOmegaR = (*param)["Kalman"]["Antitop"]["OmegaR"];
-    vector<double> antitopBalanceOmegaQ = (*param)["Kalman"]["Antitop"]["BalanceOmegaQ"];
-    vector<double> antitopBalanceOmegaR = (*param)["Kalman"]["Antitop"]["BalanceOmegaR"];
+    const auto& antitopOmegaQ = config->antitop_omega_q;
+    const auto& antitopBalanceOmegaQ = config->antitop_balance_omega_q;
+    const auto& antitopBalanceOmegaR = config->antitop_balance_omega_r;
 
-    vector<double> trackqueueQ = (*param)["Kalman"]["TrackQueue"]["CarQ"];
-    vector<double> trackqueueR = (*param)["Kalman"]["TrackQueue"]["CarR"];
+    const auto& trackqueueQ = config->track_car_q;
+    const auto& trackqueueR = config->track_car_r;
 
-    track_to_antitop_ = (*param)["Kalman"]["Switch"]["TrackToAntitop"];
-    antitop_to_track_ = (*param)["Kalman"]["Switch"]["AntitopToTrack"];
+    int antitop_fire_update = config->antitop_fire_update;
+    double antitop_fire_delay = config->antitop_fire_delay;
+    double antitop_fire_angle = config->antitop_fire_angle;
+    double antitop_fire_angle_big_ = config->antitop_fire_angle_big;
+    double antitop_fire_angle_small_ = config->antitop_fire_angle_small;
 
-    armor_to_center_ = (*param)["Kalman"]["Switch"]["ArmorToCenter"];
-    center_to_armor_ = (*param)["Kalman"]["Switch"]["CenterToArmor"];
-
-    track_queue_ = TrackQueueV4(track_count, track_dist, track_delay);
-    antitop_4_ = new AntitopV3(antitop_min_r, antitop_max_r, 4);
-    antitop_2_ = new AntitopV3(antitop_min_r, antitop_max_r, 2);
+    track_queue_ = TrackQueueV4(config->track_count, config->track_dist, config->track_delay);
+    antitop_4_ = new AntitopV3(config->antitop_min_r, config->antitop_max_r, 4);
+    antitop_2_ = new AntitopV3(config->antitop_min_r, config->antitop_max_r, 2);
 
     track_queue_.setMatrixQ(
         trackqueueQ[0], trackqueueQ[1], trackqueueQ[2], trackqueueQ[3], trackqueueQ[4], trackqueueQ[5],
@@ -79,7 +63,7 @@ WrapperCar::WrapperCar(ArmorID id) : ObjInterface(id) {
 
 }
 
-void WrapperCar::push(const Target& target, TimePoint t) {
+void CarModel::push(const Target& target, TimePoint t) {
     Eigen::Vector4d pose(
         target.pose_world[0], target.pose_world[1], target.pose_world[2], target.armor_yaw_world
     );
@@ -89,10 +73,9 @@ void WrapperCar::push(const Target& target, TimePoint t) {
     if (target.armor_size == ARMOR_SIZE_BIG_ARMOR) {
         armor_size_count_ += 1;
     }
-    
 }
 
-void WrapperCar::update() {
+void CarModel::update() {
     track_queue_.update();
 
     if (curr_armor_num_ > 1) {
@@ -104,79 +87,76 @@ void WrapperCar::update() {
     TimePoint t;
     if (!track_queue_.getPose(pose, t)) return;
 
-    rm::AntitopV3* antitop = nullptr;
-    if (id_ == rm::ARMOR_ID_INFANTRY_3 || id_ == rm::ARMOR_ID_INFANTRY_4 || id_ == rm::ARMOR_ID_INFANTRY_5) {
+    rm::message("antitop armor", balance() ? 2 : 4);
+    antitop()->push(pose, t);
+}
 
-        if (armor_size_count_ > 0) {
-            antitop = antitop_2_;
-            rm::message("antitop armor", 2);
-        }
-        else {
-            antitop = antitop_4_;
-            rm::message("antitop armor", 4);
-        }
-    } else {
-        antitop = antitop_4_;
-        rm::message("antitop armor", 4);
+bool CarModel::balance() const {
+    if (id_ == rm::ARMOR_ID_INFANTRY_3 || id_ == rm::ARMOR_ID_INFANTRY_4 || id_ == rm::ARMOR_ID_INFANTRY_5) {
+        return armor_size_count_ > 0;
     }
+    return false;
+}
+
+WrapperCar::WrapperCar(ArmorID id) : ObjInterface(id), model_(id, getConfigSnapshot()) {
+    this->id_ = id;
+    ConfigPtr config = getConfigSnapshot();
 
-    antitop->push(pose, t);
+    track_to_antitop_ = config->switch_track_to_antitop;
+    antitop_to_track_ = config->switch_antitop_to_track;
+
+    armor_to_center_ = config->switch_armor_to_center;
+    center_to_armor_ = config->switch_center_to_armor;
 }
 
-bool WrapperCar::getTarget(Eigen::Vector4d& pose_rotate, const double fly_delay, const double rotate_delay, const double shoot_delay) {
-    rm::AntitopV3* antitop = nullptr;
+void WrapperCar::push(const Target& target, TimePoint t) {
+    model_.push(target, t);
+    last_t_ = t;
+    last_yaw_ = target.armor_yaw_world;
+}
 
-    if (id_ == rm::ARMOR_ID_INFANTRY_3 || id_ == rm::ARMOR_ID_INFANTRY_4 || id_ == rm::ARMOR_ID_INFANTRY_5) {
+void WrapperCar::update() {
+    model_.update();
+}
 
-        if (armor_size_count_ > 0) {
-            antitop = antitop_2_;
-            rm::message("antitop armor", 2);
-        }
-        else {
-            antitop = antitop_4_;
-            rm::message("antitop armor", 4);
-        }
-    } else {
-        antitop = antitop_4_;
-        rm::message("antitop armor", 4);
-    }
+bool WrapperCar::getTarget(Eigen::Vector4d& pose_rotate, const double fly_delay, const double rotate_delay, const double shoot_delay) {
+    return model_.read([&](CarModel& model) -> bool {
+        rm::AntitopV3* antitop = model.antitop();
 
+        Eigen::Vector4d pose_shoot = model.track_queue_.getPose(fly_delay + shoot_delay);
+        pose_rotate = model.track_queue_.getPose(fly_delay + rotate_delay);
 
-    Eigen::Vector4d pose_shoot = track_queue_.getPose(fly_delay + shoot_delay);
-    pose_rotate = track_queue_.getPose(fly_delay + rotate_delay);
+        Data::target_omega = antitop->getOmega();
+        rm::message("target omg", Data::target_omega);
 
-    Data::target_omega = antitop->getOmega();
-    rm::message("target omg", Data::target_omega);
 
+        if(abs(Data::target_omega) > track_to_antitop_) flag_antitop_ = true;
+        else if(abs(Data::target_omega) < antitop_to_track_) flag_antitop_ = false; 
 
-    if(abs(Data::target_omega) > track_to_antitop_) flag_antitop_ = true;
-    else if(abs(Data::target_omega) < antitop_to_track_) flag_antitop_ = false; 
+        if(abs(Data::target_omega) > armor_to_center_) flag_center_ = true;
+        else if(abs(Data::target_omega) < center_to_armor_) flag_center_ = false;
 
-    if(abs(Data::target_omega) > armor_to_center_) flag_center_ = true;
-    else if(abs(Data::target_omega) < center_to_armor_) flag_center_ = false;
+        if (flag_antitop_) {
+            if(flag_center_) {
+                rm::message("mode", 'C');
+                pose_shoot = antitop->getCenter(fly_delay + shoot_delay);
+                pose_rotate = antitop->getCenter(fly_delay + rotate_delay);
+                return antitop->getFireCenter(pose_shoot);
+            } else {
+                rm::message("mode", 'A');
+                pose_shoot = antitop->getPose(fly_delay + shoot_delay);
+                pose_rotate = antitop->getPose(fly_delay + rotate_delay);
 
-    if (flag_antitop_) {
-        if(flag_center_) {
-            rm::message("mode", 'C');
-            pose_shoot = antitop->getCenter(fly_delay + shoot_delay);
-            pose_rotate = antitop->getCenter(fly_delay + rotate_delay);
-            return antitop->getFireCenter(pose_shoot);
+                return antitop->getFireArmor(pose_shoot);
+            }      
         } else {
-            rm::message("mode", 'A');
-            pose_shoot = antitop->getPose(fly_delay + shoot_delay);
-            pose_rotate = antitop->getPose(fly_delay + rotate_delay);
-
-            return antitop->getFireArmor(pose_shoot);
-        }      
-    } else {
-        rm::message("mode", 'T');
-        return true;
-    }
-    
+            rm::message("mode", 'T');
+            return true;
+        }
+    });
 }
 
 rm::ArmorSize WrapperCar::getArmorSize() {
-    double abs_big, abs_small;
     switch (id_) {
         case rm::ARMOR_ID_SENTRY:
             size_ = rm::ARMOR_SIZE_SMALL_ARMOR;
@@ -190,7 +170,7 @@ rm::ArmorSize WrapperCar::getArmorSize() {
         case rm::ARMOR_ID_INFANTRY_4:
         case rm::ARMOR_ID_INFANTRY_5:
 
-            if (armor_size_count_ > 0) {
+            if (model_.read([](CarModel& model) { return model.armor_size_count_ > 0; })) {
                 size_ = rm::ARMOR_SIZE_BIG_ARMOR;
                 return rm::ARMOR_SIZE_BIG_ARMOR;
             } else {
@@ -207,9 +187,8 @@ rm::ArmorSize WrapperCar::getArmorSize() {
 void WrapperCar::getState(std::vector<std::string>& lines) {
     lines.clear();
 
-    if (id_ == rm::ARMOR_ID_INFANTRY_3 || id_ == rm::ARMOR_ID_INFANTRY_4 || id_ == rm::ARMOR_ID_INFANTRY_5) {
-        if (armor_size_count_ > 0) antitop_2_->getStateStr(lines);
-        else antitop_4_->getStateStr(lines);
-    } else antitop_4_->getStateStr(lines);
-    track_queue_.getStateStr(lines);
-}
\ No newline at end of file
+    model_.read([&](CarModel& model) {
+        model.antitop()->getStateStr(lines);
+        model.track_queue_.getStateStr(lines);
+    });
+}
@@ -1,31 +1,20 @@
 #include "garage/wrapper_tower.h"
+#include "data_manager/config.h"
 using namespace rm;
 using namespace std;
 
 
-WrapperTower::WrapperTower(ArmorID id) : ObjInterface(id) {
-    id_ = id;
-    size_ = ARMOR_SIZE_BIG_ARMOR;
-    auto param = Param::get_instance();
-
-    double track_count = (*param)["Kalman"]["TrackQueue"]["Count"];
-    double track_dist = (*param)["Kalman"]["TrackQueue"]["Distance"];
-    double track_delay = (*param)["Kalman"]["TrackQueue"]["Delay"];
-    int outpost_fire_update = (*param)["Kalman"]["Outpost"]["FireUpdate"];
-    double outpost_fire_delay = (*param)["Kalman"]["Outpost"]["FireDelay"];
-    double outpost_fire_angle = (*param)["Kalman"]["Outpost"]["FireAngle"]["Armor"];
-    double outpost_fire_angle_small_ = (*param)["Kalman"]["Outpost"]["FireAngle"]["Center"];
-    
-    vector<double> outpostQ = (*param)["Kalman"]["Outpost"]["Q"];
-    vector<double> outpostR = (*param)["Kalman"]["Outpost"]["R"];
+TowerModel::TowerModel(const ConfigPtr& config) {
+    const auto& outpostQ = config->outpost_q;
+    const auto& outpostR = config->outpost_r;
 
-    vector<double> outpostOmegaQ = (*param)["Kalman"]["Outpost"]["OmegaQ"];
-    vector<double> outpostOmegaR = (*param)["Kalman"]["Outpost"]["OmegaR"];
+    const auto& outpostOmegaQ = config->outpost_omega_q;
+    const auto& outpostOmegaR = config->outpost_omega_r;
     
-    vector<double> trackqueueQ = (*param)["Kalman"]["TrackQueue"]["TowerQ"];
-    vector<double> trackqueueR = (*param)["Kalman"]["TrackQueue"]["TowerR"];
+    const auto& trackqueueQ = config->track_tower_q;
+    const auto& trackqueueR = config->track_tower_r;
 
-    track_queue_ = TrackQueueV3(track_count, track_dist, track_delay);
+    track_queue_ = TrackQueueV3(config->track_count, config->track_dist, config->track_delay);
     track_queue_.setMatrixQ(
         trackqueueQ[0], trackqueueQ[1], trackqueueQ[2], trackqueueQ[3], trackqueueQ[4], trackqueueQ[5],
         trackqueueQ[6], trackqueueQ[7], trackqueueQ[8], trackqueueQ[9], trackqueueQ[10]);
@@ -44,18 +33,19 @@ WrapperTower::WrapperTower(ArmorID id) : ObjInterface(id) {
     outpost_.setMatrixR(outpostR[0], outpostR[1], outpostR[2], outpostR[3]);
     outpost_.setMatrixOmegaQ(outpostOmegaQ[0], outpostOmegaQ[1]);
     outpost_.setMatrixOmegaR(outpostOmegaR[0]);
-    outpost_.setFireValue(outpost_fire_update, outpost_fire_delay, outpost_fire_angle, outpost_fire_angle_small_);
+    outpost_.setFireValue(
+        config->outpost_fire_update, config->outpost_fire_delay, config->outpost_fire_angle, config->outpost_fire_angle_center);
 
 }
 
-void WrapperTower::push(const Target& target, TimePoint t) {
+void TowerModel::push(const Target& target, TimePoint t) {
     Eigen::Vector4d pose(
         target.pose_world[0], target.pose_world[1], target.pose_world[2], target.armor_yaw_world
     );
     track_queue_.push(pose, t);
 }
 
-void WrapperTower::update() {
+void TowerModel::update() {
     track_queue_.update();
 
     Eigen::Vector4d pose;
@@ -65,43 +55,59 @@ void WrapperTower::update() {
     outpost_.push(pose,t);
 }
 
-bool WrapperTower::getTarget(Eigen::Vector4d& pose_rotate, const double fly_delay, const double rotate_delay, const double shoot_delay) {
-    
-    pose_rotate = track_queue_.getPose(fly_delay + rotate_delay);
-    Eigen::Vector4d pose_shoot = track_queue_.getPose(fly_delay + shoot_delay);
-
-    Data::target_omega = outpost_.getOmega();
-    rm::message("target omg", Data::target_omega);
-
-    #if defined(TJURM_INFANTRY) || defined(TJURM_BALANCE)
-    if (Data::state == 0) {
-        rm::message("mode", 'T');
-        return track_queue_.getFireFlag();
-    } else if (Data::state == 1) {
-        rm::message("mode", 'A');
-        pose_shoot = outpost_.getPose(fly_delay + shoot_delay);
-        pose_rotate = outpost_.getPose(fly_delay + rotate_delay);
-        return outpost_.getFireArmor(pose_shoot);
-    }
-    #endif
+WrapperTower::WrapperTower(ArmorID id) : ObjInterface(id), model_(getConfigSnapshot()) {
+    id_ = id;
+    size_ = ARMOR_SIZE_BIG_ARMOR;
+}
 
-    #if defined(TJURM_DRONSE) || defined(TJURM_SENTRY)
-    rm::message("mode", 'A');
-    pose_shoot = outpost_.getPose(fly_delay + shoot_delay);
-    pose_rotate = outpost_.getPose(fly_delay + rotate_delay);
-    return outpost_.getFireArmor(pose_shoot);
-    #endif
+void WrapperTower::push(const Target& target, TimePoint t) {
+    model_.push(target, t);
+    last_t_ = t;
+    last_yaw_ = target.armor_yaw_world;
+}
 
-    #ifdef TJURM_HERO
-    if (Data::state == 1) {
-        rm::message("mode", 'C');
-        pose_shoot = outpost_.getCenter(fly_delay + shoot_delay);
-        pose_rotate = outpost_.getCenter(0.0);
-        return outpost_.getFireCenter(pose_shoot);
-    }
-    #endif
+void WrapperTower::update() {
+    model_.update();
+}
 
-    return track_queue_.getFireFlag();
+bool WrapperTower::getTarget(Eigen::Vector4d& pose_rotate, const double fly_delay, const double rotate_delay, const double shoot_delay) {
+    return model_.read([&](TowerModel& model) -> bool {
+        pose_rotate = model.track_queue_.getPose(fly_delay + rotate_delay);
+        Eigen::Vector4d pose_shoot = model.track_queue_.getPose(fly_delay + shoot_delay);
+
+        Data::target_omega = model.outpost_.getOmega();
+        rm::message("target omg", Data::target_omega);
+
+        #if defined(TJURM_INFANTRY) || defined(TJURM_BALANCE)
+        if (Data::state == 0) {
+            rm::message("mode", 'T');
+            return model.track_queue_.getFireFlag();
+        } else if (Data::state == 1) {
+            rm::message("mode", 'A');
+            pose_shoot = model.outpost_.getPose(fly_delay + shoot_delay);
+            pose_rotate = model.outpost_.getPose(fly_delay + rotate_delay);
+            return model.outpost_.getFireArmor(pose_shoot);
+        }
+        #endif
+
+        #if defined(TJURM_DRONSE) || defined(TJURM_SENTRY)
+        rm::message("mode", 'A');
+        pose_shoot = model.outpost_.getPose(fly_delay + shoot_delay);
+        pose_rotate = model.outpost_.getPose(fly_delay + rotate_delay);
+        return model.outpost_.getFireArmor(pose_shoot);
+        #endif
+
+        #ifdef TJURM_HERO
+        if (Data::state == 1) {
+            rm::message("mode", 'C');
+            pose_shoot = model.outpost_.getCenter(fly_delay + shoot_delay);
+            pose_rotate = model.outpost_.getCenter(0.0);
+            return model.outpost_.getFireCenter(pose_shoot);
+        }
+        #endif
+
+        return model.track_queue_.getFireFlag();
+    });
 }
 
 rm::ArmorSize WrapperTower::getArmorSize() {
@@ -110,6 +116,8 @@ rm::ArmorSize WrapperTower::getArmorSize() {
 
 void WrapperTower::getState(std::vector<std::string>& lines) {
     lines.clear();
-    outpost_.getStateStr(lines);
-    track_queue_.getStateStr(lines);
+    model_.read([&](TowerModel& model) {
+        model.outpost_.getStateStr(lines);
+        model.track_queue_.getStateStr(lines);
+    });
 }
\ No newline at end of file
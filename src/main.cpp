@@ -1,5 +1,8 @@
 #include "data_manager/base.h"
 #include "data_manager/param.h"
+#include "data_manager/config.h"
+#include "data_manager/startup.h"
+#include "data_manager/alloc_counter.h"
 #include "threads/pipeline.h"
 #include "threads/control.h"
 #include "garage/garage.h"
@@ -84,6 +87,8 @@ void signal_handler(int signum) {
 }
 
 int main(int argc, char** argv) {
+    initAllocCounter();
+
     // 注册信号处理
     struct sigaction sa;
     sa.sa_handler = signal_handler;
@@ -100,46 +105,105 @@ int main(int argc, char** argv) {
     XInitThreads();
     
     auto param = Param::get_instance();
+
+    // 配置快照须先于 Garage 构造，其中各目标模型的参数由快照读取
+    if (!initConfigSnapshot()) return 1;
+
     auto pipeline = Pipeline::get_instance();
     auto garage = Garage::get_instance();
     auto control = Control::get_instance();
 
     int option;
-    while ((option = getopt(argc, argv, "hs")) != -1) {
+    std::string offline_video, replay_video;
+    while ((option = getopt(argc, argv, "hso:r:")) != -1) {
         switch (option) {
             case 's':
                 Data::imshow_flag = true;
                 break;
+            case 'o':
+                offline_video = optarg;
+                break;
+            case 'r':
+                replay_video = optarg;
+                break;
             case 'h':
-                std::cout << "Usage: " << argv[0] << " [-h] [-s]" << std::endl;
+                std::cout << "Usage: " << argv[0] << " [-h] [-s] [-o video] [-r video]" << std::endl;
                 return 0;
         }
     }
-    
-    // 初始化相机
-    while(g_running && !init_camera()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    // 离线模式: 对录像批量推理并写出结果文件，不打开相机与串口
+    if (!offline_video.empty()) {
+        rm::message_init("autoaim");
+        init_debug();
+        return pipeline->autoaim_offline(offline_video) ? 0 : 1;
     }
     
-    if (!g_running) {
-        std::cout << "[Main] Interrupted during init" << std::endl;
+    // 启动编排: 相机、串口、模型与分类器并行初始化，流水线在相机与模型就绪后启动
+    rm::message_init("autoaim");
+    Startup startup;
+    startup.add("config", {}, [&]() {
+        init_debug();
+        init_attack();
+        return true;
+    });
+    startup.add("camera", {"config"}, [&]() {
+        if (!replay_video.empty()) return init_camera_replay(replay_video);
+        while(g_running && !init_camera()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+        return (bool)g_running;
+    });
+    startup.add("serial", {"config"}, [&]() {
+        if (Data::serial_flag) init_serial();
+        return (bool)g_running;
+    });
+    startup.add("model", {"config"}, [&]() {
+        if (pipeline->init_armor_model()) return true;
+        g_running = false;
+        return false;
+    });
+    startup.add("classifier", {"config"}, [&]() {
+        pipeline->init_classifier();
+        return true;
+    });
+    startup.add("control", {"serial"}, [&]() {
+        control->autoaim();
+        return true;
+    });
+    startup.add("pipeline", {"camera", "model", "classifier"}, [&]() {
+        #if defined(TJURM_INFANTRY) || defined(TJURM_BALANCE)
+        pipeline->autoaim_combine();  
+        #endif
+
+        #if defined(TJURM_SENTRY) || defined(TJURM_DRONSE) || defined(TJURM_HERO)
+        pipeline->autoaim_baseline();
+        #endif
+        return true;
+    });
+    // 首帧通过整条流水线即视为可开火
+    startup.add("first_frame", {"pipeline", "control"}, [&]() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (g_running && !pipeline->first_frame_ready()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return (bool)g_running;
+    });
+    bool started = startup.run();
+    startup.report();
+
+    // 任一阶段失败 (如回放录像打不开、首帧超时) 时同样退出，并通知已启动的线程
+    if (!started || !g_running) {
+        if (g_signal_received != 0) std::cout << "[Main] Interrupted during init" << std::endl;
+        else std::cout << "[Main] Startup failed" << std::endl;
+        g_running = false;
         return 1;
     }
 
-    rm::message_init("autoaim");
-    init_debug();
-    init_attack();
-    if (Data::serial_flag) init_serial();
-    control->autoaim();
-
-    #if defined(TJURM_INFANTRY) || defined(TJURM_BALANCE)
-    pipeline->autoaim_combine();  
-    #endif
-
-    #if defined(TJURM_SENTRY) || defined(TJURM_DRONSE) || defined(TJURM_HERO)
-    pipeline->autoaim_baseline();
-    #endif
-    
+    // 配置文件热更新
+    startConfigWatch();
+
     // 显示线程
     std::thread display_t(&Pipeline::display_thread, pipeline);
     display_t.detach();
@@ -2,6 +2,7 @@
 #include "threads/control.h"
 #include "threads/control/crc.h"
 
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -21,9 +22,10 @@ void Control::send_single(double yaw, double pitch, bool fire, rm::ArmorID id) {
     
     std::lock_guard<std::mutex> lock(serial_mutex_);  // 保护串口操作
     
-    // 检查文件描述符是否有效
+    // init_serial 重新扫描串口期间描述符为 -1，此时丢弃本帧而不写入
+    static std::atomic<int> skip_count(0);
     if (file_descriptor_ < 0) {
-        rm::message("Serial port not initialized", rm::MSG_ERROR);
+        rm::message("serial skipped", ++skip_count);
         return;
     }
     
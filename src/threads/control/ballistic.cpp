@@ -0,0 +1,430 @@
+#include "threads/control/ballistic.h"
+#include "data_manager/param.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+// 建表时的仰角扫描步长与积分步长，改变时旧缓存失效
+static constexpr double kSweepStep = 0.2 * M_PI / 180.0;
+static constexpr double kSweepMin  = -75.0 * M_PI / 180.0;
+static constexpr double kSweepMax  = 80.0 * M_PI / 180.0;
+static constexpr double kTableDt   = 0.002;
+static constexpr double kSolveDt   = 0.001;
+static constexpr double kMaxFlight = 5.0;
+static constexpr uint32_t kCacheMagic = 0x544c4142;     // "BALT"
+static constexpr uint32_t kCacheVersion = 1;
+
+static std::unique_ptr<BallisticTable> ballistic_table;
+static double yaw_scale = 1.0, pitch_scale = 1.0;       // 弧度到 rm::getFlyDelay 输出约定的换算 (含正负号)
+
+struct Shot {
+    double x, z, vx, vz;
+};
+
+static inline void derivative(const BallisticParam& param, const Shot& s, Shot& d) {
+    double v = std::sqrt(s.vx * s.vx + s.vz * s.vz);
+    d.x = s.vx;
+    d.z = s.vz;
+    d.vx = -param.drag * v * s.vx;
+    d.vz = -param.gravity - param.drag * v * s.vz;
+}
+
+static inline void step(const BallisticParam& param, Shot& s, double dt) {
+    Shot k1, k2, k3, k4, t;
+    derivative(param, s, k1);
+    t = {s.x + 0.5 * dt * k1.x, s.z + 0.5 * dt * k1.z, s.vx + 0.5 * dt * k1.vx, s.vz + 0.5 * dt * k1.vz};
+    derivative(param, t, k2);
+    t = {s.x + 0.5 * dt * k2.x, s.z + 0.5 * dt * k2.z, s.vx + 0.5 * dt * k2.vx, s.vz + 0.5 * dt * k2.vz};
+    derivative(param, t, k3);
+    t = {s.x + dt * k3.x, s.z + dt * k3.z, s.vx + dt * k3.vx, s.vz + dt * k3.vz};
+    derivative(param, t, k4);
+    s.x  += dt / 6.0 * (k1.x + 2 * k2.x + 2 * k3.x + k4.x);
+    s.z  += dt / 6.0 * (k1.z + 2 * k2.z + 2 * k3.z + k4.z);
+    s.vx += dt / 6.0 * (k1.vx + 2 * k2.vx + 2 * k3.vx + k4.vx);
+    s.vz += dt / 6.0 * (k1.vz + 2 * k2.vz + 2 * k3.vz + k4.vz);
+}
+
+// 以 (speed, pitch) 发射，依次记录弹道经过各水平距离 targets[i] 时的高度与时间
+// 弹道低于 min_height 后不会再回升，此后未到达的距离保持 NaN
+static void shoot(const BallisticParam& param, double speed, double pitch, double dt, double min_height,
+                  const double* targets, int count, double* heights, double* times) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::fill(heights, heights + count, nan);
+    std::fill(times, times + count, nan);
+
+    Shot s{0.0, 0.0, speed * std::cos(pitch), speed * std::sin(pitch)};
+    double t = 0.0;
+    int index = 0;
+    while (index < count && targets[index] <= 0.0) {
+        heights[index] = 0.0;
+        times[index] = 0.0;
+        index++;
+    }
+    while (index < count && t < kMaxFlight && s.vx > 1e-6 && s.z >= min_height) {
+        Shot last = s;
+        step(param, s, dt);
+        t += dt;
+        while (index < count && targets[index] <= s.x) {
+            double ratio = (targets[index] - last.x) / (s.x - last.x);
+            heights[index] = last.z + ratio * (s.z - last.z);
+            times[index] = t - dt + ratio * dt;
+            index++;
+        }
+    }
+}
+
+static double heightAt(const BallisticParam& param, double speed, double pitch, double distance, double& time) {
+    double height;
+    shoot(param, speed, pitch, kSolveDt, -1e3, &distance, 1, &height, &time);
+    return height;
+}
+
+bool solveBallistic(const BallisticParam& param, double distance, double height, double speed,
+                    double& pitch, double& fly_time) {
+    if (distance <= 0.0 || speed <= 0.0) return false;
+
+    // 给定距离处的高度随仰角先增后减，黄金分割求最高点后在其下方二分
+    const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+    double lo = kSweepMin, hi = kSweepMax, time;
+    auto peak = [&](double angle) {
+        double h = heightAt(param, speed, angle, distance, time);
+        return std::isnan(h) ? -1e9 : h;
+    };
+    double a = hi - ratio * (hi - lo), b = lo + ratio * (hi - lo);
+    double ha = peak(a), hb = peak(b);
+    for (int i = 0; i < 40; i++) {
+        if (ha < hb) { lo = a; a = b; ha = hb; b = lo + ratio * (hi - lo); hb = peak(b); }
+        else         { hi = b; b = a; hb = ha; a = hi - ratio * (hi - lo); ha = peak(a); }
+    }
+    double top = 0.5 * (lo + hi);
+    if (peak(top) < height) return false;
+
+    lo = kSweepMin;
+    hi = top;
+    for (int i = 0; i < 50; i++) {
+        double mid = 0.5 * (lo + hi);
+        double h = heightAt(param, speed, mid, distance, time);
+        if (std::isnan(h) || h < height) lo = mid;
+        else hi = mid;
+    }
+    pitch = 0.5 * (lo + hi);
+    return !std::isnan(heightAt(param, speed, pitch, distance, fly_time));
+}
+
+static int axisCount(const double* axis) {
+    return (int)std::floor((axis[1] - axis[0]) / axis[2] + 1e-6) + 1;
+}
+
+bool BallisticTable::build(const BallisticParam& param) {
+    pitch_.clear();
+    time_.clear();
+    if (param.distance[2] <= 0 || param.height[2] <= 0 || param.speed[2] <= 0) return false;
+    if (param.distance[0] <= 0 || param.speed[0] <= 0) return false;
+
+    param_ = param;
+    cols_ = axisCount(param.distance);
+    rows_ = axisCount(param.height);
+    slices_ = axisCount(param.speed);
+    if (cols_ < 2 || rows_ < 2 || slices_ < 1) return false;
+
+    std::vector<double> distances(cols_);
+    for (int c = 0; c < cols_; c++) distances[c] = param.distance[0] + c * param.distance[2];
+
+    // 每个初速扫描一组仰角，记录各距离处的高度与时间，再对每个 (距离, 高度) 在低弹道上反插仰角
+    int shots = (int)std::floor((kSweepMax - kSweepMin) / kSweepStep) + 1;
+    std::vector<double> heights(shots * cols_), times(shots * cols_);
+    pitch_.assign(slices_ * rows_ * cols_, std::numeric_limits<float>::quiet_NaN());
+    time_.assign(slices_ * rows_ * cols_, std::numeric_limits<float>::quiet_NaN());
+
+    for (int s = 0; s < slices_; s++) {
+        double speed = param.speed[0] + s * param.speed[2];
+        for (int i = 0; i < shots; i++) {
+            shoot(param, speed, kSweepMin + i * kSweepStep, kTableDt, param.height[0] - 1.0,
+                  distances.data(), cols_, &heights[i * cols_], &times[i * cols_]);
+        }
+
+        for (int c = 0; c < cols_; c++) {
+            int r = 0;
+            for (int i = 0; i + 1 < shots && r < rows_; i++) {
+                double h0 = heights[i * cols_ + c], h1 = heights[(i + 1) * cols_ + c];
+                if (std::isnan(h0) || std::isnan(h1)) continue;
+                if (h1 < h0) break;                         // 越过最高点，余下为高弹道
+
+                double t0 = times[i * cols_ + c], t1 = times[(i + 1) * cols_ + c];
+                while (r < rows_ && param.height[0] + r * param.height[2] < h0) r++;
+                for (; r < rows_; r++) {
+                    double target = param.height[0] + r * param.height[2];
+                    if (target > h1) break;
+                    double ratio = (h1 > h0) ? (target - h0) / (h1 - h0) : 0.0;
+                    int index = (s * rows_ + r) * cols_ + c;
+                    pitch_[index] = kSweepMin + (i + ratio) * kSweepStep;
+                    time_[index] = t0 + ratio * (t1 - t0);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool BallisticTable::lookup(double distance, double height, double speed, double& pitch, double& fly_time) const {
+    if (empty()) return false;
+    double fc = (distance - param_.distance[0]) / param_.distance[2];
+    double fr = (height - param_.height[0]) / param_.height[2];
+    double fs = (speed - param_.speed[0]) / param_.speed[2];
+    if (fc < 0 || fc > cols_ - 1 || fr < 0 || fr > rows_ - 1 || fs < 0 || fs > slices_ - 1) return false;
+
+    int c0 = std::min((int)fc, cols_ - 2);
+    int r0 = std::min((int)fr, rows_ - 2);
+    int s0 = std::min((int)fs, std::max(slices_ - 2, 0));
+    double ac = fc - c0, ar = fr - r0, as = (slices_ > 1) ? fs - s0 : 0.0;
+
+    double value[2] = {0.0, 0.0};
+    const std::vector<float>* tables[2] = {&pitch_, &time_};
+    for (int k = 0; k < 2; k++) {
+        const std::vector<float>& table = *tables[k];
+        for (int ds = 0; ds < 2; ds++) {
+            double ws = ds ? as : 1.0 - as;
+            if (ws == 0.0) continue;
+            const float* slice = &table[(s0 + ds) * rows_ * cols_];
+            const float* p0 = slice + r0 * cols_ + c0;
+            const float* p1 = p0 + cols_;
+            double v = (p0[0] * (1 - ac) + p0[1] * ac) * (1 - ar) + (p1[0] * (1 - ac) + p1[1] * ac) * ar;
+            value[k] += ws * v;
+        }
+    }
+    if (std::isnan(value[0]) || std::isnan(value[1])) return false;
+    pitch = value[0];
+    fly_time = value[1];
+    return true;
+}
+
+void BallisticTable::evaluate(int samples, double& pitch_mean, double& pitch_max, double& time_mean, double& time_max) const {
+    pitch_mean = pitch_max = time_mean = time_max = 0.0;
+    if (empty() || samples <= 0) return;
+
+    cv::RNG rng(0x5eed);
+    int count = 0;
+    for (int i = 0; i < samples; i++) {
+        double distance = rng.uniform(param_.distance[0], param_.distance[0] + (cols_ - 1) * param_.distance[2]);
+        double height = rng.uniform(param_.height[0], param_.height[0] + (rows_ - 1) * param_.height[2]);
+        double speed = rng.uniform(param_.speed[0], param_.speed[0] + std::max(slices_ - 1, 0) * param_.speed[2]);
+
+        double pitch, fly_time, ref_pitch, ref_time;
+        if (!lookup(distance, height, speed, pitch, fly_time)) continue;
+        if (!solveBallistic(param_, distance, height, speed, ref_pitch, ref_time)) continue;
+
+        double pitch_error = std::fabs(pitch - ref_pitch) * 180.0 / M_PI;
+        double time_error = std::fabs(fly_time - ref_time) * 1000.0;
+        pitch_mean += pitch_error;
+        time_mean += time_error;
+        pitch_max = std::max(pitch_max, pitch_error);
+        time_max = std::max(time_max, time_error);
+        count++;
+    }
+    if (count > 0) {
+        pitch_mean /= count;
+        time_mean /= count;
+    }
+}
+
+static void packParam(const BallisticParam& param, double* block) {
+    double values[14] = {
+        param.gravity, param.drag,
+        param.distance[0], param.distance[1], param.distance[2],
+        param.height[0], param.height[1], param.height[2],
+        param.speed[0], param.speed[1], param.speed[2],
+        kSweepStep, kSweepMin, kTableDt
+    };
+    std::memcpy(block, values, sizeof(values));
+}
+
+bool BallisticTable::save(const std::string& path) const {
+    if (empty()) return false;
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    double block[14];
+    packParam(param_, block);
+    int dims[3] = {cols_, rows_, slices_};
+    file.write((const char*)&kCacheMagic, sizeof(kCacheMagic));
+    file.write((const char*)&kCacheVersion, sizeof(kCacheVersion));
+    file.write((const char*)block, sizeof(block));
+    file.write((const char*)dims, sizeof(dims));
+    file.write((const char*)pitch_.data(), pitch_.size() * sizeof(float));
+    file.write((const char*)time_.data(), time_.size() * sizeof(float));
+    return file.good();
+}
+
+bool BallisticTable::load(const std::string& path, const BallisticParam& param) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    uint32_t magic = 0, version = 0;
+    double block[14], expect[14];
+    int dims[3];
+    file.read((char*)&magic, sizeof(magic));
+    file.read((char*)&version, sizeof(version));
+    file.read((char*)block, sizeof(block));
+    file.read((char*)dims, sizeof(dims));
+    if (!file.good() || magic != kCacheMagic || version != kCacheVersion) return false;
+
+    // 参数不同的缓存视为过期
+    packParam(param, expect);
+    if (std::memcmp(block, expect, sizeof(block)) != 0) return false;
+    if (dims[0] != axisCount(param.distance) || dims[1] != axisCount(param.height) || dims[2] != axisCount(param.speed)) return false;
+
+    size_t size = (size_t)dims[0] * dims[1] * dims[2];
+    std::vector<float> pitch(size), time(size);
+    file.read((char*)pitch.data(), size * sizeof(float));
+    file.read((char*)time.data(), size * sizeof(float));
+    if (!file.good()) return false;
+
+    param_ = param;
+    cols_ = dims[0];
+    rows_ = dims[1];
+    slices_ = dims[2];
+    pitch_ = std::move(pitch);
+    time_ = std::move(time);
+    return true;
+}
+
+// 查表输出的是弧度、向上为正，rm::getFlyDelay 的单位与正方向在此核对:
+// 取几个仰角明显不为零的近距离点，分别以真空解与带阻力的直接积分作参照，
+// rm::getFlyDelay 无论是否考虑阻力都应与其中之一接近。各换算之间相差正负号或约 57 倍，
+// 因此按相对误差判定，不依赖固定的角度容差
+static bool matchConvention(const BallisticParam& param) {
+    const double speed = 0.5 * (param.speed[0] + param.speed[1]);
+    const double probes[3][3] = {{3.0, 1.0, 0.6}, {2.5, -1.0, -0.5}, {4.0, 1.5, 1.0}};
+    const double scales[4] = {180.0 / M_PI, -180.0 / M_PI, 1.0, -1.0};
+    const double tolerance = 0.1;
+
+    double yaw_error[4] = {0, 0, 0, 0}, pitch_error[4] = {0, 0, 0, 0};
+    for (const auto& probe : probes) {
+        double x = probe[0], y = probe[1], z = probe[2];
+        double d = std::hypot(x, y), g = param.gravity, v2 = speed * speed;
+        double yaw = std::atan2(y, x);
+        double vacuum = std::atan((v2 - std::sqrt(v2 * v2 - g * (g * d * d + 2 * z * v2))) / (g * d));
+        double drag = vacuum, fly_time;
+        if (!solveBallistic(param, d, z, speed, drag, fly_time)) drag = vacuum;
+
+        double rm_yaw = 0, rm_pitch = 0;
+        rm::getFlyDelay(rm_yaw, rm_pitch, speed, x, y, z);
+        for (int k = 0; k < 4; k++) {
+            double scale = std::fabs(scales[k]);
+            yaw_error[k] = std::max(yaw_error[k], std::fabs(rm_yaw - scales[k] * yaw) / (scale * std::fabs(yaw)));
+            double error = std::min(std::fabs(rm_pitch - scales[k] * vacuum) / (scale * std::fabs(vacuum)),
+                                    std::fabs(rm_pitch - scales[k] * drag) / (scale * std::fabs(drag)));
+            pitch_error[k] = std::max(pitch_error[k], error);
+        }
+    }
+
+    int yaw_index = std::min_element(yaw_error, yaw_error + 4) - yaw_error;
+    int pitch_index = std::min_element(pitch_error, pitch_error + 4) - pitch_error;
+    if (yaw_error[yaw_index] > tolerance || pitch_error[pitch_index] > tolerance) return false;
+    yaw_scale = scales[yaw_index];
+    pitch_scale = scales[pitch_index];
+    return true;
+}
+
+static BallisticParam readParam() {
+    auto param = Param::get_instance();
+    const auto& node = (*param)["Car"]["Ballistic"];
+
+    BallisticParam ballistic;
+    ballistic.gravity = (*param)["Car"]["Gravity"];
+    double mass = node["Mass"], diameter = node["Diameter"];
+    double drag_coeff = node["DragCoeff"], air_density = node["AirDensity"];
+    ballistic.drag = 0.5 * air_density * drag_coeff * (M_PI * diameter * diameter / 4.0) / mass;
+
+    std::vector<double> distance = node["Distance"], height = node["Height"], speed = node["Speed"];
+    for (int i = 0; i < 3; i++) {
+        ballistic.distance[i] = distance[i];
+        ballistic.height[i] = height[i];
+        ballistic.speed[i] = speed[i];
+    }
+    return ballistic;
+}
+
+void initBallisticTable() {
+    auto param = Param::get_instance();
+    ballistic_table.reset();
+    if (!(*param)["Car"]["Ballistic"]["Enable"]) return;
+
+    BallisticParam ballistic = readParam();
+    std::string cache_path = (*param)["Car"]["Ballistic"]["CachePath"];
+
+    auto table = std::make_unique<BallisticTable>();
+    TimePoint tp0 = getTime();
+    bool cached = !cache_path.empty() && table->load(cache_path, ballistic);
+    if (!cached) {
+        if (!table->build(ballistic)) {
+            rm::message("Failed to build ballistic table", rm::MSG_WARNING);
+            return;
+        }
+        if (!cache_path.empty() && !table->save(cache_path)) {
+            std::cout << "[BALLISTIC] 缓存写入失败: " << cache_path << std::endl;
+        }
+    }
+    std::cout << "[BALLISTIC] k = " << ballistic.drag << " 1/m, " << (cached ? "读取缓存 " : "建表 ")
+              << getDoubleOfS(tp0, getTime()) * 1000 << " ms" << std::endl;
+
+    if (!cached || Data::benchmark_flag) {
+        double pitch_mean, pitch_max, time_mean, time_max;
+        table->evaluate(200, pitch_mean, pitch_max, time_mean, time_max);
+        std::cout << "[BALLISTIC] 相对直接积分: 仰角 平均 " << pitch_mean << " 度, 最大 " << pitch_max
+                  << " 度; 飞行时间 平均 " << time_mean << " ms, 最大 " << time_max << " ms" << std::endl;
+    }
+
+    if (!matchConvention(ballistic)) {
+        std::cout << "[BALLISTIC] 与 rm::getFlyDelay 的角度约定不一致，回退到 rm::getFlyDelay" << std::endl;
+        return;
+    }
+    ballistic_table = std::move(table);
+}
+
+double getBallisticFlyDelay(double& yaw, double& pitch, double speed, double x, double y, double z) {
+    double table_pitch, fly_time;
+    if (ballistic_table != nullptr && ballistic_table->lookup(std::hypot(x, y), z, speed, table_pitch, fly_time)) {
+        yaw = yaw_scale * std::atan2(y, x);
+        pitch = pitch_scale * table_pitch;
+        rm::message("ballistic table", 1);
+        return fly_time;
+    }
+    rm::message("ballistic table", 0);
+    return rm::getFlyDelay(yaw, pitch, speed, x, y, z);
+}
+
+void benchmarkBallisticTable(int iterations) {
+    if (ballistic_table == nullptr || iterations <= 0) return;
+    BallisticParam ballistic = readParam();
+
+    cv::RNG rng(0x5eed);
+    cv::TickMeter table_meter, openrm_meter, solve_meter;
+    double yaw, pitch, fly_time;
+    int solves = std::min(iterations, 50);
+    for (int i = 0; i < iterations; i++) {
+        double x = rng.uniform(2.0, 15.0), y = rng.uniform(-2.0, 2.0), z = rng.uniform(-0.5, 1.5);
+        double speed = rng.uniform(14.0, 16.0);
+
+        table_meter.start();
+        getBallisticFlyDelay(yaw, pitch, speed, x, y, z);
+        table_meter.stop();
+
+        openrm_meter.start();
+        rm::getFlyDelay(yaw, pitch, speed, x, y, z);
+        openrm_meter.stop();
+
+        if (i < solves) {
+            solve_meter.start();
+            solveBallistic(ballistic, std::hypot(x, y), z, speed, pitch, fly_time);
+            solve_meter.stop();
+        }
+    }
+    std::cout << "[BALLISTIC] 单次求解 (" << iterations << " 次平均): 查表 " << table_meter.getTimeMicro() / iterations
+              << " us, rm::getFlyDelay " << openrm_meter.getTimeMicro() / iterations << " us, 直接积分 "
+              << solve_meter.getTimeMicro() / solves << " us" << std::endl;
+}
@@ -1,6 +1,9 @@
 #include "garage/garage.h"
 #include "threads/control.h"
 #include "threads/pipeline.h"
+#include "data_manager/undistort.h"
+#include "data_manager/config.h"
+#include "threads/control/ballistic.h"
 #include <thread>
 #include <cmath>
 #include <fstream>
@@ -30,14 +33,27 @@ static bool speed_write_flag;
 static rm::SpeedQueue<float> speed_queue(3, 15.75f, {0.5, 0.3, 0.2});
 
 
+// 配置快照更新后刷新弹速与各项延迟，未更新时只比较一次指针
+static void apply_send_config() {
+    static ConfigPtr applied;
+    ConfigPtr config = getConfigSnapshot();
+    if (config == applied) return;
+    applied = config;
+
+    // 英雄的弹速由 shootspeed() 每帧按裁判系统弹速均值写入，不取配置
+    #ifndef TJURM_HERO
+    shoot_speed = config->shoot_speed;
+    #endif
+    shoot_delay = config->shoot_delay;
+    rotate_delay = config->rotate_delay;
+    rotate_delay_outpost = config->rotate_delay_outpost;
+    rotate_delay_rune = config->rotate_delay_rune;
+    start_fire_delay = config->start_fire_delay;
+}
+
 static void init_send() {
     auto param = Param::get_instance();
-    shoot_speed = (*param)["Car"]["ShootSpeed"];
-    shoot_delay = (*param)["Car"]["ShootDelay"];
-    rotate_delay = (*param)["Car"]["RotateDelay"];
-    rotate_delay_outpost = (*param)["Car"]["RotateDelayOutpost"];
-    rotate_delay_rune = (*param)["Car"]["RotateDelayRune"];
-    start_fire_delay = (*param)["Car"]["StartFireDelay"];
+    apply_send_config();
     iteration_num = (*param)["Kalman"]["IterationNum"];
     base_to_far_dist = (*param)["Camera"]["Switch"]["BaseToFarDist"];
     far_to_base_dist = (*param)["Camera"]["Switch"]["FarToBaseDist"];
@@ -47,6 +63,11 @@ static void init_send() {
     if (speed_write_flag) {
         speed_file.open(speed_save_path, std::ios_base::app);
     }
+
+    #ifdef TJURM_HERO
+    initBallisticTable();
+    if (Data::benchmark_flag) benchmarkBallisticTable(1000);
+    #endif
 }
 
 void Control::message() {
@@ -191,9 +212,15 @@ bool Control::check_armor_detection(double& armor_yaw, double& armor_pitch, rm::
     double pixel_x = img_center_x - cx;
     double pixel_y = img_center_y - cy;
     
-    // 转换为角度偏移（使用atan2公式）
+    // 转换为角度偏移（使用atan2公式），有去畸变表时按查表后的归一化坐标计算
     double offset_yaw = std::atan2(pixel_x, fx) * 180.0 / M_PI;
     double offset_pitch = std::atan2(pixel_y, fy) * 180.0 / M_PI;
+    const UndistortMap* undistort_map = getUndistortMap(Data::camera_index);
+    if (undistort_map != nullptr) {
+        cv::Point2f normalized = undistort_map->lookup(cv::Point2f(img_center_x, img_center_y));
+        offset_yaw = std::atan(normalized.x) * 180.0 / M_PI;
+        offset_pitch = std::atan(normalized.y) * 180.0 / M_PI;
+    }
     
     // 获取当前云台角度
     double gimbal_yaw = get_yaw();
@@ -204,18 +231,8 @@ bool Control::check_armor_detection(double& armor_yaw, double& armor_pitch, rm::
     armor_pitch = gimbal_pitch + offset_pitch;
     
     // 设置装甲板ID
-    static std::vector<int> armor_class_map;
-    static bool map_initialized = false;
-    if (!map_initialized) {
-        auto param = Param::get_instance();
-        std::string yolo_type = (*param)["Model"]["YoloArmor"]["Type"];
-        auto json_class_map = (*param)["Model"]["YoloArmor"][yolo_type]["ClassMap"];
-        armor_class_map.clear();
-        for (const auto& item : json_class_map) {
-            armor_class_map.push_back((int)item);
-        }
-        map_initialized = true;
-    }
+    ConfigPtr config = getConfigSnapshot();
+    const std::vector<int>& armor_class_map = config->armor_class_map;
     
     if (yolo_rect.class_id >= 0 && yolo_rect.class_id < armor_class_map.size()) {
         armor_id = (rm::ArmorID)armor_class_map[yolo_rect.class_id];
@@ -265,6 +282,7 @@ void Control::send_thread() {
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(Data::send_wait_time));
 
+        apply_send_config();
         this->state();
         this->shootspeed();
 
@@ -274,6 +292,14 @@ void Control::send_thread() {
         // ★ 新策略：如果检测到装甲板，优先发送装甲板位置
         #ifdef TJURM_HERO
         if (has_armor) {
+            // 英雄在此分支直接返回，目标距离取检测到的装甲板所属车辆的跟踪位置，供检测级联选择模型
+            if (detected_armor_id != rm::ARMOR_ID_UNKNOWN) {
+                Eigen::Vector4d armor_pose;
+                garage->getObj(detected_armor_id)->getTarget(armor_pose, 0.0, 0.0, 0.0);
+                if ((std::abs(armor_pose[0]) > 1e-2) || (std::abs(armor_pose[1]) > 1e-2)) {
+                    Data::target_dist = armor_pose.head<3>().norm();
+                }
+            }
             send_single(detected_yaw, detected_pitch, false, detected_armor_id);
             continue;
         }
@@ -310,7 +336,11 @@ void Control::send_thread() {
         auto objptr = garage->getObj(Data::target_id);
         objptr->getTarget(pose, 0.0, 0.0, 0.0);
         for(int i = 0; i < iteration_num; i++) {
+            #ifdef TJURM_HERO
+            fly_delay = getBallisticFlyDelay(target_yaw, target_pitch, shoot_speed, pose(0, 0), pose(1, 0), pose(2, 0));
+            #else
             fly_delay = getFlyDelay(target_yaw, target_pitch, shoot_speed, pose(0, 0), pose(1, 0), pose(2, 0));
+            #endif
             fire = objptr->getTarget(pose, fly_delay, rotate_delay, shoot_delay);
         }
         rm::message("target pitch b", target_pitch);
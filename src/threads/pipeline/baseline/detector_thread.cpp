@@ -1,9 +1,13 @@
 #include "threads/pipeline.h"
+#include "threads/pipeline/yolo.h"
+#include "threads/pipeline/motion.h"
+#include "threads/pipeline/lightbar.h"
 #include <atomic>
 extern std::atomic<bool> g_running;
 #include <unistd.h>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include <openrm/cudatools.h>
 using namespace rm;
 using namespace nvinfer1;
@@ -36,7 +40,68 @@ void Pipeline::detector_baseline_thread(
     std::cout << "[DETECTOR] 启动检测线程" << std::endl;
     std::cout << "[DETECTOR] Type=" << yolo_type << " struct_len=" << struct_len << std::endl;
     std::cout << "[DETECTOR] confidence_thresh=" << confidence_thresh << std::endl;
+
+    // CPU 后端: 融合 letterbox 预处理 + cv::dnn 推理，用于无 GPU 的调试环境
+    std::string backend = (*param)["Model"]["YoloArmor"]["Backend"];
+    bool cpu_backend    = (backend == "CPU");
+    bool swap_rb        = (*param)["Model"]["YoloArmor"]["CPU"]["SwapRB"];
+    float pad_value     = (*param)["Model"]["YoloArmor"]["CPU"]["PadValue"];
+
+    cv::dnn::Net armor_net;
+    cv::Mat armor_blob;
+    if (cpu_backend) {
+        std::string onnx_file = (*param)["Model"]["YoloArmor"][yolo_type]["DirONNX"];
+        try {
+            armor_net = cv::dnn::readNetFromONNX(onnx_file);
+        } catch (const cv::Exception& e) {
+            rm::message("CPU backend model load failed: " + std::string(e.what()), rm::MSG_ERROR);
+            g_running = false;
+            return;
+        }
+        armor_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        armor_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        int blob_size[] = {1, 3, infer_height, infer_width};
+        armor_blob.create(4, blob_size, CV_32F);
+        std::cout << "[DETECTOR] 使用 CPU 后端: " << onnx_file << std::endl;
+    }
+    // 传统灯条检测后端，PreDetect 仅对 CPU 后端生效 (GPU 推理已在预处理线程中提交)
+    bool classical_backend = (backend == "Classical");
+    bool classical_gate    = cpu_backend && (bool)(*param)["Model"]["YoloArmor"]["Classical"]["PreDetect"];
+    LightbarDetectConfig lightbar_config;
+    if (classical_backend || classical_gate) {
+        lightbar_config = getLightbarDetectConfig();
+        std::cout << "[DETECTOR] 使用传统灯条检测" << (classical_gate ? " (预检测)" : "") << std::endl;
+    }
+    if (Data::benchmark_flag) benchmarkLetterbox(1440, 1080, infer_width, infer_height, 100);
+
+    // 隔帧检测: 非关键帧用 LK 光流传播上一帧的检测结果
+    bool   skip_enabled   = (*param)["Model"]["YoloArmor"]["Skip"]["Enable"];
+    bool   skip_validate  = (*param)["Model"]["YoloArmor"]["Skip"]["Validate"];
+    double skip_max_error = (*param)["Model"]["YoloArmor"]["Skip"]["MaxFlowError"];
+    double skip_min_conf  = (*param)["Model"]["YoloArmor"]["Skip"]["MinConfidence"];
+    double skip_decay     = (*param)["Model"]["YoloArmor"]["Skip"]["ConfidenceDecay"];
+    std::shared_ptr<rm::Frame> prev_frame;
+    std::vector<rm::YoloRect> prev_yolo_list;
+    int keyframe_count = 0;
+
+    // 距离级联: 目标距离超过 FarDist 切换到远距离模型，低于 NearDist 切回，丢失目标超过 HoldFrames 帧也切回
+    bool   cascade_enabled = (*param)["Model"]["YoloArmor"]["Cascade"]["Enable"];
+    std::string far_type   = (*param)["Model"]["YoloArmor"]["Cascade"]["FarType"];
+    double far_dist        = (*param)["Model"]["YoloArmor"]["Cascade"]["FarDist"];
+    double near_dist       = (*param)["Model"]["YoloArmor"]["Cascade"]["NearDist"];
+    int    hold_frames     = (*param)["Model"]["YoloArmor"]["Cascade"]["HoldFrames"];
+    std::vector<double> buckets = (*param)["Model"]["YoloArmor"]["Cascade"]["Buckets"];
+    YoloConfig far_config;
+    if (cascade_enabled) far_config = getYoloConfig(far_type);
+    int lost_count = 0;
+
+    // 按距离分桶统计检出率与延迟
+    std::vector<int> bucket_frames(buckets.size() + 1, 0);
+    std::vector<int> bucket_hits(buckets.size() + 1, 0);
+    std::vector<double> bucket_delay(buckets.size() + 1, 0.0);
     
+    init_tiler();
+
     std::mutex mutex;
     int debug_counter = 0;
     
@@ -62,60 +127,124 @@ void Pipeline::detector_baseline_thread(
             continue;
         }
         std::shared_ptr<rm::Frame> frame = frame_in;
+        bool keyframe = keyframe_register_ || !skip_enabled;
+        bool far_model = far_model_register_;
         flag_in = false;
         lock_in.unlock();
 
-        detectOutput(
-            armor_output_host_buffer_,
-            armor_output_device_buffer_,
-            &detect_stream_,
-            yolo_struct_size,
-            bboxes_num
-        );
-        
+        std::vector<rm::YoloRect> propagated;
+        if (!keyframe && prev_frame != nullptr) {
+            cv::Point2f shift = getGimbalShift(
+                Data::camera[frame->camera_id], prev_frame->yaw, prev_frame->pitch, frame->yaw, frame->pitch);
+            propagated = propagateYoloRects(*prev_frame->image, *frame->image, prev_yolo_list, shift, skip_max_error);
+            // 传播结果每帧按比例衰减置信度，连续传播后低于 MinConfidence 时强制检测
+            for (auto& yolo_rect : propagated) yolo_rect.confidence *= skip_decay;
+        }
         debug_counter++;
-        
-        // 调用NMS获取检测结果
-        if (yolo_type == "V5") {
-            frame->yolo_list = yoloArmorNMS_V5(
-                armor_output_host_buffer_,
-                bboxes_num,
-                class_num,
-                confidence_thresh,
-                nms_thresh,
-                frame->width,
-                frame->height,
-                infer_width,
-                infer_height
-            );
-        } else if (yolo_type == "FP") {
-            frame->yolo_list = yoloArmorNMS_FP(
-                armor_output_host_buffer_,
-                bboxes_num,
-                class_num,
-                confidence_thresh,
-                nms_thresh,
-                frame->width,
-                frame->height,
-                infer_width,
-                infer_height
-            );
-        } else if (yolo_type == "FPX") {
-            frame->yolo_list = yoloArmorNMS_FPX(
-                armor_output_host_buffer_,
-                bboxes_num,
-                class_num,
-                confidence_thresh,
-                nms_thresh,
-                frame->width,
-                frame->height,
-                infer_width,
-                infer_height
-            );
+
+        if (keyframe || skip_validate) {
+            // 传统灯条检测: 作为独立后端直接输出候选框，或在 CPU 后端前做预检测，无候选时跳过网络推理
+            bool run_network = !classical_backend;
+            if (classical_backend || classical_gate) {
+                std::vector<rm::YoloRect> candidates;
+                TimePoint tp1 = getTime();
+                lightbarDetect(*frame->image, candidates, Data::enemy_color, lightbar_config);
+                TimePoint tp2 = getTime();
+                if (Data::pipeline_delay_flag) rm::message("lightbar detect", getDoubleOfS(tp1, tp2) * 1000);
+                if (classical_backend) frame->yolo_list = candidates;
+                else run_network = !candidates.empty();
+            }
+
+            if (run_network) {
+                float* output_host_buffer = armor_output_host_buffer_;
+                cv::Mat armor_output;
+                if (cpu_backend) {
+                    TimePoint tp1 = getTime();
+                    letterboxBlob(
+                        *frame->image, armor_blob.ptr<float>(), infer_width, infer_height,
+                        swap_rb, pad_value, 1.f / 255.f);
+                    TimePoint tp2 = getTime();
+                    armor_net.setInput(armor_blob);
+                    armor_output = armor_net.forward();
+                    output_host_buffer = armor_output.ptr<float>();
+                    if (Data::pipeline_delay_flag) rm::message("letterbox", getDoubleOfS(tp1, tp2) * 1000);
+                } else {
+                    if (far_model) output_host_buffer = armor_far_output_host_buffer_;
+                    detectOutput(
+                        output_host_buffer,
+                        far_model ? armor_far_output_device_buffer_ : armor_output_device_buffer_,
+                        &detect_stream_,
+                        far_model ? far_config.yolo_struct_size : yolo_struct_size,
+                        far_model ? far_config.bboxes_num : bboxes_num
+                    );
+                }
+
+                // 调用NMS获取检测结果，两个模型共用同一解码路径
+                if (!yoloArmorNMS(
+                        far_model ? far_config.type : yolo_type,
+                        frame->yolo_list,
+                        output_host_buffer,
+                        far_model ? far_config.bboxes_num : bboxes_num,
+                        far_model ? far_config.class_num : class_num,
+                        far_model ? far_config.confidence_thresh : confidence_thresh,
+                        far_model ? far_config.nms_thresh : nms_thresh,
+                        frame->width,
+                        frame->height,
+                        far_model ? far_config.infer_width : infer_width,
+                        far_model ? far_config.infer_height : infer_height)) {
+                    rm::message("Invalid yolo type", rm::MSG_ERROR);
+                    g_running = false;
+                    break;
+                }
+            }
+
+            // 远距离吊射时追加原生分辨率切片推理
+            tiler(frame);
+        }
+
+        if (!keyframe && skip_validate) {
+            // Validate 模式下同帧同时有检测 (含切片) 与传播结果，统计传播误差后输出检测结果
+            double error = getYoloCornerError(propagated, frame->yolo_list);
+            if (error >= 0) rm::message("skip corner error", error);
+        } else if (!keyframe) {
+            frame->yolo_list = propagated;
+            float max_conf = 0.f;
+            for (const auto& yolo_rect : propagated) max_conf = std::max(max_conf, yolo_rect.confidence);
+            if (propagated.empty() || propagated.size() < prev_yolo_list.size() || max_conf < skip_min_conf) {
+                force_detect_ = true;
+            }
         } else {
-            rm::message("Invalid yolo type", rm::MSG_ERROR);
-            g_running = false;
-            break;
+            keyframe_count++;
+            // 关键帧置信度偏低时下一帧继续检测
+            float max_conf = 0.f;
+            for (const auto& yolo_rect : frame->yolo_list) max_conf = std::max(max_conf, yolo_rect.confidence);
+            if (skip_enabled && max_conf < skip_min_conf) force_detect_ = true;
+        }
+        if (skip_enabled) {
+            rm::message("detect ratio", (double)keyframe_count / debug_counter);
+            prev_frame = frame;
+            prev_yolo_list = frame->yolo_list;
+        }
+
+        if (cascade_enabled) {
+            lost_count = frame->yolo_list.empty() ? lost_count + 1 : 0;
+            // 目标距离由发送线程写入 (预测的击打位置，英雄检测到装甲板时为该车的跟踪位置)，本线程只读取一次
+            double target_dist = Data::target_dist;
+            bool use_far = cascade_far_;
+            if (lost_count > hold_frames)       use_far = false;
+            else if (target_dist > far_dist)    use_far = true;
+            else if (target_dist < near_dist)   use_far = false;
+            cascade_far_ = use_far;
+
+            int bucket = std::upper_bound(buckets.begin(), buckets.end(), target_dist) - buckets.begin();
+            bucket_frames[bucket]++;
+            if (!frame->yolo_list.empty()) bucket_hits[bucket]++;
+            bucket_delay[bucket] += getDoubleOfS(frame->time_point, getTime());
+
+            rm::message("cascade model", (int)far_model);
+            rm::message("cascade bucket", bucket);
+            rm::message("cascade recall", (double)bucket_hits[bucket] / bucket_frames[bucket]);
+            rm::message("cascade delay", bucket_delay[bucket] * 1000 / bucket_frames[bucket]);
         }
         
         // 更新全局检测结果供显示线程使用
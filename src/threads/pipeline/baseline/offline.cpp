@@ -0,0 +1,265 @@
+#include "threads/pipeline.h"
+#include "threads/pipeline/yolo.h"
+#include "threads/pipeline/lightbar.h"
+#include <atomic>
+extern std::atomic<bool> g_running;
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+using namespace rm;
+
+// 结果文件每帧一行 F，随后是该帧的检测 (D)、装甲板 (A) 与位姿 (T)
+// F <帧号> <检测数> <装甲板数> <目标数>
+// D <类别> <颜色> <置信度> <x> <y> <w> <h>
+// A <ID> <颜色> <尺寸> <x0> <y0> <x1> <y1> <x2> <y2> <x3> <y3>
+// T <ID> <尺寸> <x> <y> <z> <yaw>
+static void writeOfflineResult(std::ofstream& out, int index, const std::shared_ptr<rm::Frame>& frame) {
+    out << "F " << index << " " << frame->yolo_list.size() << " "
+        << frame->armor_list.size() << " " << frame->target_list.size() << "\n";
+
+    for (const auto& yolo_rect : frame->yolo_list) {
+        out << "D " << yolo_rect.class_id << " " << yolo_rect.color_id << " " << yolo_rect.confidence << " "
+            << yolo_rect.box.x << " " << yolo_rect.box.y << " "
+            << yolo_rect.box.width << " " << yolo_rect.box.height << "\n";
+    }
+    for (const auto& armor : frame->armor_list) {
+        out << "A " << (int)armor.id << " " << (int)armor.color << " " << (int)armor.size;
+        for (const auto& point : armor.four_points) out << " " << point.x << " " << point.y;
+        out << "\n";
+    }
+    for (const auto& target : frame->target_list) {
+        out << "T " << (int)target.armor_id << " " << (int)target.armor_size << " "
+            << target.pose_world(0) << " " << target.pose_world(1) << " " << target.pose_world(2) << " "
+            << target.armor_yaw_world << "\n";
+    }
+}
+
+bool Pipeline::autoaim_offline(const std::string& video_path) {
+    auto param = Param::get_instance();
+
+    int batch_size          = (*param)["Debug"]["Offline"]["BatchSize"];
+    std::string target      = (*param)["Debug"]["Offline"]["Target"];
+    std::string enemy       = (*param)["Debug"]["Offline"]["EnemyColor"];
+    std::string result_path = (*param)["Debug"]["Offline"]["ResultPath"];
+    bool compare_classical  = (*param)["Debug"]["Offline"]["CompareClassical"];
+    if (result_path.empty()) result_path = video_path + ".result";
+    batch_size = std::max(1, batch_size);
+
+    cv::VideoCapture capture(video_path);
+    if (!capture.isOpened()) {
+        rm::message("Failed to open video: " + video_path, rm::MSG_ERROR);
+        return false;
+    }
+    int width = (int)capture.get(cv::CAP_PROP_FRAME_WIDTH);
+    int height = (int)capture.get(cv::CAP_PROP_FRAME_HEIGHT);
+    double video_fps = capture.get(cv::CAP_PROP_FPS);
+    if (!init_camera_offline(width, height)) return false;
+
+    // 录像没有云台姿态与裁判系统信息，敌方颜色取配置，位姿结果位于云台零位的世界系
+    Data::enemy_color = (enemy == "Red") ? rm::ARMOR_COLOR_RED : rm::ARMOR_COLOR_BLUE;
+    Data::self_color = (enemy == "Red") ? rm::ARMOR_COLOR_BLUE : rm::ARMOR_COLOR_RED;
+    Data::image_flag = false;
+
+    std::string yolo_type = (*param)["Model"]["YoloArmor"]["Type"];
+    YoloConfig config = getYoloConfig(yolo_type);
+    bool swap_rb      = (*param)["Model"]["YoloArmor"]["CPU"]["SwapRB"];
+    float pad_value   = (*param)["Model"]["YoloArmor"]["CPU"]["PadValue"];
+
+    // TensorRT 引擎按 batch 1 构建，离线批量推理统一走 cv::dnn，有 GPU 时可选 CUDA 目标
+    cv::dnn::Net armor_net;
+    try {
+        armor_net = cv::dnn::readNetFromONNX(config.onnx_file);
+    } catch (const cv::Exception& e) {
+        rm::message("Offline model load failed: " + std::string(e.what()), rm::MSG_ERROR);
+        return false;
+    }
+    if (target == "CUDA") {
+        armor_net.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
+        armor_net.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
+    } else {
+        armor_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+        armor_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+    }
+
+    // 对比传统灯条检测与网络检测: 以网络检测结果为参考统计召回率与单帧耗时
+    LightbarDetectConfig lightbar_config;
+    if (compare_classical) lightbar_config = getLightbarDetectConfig();
+    double classical_time = 0.0, classical_recall = 0.0, network_time = 0.0;
+    int classical_frames = 0, classical_candidates = 0;
+
+    offline_mode_ = true;
+    init_pointer();
+    init_locater();
+    init_classifier();
+    init_tiler();
+
+    std::ofstream result(result_path);
+    if (!result.is_open()) {
+        rm::message("Failed to open result file: " + result_path, rm::MSG_ERROR);
+        return false;
+    }
+    result << std::fixed << std::setprecision(4);
+
+    std::cout << "[OFFLINE] " << video_path << " " << width << "x" << height << " @ " << video_fps << "fps" << std::endl;
+    std::cout << "[OFFLINE] BatchSize=" << batch_size << " Target=" << target << " -> " << result_path << std::endl;
+
+    size_t frame_floats = (size_t)3 * config.infer_height * config.infer_width;
+    int blob_size[] = {batch_size, 3, config.infer_height, config.infer_width};
+    cv::Mat armor_blob(4, blob_size, CV_32F);
+    bool batch_forward = (batch_size > 1);
+
+    std::vector<std::shared_ptr<rm::Frame>> batch;
+    int frame_count = 0, armor_count = 0, target_count = 0;
+    TimePoint tp_start = getTime();
+    TimePoint tp0, tp1, tp2, tp3, tp4;
+
+    while (g_running) {
+        batch.clear();
+        for (int i = 0; i < batch_size; i++) {
+            cv::Mat image;
+            if (!capture.read(image) || image.empty()) break;
+            auto frame = std::make_shared<rm::Frame>();
+            frame->image = std::make_shared<cv::Mat>(image);
+            frame->time_point = getTime();
+            frame->camera_id = 0;
+            frame->width = image.cols;
+            frame->height = image.rows;
+            frame->yaw = 0.f;
+            frame->pitch = 0.f;
+            frame->roll = 0.f;
+            batch.push_back(frame);
+        }
+        int n = (int)batch.size();
+        if (n == 0) break;
+
+        tp0 = getTime();
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                letterboxBlob(
+                    *batch[i]->image, armor_blob.ptr<float>() + i * frame_floats,
+                    config.infer_width, config.infer_height, swap_rb, pad_value, 1.f / 255.f);
+            }
+        });
+        tp1 = getTime();
+
+        // 整批推理，模型不支持动态 batch 时回退为逐帧推理
+        std::vector<float*> outputs(n, nullptr);
+        std::vector<cv::Mat> output_list;
+        if (batch_forward) {
+            cv::Mat output;
+            try {
+                armor_net.setInput(armor_blob);
+                output = armor_net.forward();
+            } catch (const cv::Exception&) {
+                batch_forward = false;
+            }
+            if (batch_forward && (output.dims < 2 || output.size[0] != batch_size)) batch_forward = false;
+            if (batch_forward) {
+                size_t output_floats = output.total() / batch_size;
+                for (int i = 0; i < n; i++) outputs[i] = output.ptr<float>() + i * output_floats;
+                output_list.push_back(output);
+            } else {
+                rm::message("Batch forward unsupported, fallback to batch 1", rm::MSG_WARNING);
+            }
+        }
+        if (!batch_forward) {
+            int single_size[] = {1, 3, config.infer_height, config.infer_width};
+            for (int i = 0; i < n; i++) {
+                cv::Mat single(4, single_size, CV_32F, armor_blob.ptr<float>() + i * frame_floats);
+                armor_net.setInput(single);
+                output_list.push_back(armor_net.forward().clone());
+                outputs[i] = output_list.back().ptr<float>();
+            }
+        }
+        tp2 = getTime();
+
+        // 解码与 pointer / locater 按帧并行，切片选择与分类器带跨帧状态，按帧序串行
+        std::atomic<bool> decode_ok{true};
+        std::vector<char> track_flag(n, 0);
+        std::vector<double> lightbar_time(n, 0.0), lightbar_recall(n, -1.0);
+        std::vector<int> lightbar_count(n, 0);
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                if (!yoloArmorNMS(
+                        yolo_type, batch[i]->yolo_list, outputs[i],
+                        config.bboxes_num, config.class_num, config.confidence_thresh, config.nms_thresh,
+                        batch[i]->width, batch[i]->height, config.infer_width, config.infer_height)) {
+                    decode_ok = false;
+                    continue;
+                }
+                if (compare_classical) {
+                    std::vector<rm::YoloRect> candidates;
+                    TimePoint tp_lb = getTime();
+                    lightbarDetect(*batch[i]->image, candidates, Data::enemy_color, lightbar_config);
+                    lightbar_time[i] = getDoubleOfS(tp_lb, getTime());
+                    lightbar_recall[i] = getYoloRecall(candidates, batch[i]->yolo_list, 0.3);
+                    lightbar_count[i] = candidates.size();
+                }
+            }
+        });
+        if (!decode_ok) {
+            rm::message("Invalid yolo type", rm::MSG_ERROR);
+            return false;
+        }
+        for (int i = 0; i < n; i++) tiler(batch[i]);
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                track_flag[i] = pointer(batch[i]);
+            }
+        });
+        for (int i = 0; i < n; i++) {
+            if (track_flag[i]) track_flag[i] = classifier(batch[i]);
+        }
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                if (track_flag[i]) locater(batch[i]);
+            }
+        });
+        tp3 = getTime();
+
+        for (int i = 0; i < n; i++) {
+            roi_cache_.release(*batch[i]);
+            writeOfflineResult(result, frame_count + i, batch[i]);
+            armor_count += batch[i]->armor_list.size();
+            target_count += batch[i]->target_list.size();
+        }
+        frame_count += n;
+        tp4 = getTime();
+
+        network_time += getDoubleOfS(tp0, tp2);
+        if (compare_classical) {
+            for (int i = 0; i < n; i++) {
+                classical_time += lightbar_time[i];
+                classical_candidates += lightbar_count[i];
+                if (lightbar_recall[i] < 0) continue;
+                classical_recall += lightbar_recall[i];
+                classical_frames++;
+            }
+            if (classical_frames > 0) rm::message("classical recall", classical_recall / classical_frames);
+        }
+
+        if (Data::pipeline_delay_flag) {
+            rm::message("offline letterbox", getDoubleOfS(tp0, tp1) * 1000);
+            rm::message("offline forward", getDoubleOfS(tp1, tp2) * 1000);
+            rm::message("offline track", getDoubleOfS(tp2, tp3) * 1000);
+        }
+        rm::message("offline frames", frame_count);
+        rm::message("offline fps", n / getDoubleOfS(tp0, tp4));
+    }
+    result.close();
+
+    double total_time = getDoubleOfS(tp_start, getTime());
+    double offline_fps = (total_time > 0) ? frame_count / total_time : 0.0;
+    std::cout << "[OFFLINE] frames=" << frame_count << " armors=" << armor_count
+              << " targets=" << target_count << std::endl;
+    std::cout << "[OFFLINE] " << total_time << "s, " << offline_fps << "fps";
+    if (video_fps > 0) std::cout << " (" << offline_fps / video_fps << "x realtime)";
+    std::cout << std::endl;
+    if (compare_classical && frame_count > 0) {
+        std::cout << "[OFFLINE] network " << network_time * 1000 / frame_count << "ms/frame, classical "
+                  << classical_time * 1000 / frame_count << "ms/frame, "
+                  << (double)classical_candidates / frame_count << " candidates/frame, recall "
+                  << ((classical_frames > 0) ? classical_recall / classical_frames : 0.0) << std::endl;
+    }
+    return true;
+}
@@ -1,61 +1,123 @@
 #include "threads/pipeline.h"
+#include "threads/pipeline/yolo.h"
 #include <atomic>
 extern std::atomic<bool> g_running;
 #include <unistd.h>
 #include <iostream>
+#include <cmath>
 #include <openrm/cudatools.h>
 
 using namespace rm;
 using namespace nvinfer1;
 using namespace nvonnxparser;
 
-void Pipeline::preprocessor_baseline_thread(
-    std::mutex& mutex_out, bool& flag_out, std::shared_ptr<rm::Frame>& frame_out
-) {
+// CPU 后端与离线模式的 letterboxBlob 需与 TensorRT 路径的 GPU resize 输出一致，启动时用同一幅测试图对比一次
+// 测试图为平滑渐变叠加噪声，避免定点与浮点插值的舍入差异在高频纹理上被放大
+static void checkLetterboxParity(float* input_device_buffer, int src_width, int src_height, int infer_width, int infer_height) {
+    auto param = Param::get_instance();
+    bool swap_rb        = (*param)["Model"]["YoloArmor"]["CPU"]["SwapRB"];
+    float pad_value     = (*param)["Model"]["YoloArmor"]["CPU"]["PadValue"];
+    double parity_thresh = (*param)["Model"]["YoloArmor"]["CPU"]["ParityThresh"];
+
+    cv::Mat src(src_height, src_width, CV_8UC3);
+    for (int y = 0; y < src_height; y++) {
+        uint8_t* row = src.ptr<uint8_t>(y);
+        for (int x = 0; x < src_width; x++) {
+            int noise = (x * 7919 + y * 104729) % 40;
+            row[x * 3 + 0] = (uint8_t)(x * 200 / src_width + noise);
+            row[x * 3 + 1] = (uint8_t)(y * 200 / src_height + noise);
+            row[x * 3 + 2] = (uint8_t)((x + y) * 200 / (src_width + src_height) + 39 - noise);
+        }
+    }
+
+    uint8_t* host_buffer = nullptr;
+    uint8_t* device_buffer = nullptr;
+    rm::mallocYoloCameraBuffer(&host_buffer, &device_buffer, src_width, src_height);
+    cudaStream_t stream;
+    if (!rm::initCudaStream(&stream)) {
+        rm::freeYoloCameraBuffer(host_buffer, device_buffer);
+        return;
+    }
+    memcpyYoloCameraBuffer(src.data, host_buffer, device_buffer, src_width, src_height);
+    resize(device_buffer, src_width, src_height, input_device_buffer, infer_width, infer_height, (void*)stream);
+    cudaStreamSynchronize(stream);
+
+    size_t size = (size_t)3 * infer_width * infer_height;
+    std::vector<float> device_blob(size), host_blob(size), swapped_blob(size);
+    cudaMemcpy(device_blob.data(), input_device_buffer, size * sizeof(float), cudaMemcpyDeviceToHost);
+    cudaStreamDestroy(stream);
+    rm::freeYoloCameraBuffer(host_buffer, device_buffer);
+
+    letterboxBlob(src, host_blob.data(), infer_width, infer_height, swap_rb, pad_value, 1.f / 255.f);
+    letterboxBlob(src, swapped_blob.data(), infer_width, infer_height, !swap_rb, pad_value, 1.f / 255.f);
+
+    double max_diff = 0.0, mean_diff = 0.0, swapped_diff = 0.0;
+    for (size_t i = 0; i < size; i++) {
+        double diff = std::fabs(device_blob[i] - host_blob[i]);
+        max_diff = std::max(max_diff, diff);
+        mean_diff += diff;
+        swapped_diff += std::fabs(device_blob[i] - swapped_blob[i]);
+    }
+    max_diff *= 255;
+    mean_diff = mean_diff * 255 / size;
+    swapped_diff = swapped_diff * 255 / size;
+
+    std::cout << "[LETTERBOX] 与 GPU resize 对比: 最大误差 " << max_diff << " 灰度级, 平均误差 " << mean_diff
+              << " 灰度级, 左上角 " << device_blob[0] * 255 << std::endl;
+    if (max_diff <= parity_thresh) return;
+
+    // 给出最可能的配置差异: 通道顺序、填充值或归一化系数
+    rm::message("Letterbox mismatch with TensorRT input", rm::MSG_WARNING);
+    if (swapped_diff < mean_diff) {
+        std::cout << "[LETTERBOX] 交换通道后平均误差 " << swapped_diff << " 灰度级，检查 CPU.SwapRB" << std::endl;
+    }
+    std::cout << "[LETTERBOX] GPU 输出左上角 " << device_blob[0] * 255 << ", CPU.PadValue=" << pad_value
+              << "，不一致时检查填充值、letterbox 对齐方式与归一化系数" << std::endl;
+}
+
+bool Pipeline::init_armor_model() {
     auto param = Param::get_instance();
-    auto garage = Garage::get_instance();
 
     std::string yolo_type   = (*param)["Model"]["YoloArmor"]["Type"];
     std::string onnx_file   = (*param)["Model"]["YoloArmor"][yolo_type]["DirONNX"];
     std::string engine_file = (*param)["Model"]["YoloArmor"][yolo_type]["DirEngine"];
-    
+    int  infer_width        = (*param)["Model"]["YoloArmor"][yolo_type]["InferWidth"];
+    int  infer_height       = (*param)["Model"]["YoloArmor"][yolo_type]["InferHeight"];
+    int  class_num          = (*param)["Model"]["YoloArmor"][yolo_type]["ClassNum"];
+    int  locate_num         = (*param)["Model"]["YoloArmor"][yolo_type]["LocateNum"];
+    int  color_num          = (*param)["Model"]["YoloArmor"][yolo_type]["ColorNum"];
+    int  bboxes_num         = (*param)["Model"]["YoloArmor"][yolo_type]["BboxesNum"];
 
-    int  infer_width     = (*param)["Model"]["YoloArmor"][yolo_type]["InferWidth"];
-    int  infer_height    = (*param)["Model"]["YoloArmor"][yolo_type]["InferHeight"];
-    int  class_num       = (*param)["Model"]["YoloArmor"][yolo_type]["ClassNum"];
-    int  locate_num      = (*param)["Model"]["YoloArmor"][yolo_type]["LocateNum"];
-    int  color_num       = (*param)["Model"]["YoloArmor"][yolo_type]["ColorNum"];
-    int  bboxes_num      = (*param)["Model"]["YoloArmor"][yolo_type]["BboxesNum"];
-    bool hist_input_flag = (*param)["Model"]["YoloArmor"][yolo_type]["NeedHist"];
+    std::string backend  = (*param)["Model"]["YoloArmor"]["Backend"];
+    bool cpu_backend     = (backend == "CPU" || backend == "Classical");
+    bool cascade_enabled = (*param)["Model"]["YoloArmor"]["Cascade"]["Enable"];
+    std::string far_type = (*param)["Model"]["YoloArmor"]["Cascade"]["FarType"];
 
-    std::cout << "[PREPROC] 配置: engine=" << engine_file << std::endl;
-    std::cout << "[PREPROC] infer=" << infer_width << "x" << infer_height 
-              << " class=" << class_num << " locate=" << locate_num 
-              << " bboxes=" << bboxes_num << std::endl;
+    if (cpu_backend) {
+        armor_model_ready_ = true;
+        return true;
+    }
 
     if (access(engine_file.c_str(), F_OK) == 0) {
         std::cout << "[PREPROC] 加载引擎文件..." << std::endl;
         if (!rm::initTrtEngine(engine_file, &armor_context_)) {
             std::cerr << "[PREPROC] 引擎加载失败!" << std::endl;
-            g_running = false;
-            return;
+            return false;
         }
         std::cout << "[PREPROC] 引擎加载成功, context=" << armor_context_ << std::endl;
     } else if (access(onnx_file.c_str(), F_OK) == 0){
         if (!rm::initTrtOnnx(onnx_file, engine_file, &armor_context_, 1U)) {
-            g_running = false;
-            return;
+            return false;
         }
     } else {
         rm::message("No model file found!", rm::MSG_ERROR);
-        g_running = false;
-        return;
+        return false;
     }
 
     size_t yolo_struct_size = sizeof(float) * static_cast<size_t>(locate_num + 1 + color_num + class_num);
     std::cout << "[PREPROC] yolo_struct_size=" << yolo_struct_size << " bytes (" 
               << (locate_num + 1 + color_num + class_num) << " floats)" << std::endl;
-    
+
     mallocYoloDetectBuffer(
         &armor_input_device_buffer_, 
         &armor_output_device_buffer_, 
@@ -65,6 +127,94 @@ void Pipeline::preprocessor_baseline_thread(
         yolo_struct_size,
         bboxes_num);
 
+    if (cascade_enabled) {
+        YoloConfig far_config = getYoloConfig(far_type);
+        bool far_loaded = false;
+        if (access(far_config.engine_file.c_str(), F_OK) == 0) {
+            far_loaded = rm::initTrtEngine(far_config.engine_file, &armor_far_context_);
+        } else if (access(far_config.onnx_file.c_str(), F_OK) == 0) {
+            far_loaded = rm::initTrtOnnx(far_config.onnx_file, far_config.engine_file, &armor_far_context_, 1U);
+        }
+
+        if (far_loaded) {
+            mallocYoloDetectBuffer(
+                &armor_far_input_device_buffer_,
+                &armor_far_output_device_buffer_,
+                &armor_far_output_host_buffer_,
+                far_config.infer_width,
+                far_config.infer_height,
+                far_config.yolo_struct_size,
+                far_config.bboxes_num);
+            std::cout << "[PREPROC] 远距离模型已加载: " << far_type << " "
+                      << far_config.infer_width << "x" << far_config.infer_height << std::endl;
+        } else {
+            rm::message("Cascade far model load failed", rm::MSG_WARNING);
+            armor_far_context_ = nullptr;
+        }
+    }
+
+    armor_model_ready_ = true;
+    return true;
+}
+
+void Pipeline::preprocessor_baseline_thread(
+    std::mutex& mutex_out, bool& flag_out, std::shared_ptr<rm::Frame>& frame_out
+) {
+    auto param = Param::get_instance();
+    auto garage = Garage::get_instance();
+
+    std::string yolo_type   = (*param)["Model"]["YoloArmor"]["Type"];
+    std::string engine_file = (*param)["Model"]["YoloArmor"][yolo_type]["DirEngine"];
+    
+
+    int  infer_width     = (*param)["Model"]["YoloArmor"][yolo_type]["InferWidth"];
+    int  infer_height    = (*param)["Model"]["YoloArmor"][yolo_type]["InferHeight"];
+    int  class_num       = (*param)["Model"]["YoloArmor"][yolo_type]["ClassNum"];
+    int  locate_num      = (*param)["Model"]["YoloArmor"][yolo_type]["LocateNum"];
+    int  color_num       = (*param)["Model"]["YoloArmor"][yolo_type]["ColorNum"];
+    int  bboxes_num      = (*param)["Model"]["YoloArmor"][yolo_type]["BboxesNum"];
+    bool hist_input_flag = (*param)["Model"]["YoloArmor"][yolo_type]["NeedHist"];
+
+    // CPU 与传统灯条检测后端的预处理与推理都在检测线程中完成，这里只负责取帧
+    std::string backend  = (*param)["Model"]["YoloArmor"]["Backend"];
+    bool cpu_backend     = (backend == "CPU" || backend == "Classical");
+
+    // 隔帧检测: 每 Interval 帧或检测线程请求时才上传并推理，Validate 模式下每帧都推理用于对比
+    bool skip_enabled    = (*param)["Model"]["YoloArmor"]["Skip"]["Enable"];
+    int  skip_interval   = (*param)["Model"]["YoloArmor"]["Skip"]["Interval"];
+    bool skip_validate   = (*param)["Model"]["YoloArmor"]["Skip"]["Validate"];
+    int  skip_count      = 0;
+
+    // 距离级联: 预加载远距离模型，由检测线程根据目标距离选择本帧使用的模型
+    bool cascade_enabled = (*param)["Model"]["YoloArmor"]["Cascade"]["Enable"];
+    std::string far_type = (*param)["Model"]["YoloArmor"]["Cascade"]["FarType"];
+    cascade_enabled = cascade_enabled && !cpu_backend;
+    int far_infer_width = 0, far_infer_height = 0;
+
+    std::cout << "[PREPROC] 配置: engine=" << engine_file << std::endl;
+    std::cout << "[PREPROC] infer=" << infer_width << "x" << infer_height 
+              << " class=" << class_num << " locate=" << locate_num 
+              << " bboxes=" << bboxes_num << std::endl;
+
+    // 模型与缓冲区通常已由启动编排预先加载，单独启动流水线时在此加载
+    if (!armor_model_ready_ && !init_armor_model()) {
+        g_running = false;
+        return;
+    }
+    if (cpu_backend) std::cout << "[PREPROC] 使用 CPU 后端" << std::endl;
+    if (!cpu_backend) {
+        Camera* camera = Data::camera[Data::camera_index];
+        checkLetterboxParity(armor_input_device_buffer_, camera->width, camera->height, infer_width, infer_height);
+    }
+
+    if (cascade_enabled && armor_far_context_ != nullptr) {
+        YoloConfig far_config = getYoloConfig(far_type);
+        far_infer_width = far_config.infer_width;
+        far_infer_height = far_config.infer_height;
+    } else {
+        cascade_enabled = false;
+    }
+
     std::cout << "[PREPROC] 缓冲区分配完成:" << std::endl;
     std::cout << "  input_device=" << armor_input_device_buffer_ << std::endl;
     std::cout << "  output_device=" << armor_output_device_buffer_ << std::endl;
@@ -115,31 +265,42 @@ void Pipeline::preprocessor_baseline_thread(
             }
         }
 
-        memcpyYoloCameraBuffer(
-            frame->image->data,
-            camera->rgb_host_buffer,
-            camera->rgb_device_buffer,
-            frame->width,
-            frame->height);
-        
-        resize(
-            camera->rgb_device_buffer,
-            frame->width,
-            frame->height,
-            armor_input_device_buffer_,
-            infer_width,
-            infer_height,
-            (void*)resize_stream_
-        );
-        
-        cudaStreamSynchronize(resize_stream_);
-        
-        detectEnqueue(
-            armor_input_device_buffer_,
-            armor_output_device_buffer_,
-            &armor_context_,
-            &detect_stream_
-        );
+        bool keyframe = true;
+        if (skip_enabled) {
+            skip_count++;
+            keyframe = force_detect_.exchange(false) || skip_count >= skip_interval;
+            if (keyframe) skip_count = 0;
+        }
+
+        bool far_model = cascade_enabled && cascade_far_;
+
+        if (!cpu_backend && (keyframe || skip_validate)) {
+            memcpyYoloCameraBuffer(
+                frame->image->data,
+                camera->rgb_host_buffer,
+                camera->rgb_device_buffer,
+                frame->width,
+                frame->height);
+            
+            resize(
+                camera->rgb_device_buffer,
+                frame->width,
+                frame->height,
+                far_model ? armor_far_input_device_buffer_ : armor_input_device_buffer_,
+                far_model ? far_infer_width : infer_width,
+                far_model ? far_infer_height : infer_height,
+                (void*)resize_stream_
+            );
+            
+            cudaStreamSynchronize(resize_stream_);
+            
+            detectEnqueue(
+                far_model ? armor_far_input_device_buffer_ : armor_input_device_buffer_,
+                far_model ? armor_far_output_device_buffer_ : armor_output_device_buffer_,
+                far_model ? &armor_far_context_ : &armor_context_,
+                &detect_stream_
+            );
+        }
 
         if (Data::record_mode) { record(frame); }
 
@@ -158,6 +319,8 @@ void Pipeline::preprocessor_baseline_thread(
         
         std::unique_lock<std::mutex> lock_out(mutex_out);
         frame_out = frame;
+        keyframe_register_ = keyframe;
+        far_model_register_ = far_model;
         flag_out = true;
     }
     std::cout << "[preprocessor_thread] Exiting..." << std::endl;
@@ -0,0 +1,238 @@
+#include "threads/pipeline.h"
+#include "threads/pipeline/yolo.h"
+#include <unistd.h>
+#include <iostream>
+#include <algorithm>
+#include <openrm/cudatools.h>
+
+using namespace rm;
+using namespace nvinfer1;
+using namespace nvonnxparser;
+
+static std::string yolo_type;
+static int    infer_width;
+static int    infer_height;
+static int    class_num;
+static int    bboxes_num;
+static double confidence_thresh;
+static double nms_thresh;
+static size_t yolo_struct_size;
+
+static std::vector<int> tile_states;
+static int    tile_budget;
+static double tile_overlap;
+static double tile_merge_thresh;
+static bool   tile_swap_rb;
+static float  tile_pad_value;
+
+static std::vector<cv::Rect> tile_list;
+static int tile_width = 0, tile_height = 0;
+static int tile_cursor = 0;
+static cv::Rect tile_focus;
+
+void Pipeline::init_tiler() {
+    auto param = Param::get_instance();
+
+    tile_enabled_ = (*param)["Model"]["YoloArmor"]["Tile"]["Enable"];
+    if (!tile_enabled_) return;
+
+    yolo_type         = (*param)["Model"]["YoloArmor"]["Type"];
+    infer_width       = (*param)["Model"]["YoloArmor"][yolo_type]["InferWidth"];
+    infer_height      = (*param)["Model"]["YoloArmor"][yolo_type]["InferHeight"];
+    class_num         = (*param)["Model"]["YoloArmor"][yolo_type]["ClassNum"];
+    bboxes_num        = (*param)["Model"]["YoloArmor"][yolo_type]["BboxesNum"];
+    confidence_thresh = (*param)["Model"]["YoloArmor"][yolo_type]["ConfThresh"];
+    nms_thresh        = (*param)["Model"]["YoloArmor"][yolo_type]["NMSThresh"];
+
+    int locate_num    = (*param)["Model"]["YoloArmor"][yolo_type]["LocateNum"];
+    int color_num     = (*param)["Model"]["YoloArmor"][yolo_type]["ColorNum"];
+    yolo_struct_size  = sizeof(float) * static_cast<size_t>(locate_num + 1 + color_num + class_num);
+
+    std::string onnx_file   = (*param)["Model"]["YoloArmor"][yolo_type]["DirONNX"];
+    std::string engine_file = (*param)["Model"]["YoloArmor"][yolo_type]["DirEngine"];
+
+    std::vector<int> temp_states = (*param)["Model"]["YoloArmor"]["Tile"]["States"];
+    tile_states       = temp_states;
+    tile_budget       = (*param)["Model"]["YoloArmor"]["Tile"]["TileBudget"];
+    tile_overlap      = (*param)["Model"]["YoloArmor"]["Tile"]["Overlap"];
+    tile_merge_thresh = (*param)["Model"]["YoloArmor"]["Tile"]["MergeThresh"];
+
+    // CPU 后端与离线模式: 切片与整帧推理一样走 letterboxBlob + cv::dnn，切片即网络输入尺寸，letterbox 不缩放
+    std::string backend = (*param)["Model"]["YoloArmor"]["Backend"];
+    tile_dnn_ = (backend == "CPU") || offline_mode_;
+    if (tile_dnn_) {
+        tile_swap_rb   = (*param)["Model"]["YoloArmor"]["CPU"]["SwapRB"];
+        tile_pad_value = (*param)["Model"]["YoloArmor"]["CPU"]["PadValue"];
+        try {
+            tile_net_ = cv::dnn::readNetFromONNX(onnx_file);
+        } catch (const cv::Exception& e) {
+            rm::message("Tiler model load failed: " + std::string(e.what()), rm::MSG_ERROR);
+            tile_enabled_ = false;
+            return;
+        }
+        std::string target = offline_mode_ ? (std::string)(*param)["Debug"]["Offline"]["Target"] : "CPU";
+        if (target == "CUDA") {
+            tile_net_.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
+            tile_net_.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
+        } else {
+            tile_net_.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+            tile_net_.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+        }
+        int blob_size[] = {1, 3, infer_height, infer_width};
+        tile_blob_.create(4, blob_size, CV_32F);
+        std::cout << "[TILER] 切片推理已启用 (cv::dnn), budget=" << tile_budget << " overlap=" << tile_overlap << std::endl;
+        return;
+    }
+
+    // 切片推理与主流水线并行，需要独立的执行上下文与缓冲区
+    if (!rm::initCudaStream(&tile_stream_)) {
+        rm::message("Tiler cuda stream init failed", rm::MSG_ERROR);
+        tile_enabled_ = false;
+        return;
+    }
+
+    if (access(engine_file.c_str(), F_OK) == 0) {
+        if (!rm::initTrtEngine(engine_file, &tile_context_)) tile_enabled_ = false;
+    } else if (access(onnx_file.c_str(), F_OK) == 0) {
+        if (!rm::initTrtOnnx(onnx_file, engine_file, &tile_context_, 1U)) tile_enabled_ = false;
+    } else {
+        tile_enabled_ = false;
+    }
+    if (!tile_enabled_) {
+        rm::message("Tiler model load failed", rm::MSG_ERROR);
+        return;
+    }
+
+    // 切片尺寸即网络输入尺寸，相机缓冲区按切片大小申请
+    rm::mallocYoloCameraBuffer(&tile_host_buffer_, &tile_device_buffer_, infer_width, infer_height);
+    rm::mallocYoloDetectBuffer(
+        &tile_input_device_buffer_,
+        &tile_output_device_buffer_,
+        &tile_output_host_buffer_,
+        infer_width,
+        infer_height,
+        yolo_struct_size,
+        bboxes_num);
+
+    std::cout << "[TILER] 切片推理已启用, budget=" << tile_budget << " overlap=" << tile_overlap << std::endl;
+}
+
+// 选择本帧需要推理的切片：优先覆盖上一帧的前哨站/基地，其余切片在连续帧间轮转
+static std::vector<cv::Rect> selectTiles() {
+    std::vector<cv::Rect> selected;
+    int budget = std::min<int>(tile_budget, tile_list.size());
+
+    if (tile_focus.area() > 0 && budget > 0) {
+        cv::Point center(tile_focus.x + tile_focus.width / 2, tile_focus.y + tile_focus.height / 2);
+        cv::Rect best;
+        double best_dist = 1e9;
+        for (const auto& tile : tile_list) {
+            cv::Point tile_center(tile.x + tile.width / 2, tile.y + tile.height / 2);
+            double dist = std::hypot(center.x - tile_center.x, center.y - tile_center.y);
+            if (tile.contains(center) && dist < best_dist) {
+                best = tile;
+                best_dist = dist;
+            }
+        }
+        if (best.area() > 0) selected.push_back(best);
+    }
+
+    for (int i = 0; i < (int)tile_list.size() && (int)selected.size() < budget; i++) {
+        const cv::Rect& tile = tile_list[tile_cursor];
+        tile_cursor = (tile_cursor + 1) % tile_list.size();
+        if (std::find(selected.begin(), selected.end(), tile) == selected.end()) {
+            selected.push_back(tile);
+        }
+    }
+    return selected;
+}
+
+bool Pipeline::tiler(std::shared_ptr<rm::Frame> frame) {
+    if (!tile_enabled_) return false;
+    // 录像没有裁判系统状态，离线模式下不按状态筛选
+    if (!offline_mode_ && std::find(tile_states.begin(), tile_states.end(), (int)Data::state) == tile_states.end()) {
+        return false;
+    }
+
+    TimePoint tp1 = getTime();
+
+    if (tile_list.empty() || tile_width != frame->width || tile_height != frame->height) {
+        tile_list = getYoloTiles(frame->width, frame->height, infer_width, infer_height, tile_overlap);
+        tile_width = frame->width;
+        tile_height = frame->height;
+        tile_cursor = 0;
+    }
+
+    std::vector<cv::Rect> selected = selectTiles();
+    std::vector<rm::YoloRect> tile_yolo_list;
+
+    for (const auto& tile : selected) {
+        float* output_host_buffer = tile_output_host_buffer_;
+        cv::Mat tile_output;
+        if (tile_dnn_) {
+            letterboxBlob(
+                (*frame->image)(tile), tile_blob_.ptr<float>(), infer_width, infer_height,
+                tile_swap_rb, tile_pad_value, 1.f / 255.f);
+            tile_net_.setInput(tile_blob_);
+            tile_output = tile_net_.forward();
+            output_host_buffer = tile_output.ptr<float>();
+        } else {
+            // 切片需要连续内存才能拷贝到显存
+            cv::Mat tile_image = (*frame->image)(tile).clone();
+
+            memcpyYoloCameraBuffer(
+                tile_image.data,
+                tile_host_buffer_,
+                tile_device_buffer_,
+                tile.width,
+                tile.height);
+
+            resize(
+                tile_device_buffer_,
+                tile.width,
+                tile.height,
+                tile_input_device_buffer_,
+                infer_width,
+                infer_height,
+                (void*)tile_stream_
+            );
+            cudaStreamSynchronize(tile_stream_);
+
+            detectEnqueue(
+                tile_input_device_buffer_,
+                tile_output_device_buffer_,
+                &tile_context_,
+                &tile_stream_
+            );
+
+            detectOutput(
+                tile_output_host_buffer_,
+                tile_output_device_buffer_,
+                &tile_stream_,
+                yolo_struct_size,
+                bboxes_num
+            );
+        }
+
+        std::vector<rm::YoloRect> yolo_list;
+        yoloArmorNMS(
+            yolo_type, yolo_list, output_host_buffer, bboxes_num, class_num,
+            confidence_thresh, nms_thresh, tile.width, tile.height, infer_width, infer_height);
+
+        for (auto& yolo_rect : yolo_list) {
+            offsetYoloRect(yolo_rect, tile.tl());
+            tile_yolo_list.push_back(yolo_rect);
+        }
+    }
+
+    frame->yolo_list.insert(frame->yolo_list.end(), tile_yolo_list.begin(), tile_yolo_list.end());
+    mergeYoloRects(frame->yolo_list, tile_merge_thresh);
+
+    // 记录置信度最高的检测框，下一帧优先推理其所在切片
+    tile_focus = frame->yolo_list.empty() ? cv::Rect() : frame->yolo_list.front().box;
+
+    TimePoint tp2 = getTime();
+    rm::message("tile count", (int)selected.size());
+    if (Data::pipeline_delay_flag) rm::message("tile time", getDoubleOfS(tp1, tp2) * 1000);
+    return true;
+}
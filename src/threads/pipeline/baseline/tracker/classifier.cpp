@@ -8,9 +8,67 @@ using namespace rm;
 using namespace nvinfer1;
 using namespace nvonnxparser;
 
+// 分类缓存: 与上一帧同一 YOLO 类别且空间连续的检测框直接沿用数字结果
+struct ClassifyCache {
+    cv::Rect box;
+    int yolo_class;
+    int class_id;
+    float confidence;
+    int age;
+};
+
+static bool cache_enabled = false;
+static double cache_iou_thresh;
+static int cache_refresh_frames;
+static double cache_confidence_ratio;
+static double cache_min_prob;
+
+static std::vector<ClassifyCache> classify_cache;
+static long long cache_hit_count = 0;
+static long long cache_total_count = 0;
+static double roi_time_avg = 0.0;
+
+// 录制模式下保存 TensorRT 路径的分类器输入，供 Native 后端启动校验使用
+static std::string patch_dir;
+static int patch_record_left = 0;
+
+static double getRectIoU(const cv::Rect& a, const cv::Rect& b) {
+    double inter = (a & b).area();
+    double uni = a.area() + b.area() - inter;
+    return (uni > 0) ? inter / uni : 0.0;
+}
+
+// 读取录制的分类器输入 (pointer 裁剪缩放后的 BGR patch)，目录为空时退化为随机纹理
+static std::vector<cv::Mat> loadClassifyPatches(int samples, int width, int height) {
+    std::vector<cv::Mat> patches;
+    std::vector<cv::String> files;
+    if (!patch_dir.empty() && access(patch_dir.c_str(), F_OK) == 0) cv::glob(patch_dir + "/*.png", files);
+    for (const auto& file : files) {
+        if ((int)patches.size() >= samples) break;
+        cv::Mat patch = cv::imread(file, cv::IMREAD_COLOR);
+        if (patch.empty()) continue;
+        if (patch.cols != width || patch.rows != height) cv::resize(patch, patch, cv::Size(width, height));
+        patches.push_back(patch);
+    }
+    if (patches.empty()) {
+        std::cout << "[CLASSIFIER] 警告: 未找到录制的分类器输入 " << patch_dir << "，使用随机纹理校验" << std::endl;
+        cv::RNG rng(2024);
+        for (int n = 0; n < samples; n++) {
+            cv::Mat patch(height, width, CV_8UC3);
+            rng.fill(patch, cv::RNG::UNIFORM, 0, 256);
+            patches.push_back(patch);
+        }
+    }
+    return patches;
+}
+
 void Pipeline::init_classifier() {
     auto param = Param::get_instance();
 
+    // 启动编排中已预先加载时直接返回
+    if (classifier_initialized_) return;
+    classifier_initialized_ = true;
+
     std::cout << "[CLASSIFIER] 初始化数字分类器..." << std::endl;
 
     // 检查是否启用分类器
@@ -32,6 +90,16 @@ void Pipeline::init_classifier() {
     std::cout << "[CLASSIFIER] 输入尺寸: " << classifier_infer_width_ << "x" << classifier_infer_height_ << std::endl;
     std::cout << "[CLASSIFIER] 类别数: " << classifier_class_num_ << std::endl;
 
+    cache_enabled          = (*param)["Model"]["Classifier"]["Cache"]["Enable"];
+    cache_iou_thresh       = (*param)["Model"]["Classifier"]["Cache"]["IoUThresh"];
+    cache_refresh_frames   = (*param)["Model"]["Classifier"]["Cache"]["RefreshFrames"];
+    cache_confidence_ratio = (*param)["Model"]["Classifier"]["Cache"]["ConfidenceRatio"];
+    cache_min_prob         = (*param)["Model"]["Classifier"]["Cache"]["MinProb"];
+
+    std::string temp_patch_dir = (*param)["Model"]["Classifier"]["Native"]["PatchDir"];
+    patch_dir = temp_patch_dir;
+    patch_record_left = (*param)["Model"]["Classifier"]["Native"]["ParitySamples"];
+
     // 初始化 CUDA 流
     if (!rm::initCudaStream(&classifier_stream_)) {
         std::cout << "[CLASSIFIER] 错误: 无法初始化 CUDA 流" << std::endl;
@@ -76,6 +144,45 @@ void Pipeline::init_classifier() {
         classifier_class_num_
     );
 
+    // CPU 后端: 进程内直接推理，省去每个 ROI 的拷贝、启动与同步
+    // 以 TensorRT 在录制的分类器输入上的输出为参考做一致性校验，失败时保持 TensorRT 推理
+    std::string backend = (*param)["Model"]["Classifier"]["Backend"];
+    if (backend == "Native") {
+        double scale          = (*param)["Model"]["Classifier"]["Native"]["Scale"];
+        bool swap_rb          = (*param)["Model"]["Classifier"]["Native"]["SwapRB"];
+        int parity_samples    = (*param)["Model"]["Classifier"]["Native"]["ParitySamples"];
+        double parity_thresh  = (*param)["Model"]["Classifier"]["Native"]["ParityThresh"];
+
+        std::vector<cv::Mat> patches = loadClassifyPatches(
+            parity_samples, classifier_infer_width_, classifier_infer_height_);
+        auto reference = [&](const cv::Mat& patch, float* output) {
+            rm::memcpyClassifyBuffer(
+                patch.data,
+                classifier_input_host_buffer_,
+                classifier_input_device_buffer_,
+                classifier_infer_width_,
+                classifier_infer_height_);
+            rm::detectEnqueue(
+                classifier_input_device_buffer_, classifier_output_device_buffer_,
+                &classifier_context_, &classifier_stream_);
+            rm::detectOutputClassify(
+                classifier_output_host_buffer_, classifier_output_device_buffer_,
+                &classifier_stream_, classifier_class_num_);
+            std::copy(classifier_output_host_buffer_, classifier_output_host_buffer_ + classifier_class_num_, output);
+        };
+
+        if (classifier_native_.load(onnx_file, classifier_infer_width_, classifier_infer_height_, scale, swap_rb)
+            && classifier_native_.classNum() == classifier_class_num_
+            && classifier_native_.parity(patches, reference) <= parity_thresh) {
+            classifier_native_output_.assign(classifier_class_num_, 0.f);
+            classifier_native_enabled_ = true;
+            if (Data::benchmark_flag) classifier_native_.benchmark(1000);
+            std::cout << "[CLASSIFIER] ✓ 数字分类器初始化完成 (Native 后端)" << std::endl;
+            return;
+        }
+        std::cout << "[CLASSIFIER] 警告: Native 后端与 TensorRT 不一致，使用 TensorRT" << std::endl;
+    }
+
     std::cout << "[CLASSIFIER] ✓ 数字分类器初始化完成!" << std::endl;
     std::cout << "[CLASSIFIER]   模型: number_classifier.onnx" << std::endl;
     std::cout << "[CLASSIFIER]   输入: " << classifier_infer_width_ << "x" << classifier_infer_height_ << std::endl;
@@ -84,6 +191,8 @@ void Pipeline::init_classifier() {
 
 bool Pipeline::classifier(std::shared_ptr<rm::Frame> frame) {
     if (frame->yolo_list.empty()) {
+        // 检测中断即视为空间连续性中断，缓存不跨越无检测的帧
+        classify_cache.clear();
         return true;  // 没有检测到装甲板，返回 true 继续流程
     }
 
@@ -99,67 +208,123 @@ bool Pipeline::classifier(std::shared_ptr<rm::Frame> frame) {
     }
 
     // 如果分类器未启用，直接返回（color_id 已设置）
-    if (!classifier_enabled_ || classifier_context_ == nullptr) {
+    if (!classifier_enabled_ || (classifier_context_ == nullptr && !classifier_native_enabled_)) {
         return true;
     }
 
+    // 按空间连续性复用上一帧的分类结果，命中时跳过推理
+    std::vector<ClassifyCache> next_cache;
+    std::vector<bool> cache_used(classify_cache.size(), false);    // 每条缓存每帧至多被一个检测框沿用
+    int hit_count = 0;
+    int run_count = 0;
+    double run_time = 0.0;
+
+    // 分类器输入取自 pointer 登记的检测框 ROI，已取得时不再裁剪缩放
+    FrameRois* rois = roi_cache_.find(*frame);
+    if (rois == nullptr) rois = &roi_cache_.acquire(*frame);
+    cv::Size patch_size(classifier_infer_width_, classifier_infer_height_);
+
     // 对每个检测到的装甲板进行数字分类
-    for (auto& yolo_rect : frame->yolo_list) {
-        // 使用 box 获取 ROI 区域，稍微扩展一下
-        cv::Rect roi_rect = yolo_rect.box;
-        
-        int padding = 5;
-        roi_rect.x = std::max(0, roi_rect.x - padding);
-        roi_rect.y = std::max(0, roi_rect.y - padding);
-        roi_rect.width = std::min(frame->width - roi_rect.x, roi_rect.width + 2 * padding);
-        roi_rect.height = std::min(frame->height - roi_rect.y, roi_rect.height + 2 * padding);
-        
-        if (roi_rect.width <= 0 || roi_rect.height <= 0) {
+    for (size_t i = 0; i < frame->yolo_list.size(); i++) {
+        auto& yolo_rect = frame->yolo_list[i];
+        int yolo_class = yolo_rect.class_id;
+
+        if (cache_enabled) {
+            int matched = -1;
+            double best_iou = cache_iou_thresh;
+            for (size_t k = 0; k < classify_cache.size(); k++) {
+                const auto& cache = classify_cache[k];
+                if (cache_used[k] || cache.yolo_class != yolo_class) continue;
+                double iou = getRectIoU(cache.box, yolo_rect.box);
+                if (iou >= best_iou) {
+                    best_iou = iou;
+                    matched = (int)k;
+                }
+            }
+            if (matched >= 0
+                && classify_cache[matched].age < cache_refresh_frames
+                && yolo_rect.confidence >= classify_cache[matched].confidence * cache_confidence_ratio) {
+                cache_used[matched] = true;
+                ClassifyCache cache = classify_cache[matched];
+                cache.box = yolo_rect.box;
+                cache.age++;
+                next_cache.push_back(cache);
+                yolo_rect.class_id = cache.class_id;
+                hit_count++;
+                continue;
+            }
+        }
+
+        TimePoint tp0 = getTime();
+
+        // box 稍微扩展后缩放到分类器输入尺寸
+        const cv::Mat& resized_roi = (*rois)[i].patch(patch_size, classifier_padding_);
+        if (resized_roi.empty()) {
             continue;
         }
 
-        // 提取 ROI 并调整大小
-        cv::Mat roi = (*frame->image)(roi_rect);
-        cv::Mat resized_roi;
-        cv::resize(roi, resized_roi, cv::Size(classifier_infer_width_, classifier_infer_height_));
-
-        // 将图像数据复制到分类器缓冲区
-        rm::memcpyClassifyBuffer(
-            resized_roi.data,
-            classifier_input_host_buffer_,
-            classifier_input_device_buffer_,
-            classifier_infer_width_,
-            classifier_infer_height_
-        );
-
-        // 执行推理
-        rm::detectEnqueue(
-            classifier_input_device_buffer_,
-            classifier_output_device_buffer_,
-            &classifier_context_,
-            &classifier_stream_
-        );
-
-        // 获取输出
-        rm::detectOutputClassify(
-            classifier_output_host_buffer_,
-            classifier_output_device_buffer_,
-            &classifier_stream_,
-            classifier_class_num_
-        );
+        float* output = classifier_output_host_buffer_;
+        if (classifier_native_enabled_) {
+            output = classifier_native_output_.data();
+            classifier_native_.forward(resized_roi, output);
+        } else {
+            // 将图像数据复制到分类器缓冲区
+            rm::memcpyClassifyBuffer(
+                resized_roi.data,
+                classifier_input_host_buffer_,
+                classifier_input_device_buffer_,
+                classifier_infer_width_,
+                classifier_infer_height_
+            );
+
+            // 执行推理
+            rm::detectEnqueue(
+                classifier_input_device_buffer_,
+                classifier_output_device_buffer_,
+                &classifier_context_,
+                &classifier_stream_
+            );
+
+            // 获取输出
+            rm::detectOutputClassify(
+                classifier_output_host_buffer_,
+                classifier_output_device_buffer_,
+                &classifier_stream_,
+                classifier_class_num_
+            );
+
+            if (Data::record_mode && patch_record_left > 0 && access(patch_dir.c_str(), F_OK) == 0) {
+                cv::imwrite(patch_dir + "/" + std::to_string(patch_record_left--) + ".png", resized_roi);
+            }
+        }
 
         // 找到最大概率的类别
         int max_class = 0;
-        float max_prob = classifier_output_host_buffer_[0];
+        float max_prob = output[0];
         for (int i = 1; i < classifier_class_num_; i++) {
-            if (classifier_output_host_buffer_[i] > max_prob) {
-                max_prob = classifier_output_host_buffer_[i];
+            if (output[i] > max_prob) {
+                max_prob = output[i];
                 max_class = i;
             }
         }
 
+        TimePoint tp1 = getTime();
+        run_time += getDoubleOfS(tp0, tp1);
+        run_count++;
+
         // 更新 yolo_rect 的类别 ID（使用分类器结果）
         yolo_rect.class_id = max_class;
+
+        // 分类置信度足够时才写入缓存，低置信度结果下一帧重新推理
+        if (cache_enabled && max_prob >= cache_min_prob) {
+            ClassifyCache cache;
+            cache.box = yolo_rect.box;
+            cache.yolo_class = yolo_class;
+            cache.class_id = max_class;
+            cache.confidence = yolo_rect.confidence;
+            cache.age = 0;
+            next_cache.push_back(cache);
+        }
         
         // 打印分类结果（调试用）
         if (Data::pipeline_delay_flag) {
@@ -168,6 +333,24 @@ bool Pipeline::classifier(std::shared_ptr<rm::Frame> frame) {
                       << max_class << " (置信度: " << max_prob << ")" << std::endl;
         }
     }
+    classify_cache.swap(next_cache);
+
+    // 单 ROI 推理耗时用滑动平均估计，命中缓存节省的时间按该均值折算
+    if (run_count > 0) {
+        double roi_time = run_time / run_count;
+        roi_time_avg = (roi_time_avg > 0.0) ? 0.9 * roi_time_avg + 0.1 * roi_time : roi_time;
+    }
+    if (cache_enabled) {
+        cache_total_count += hit_count + run_count;
+        cache_hit_count += hit_count;
+        if (cache_total_count > 0) {
+            rm::message("classifier cache hit", (double)cache_hit_count / cache_total_count);
+        }
+    }
+    if (Data::pipeline_delay_flag) {
+        if (run_count > 0) rm::message("classifier roi time", run_time * 1000 / run_count);
+        if (cache_enabled) rm::message("classifier saved time", hit_count * roi_time_avg * 1000);
+    }
 
     return true;
 }
@@ -1,11 +1,27 @@
 #include "threads/pipeline.h"
 #include "garage/garage.h"
+#include "threads/pipeline/scratch.h"
+#include "threads/pipeline/planar_pnp.h"
+#include "data_manager/undistort.h"
+#include "threads/pipeline/yaw_pnp.h"
+#include <iostream>
 
 static std::vector<cv::Point3f>* BigArmorRed3D, *SmallArmorRed3D;
 static std::vector<cv::Point3f>* BigArmorBlue3D, *SmallArmorBlue3D;
 static bool   plus_pnp_cost_image;
 static double plus_pnp_cost_ratio;
 
+static bool   planar_enabled;
+static bool   planar_validate;
+static std::vector<PnPCamera> planar_cameras;
+static std::vector<bool> planar_passed;     // 启动一致性检查通过的相机
+static PnPCamera normalized_camera;
+
+static bool   yaw_search_enabled;
+static bool   yaw_search_validate;
+static double yaw_search_max_interval;
+static YawSearchParam yaw_search_param;
+
 void Pipeline::init_locater() {
     auto param = Param::get_instance();
 
@@ -51,13 +67,72 @@ void Pipeline::init_locater() {
     SmallArmorBlue3D->emplace_back(smallArmorBlue_width / 2, -smallArmorBlue_height / 2, 0);
     SmallArmorBlue3D->emplace_back(-smallArmorBlue_width / 2, smallArmorBlue_height / 2, 0);
     SmallArmorBlue3D->emplace_back(smallArmorBlue_width / 2, smallArmorBlue_height / 2, 0);
+
+    // 四点平面 PnP 闭式解，相机含高阶畸变项时该相机回退到 cv::solvePnP
+    planar_enabled  = (*param)["Points"]["PnP"]["Planar"]["Enable"];
+    planar_validate = (*param)["Points"]["PnP"]["Planar"]["Validate"];
+    double planar_parity_angle = (*param)["Points"]["PnP"]["Planar"]["ParityAngle"];
+    double planar_parity_trans = (*param)["Points"]["PnP"]["Planar"]["ParityTrans"];
+    planar_cameras.clear();
+    planar_passed.clear();
+    for (auto camera : Data::camera) {
+        planar_cameras.push_back(getPnPCamera(camera));
+
+        // 在合成位姿上与 OpenCV IPPE 比较，偏差超限的相机回退到 cv::solvePnP
+        // 含高阶畸变项的相机只在有去畸变表时经归一化平面使用闭式解，此处不检查
+        bool passed = true;
+        if (planar_enabled && planar_cameras.back().supported) {
+            double max_angle, max_trans;
+            passed = checkPlanarPnP(camera, *SmallArmorRed3D, max_angle, max_trans)
+                  && max_angle <= planar_parity_angle && max_trans <= planar_parity_trans;
+            if (!passed) {
+                std::cout << "[PLANAR-PNP] 与 OpenCV IPPE 偏差超限 (" << max_angle << " deg / " << max_trans
+                          << ")，该相机回退到 cv::solvePnP" << std::endl;
+            }
+        }
+        planar_passed.push_back(passed);
+    }
+
+    // 查表去畸变后的点已在单位内参、无畸变的归一化平面上
+    normalized_camera = PnPCamera();
+    normalized_camera.supported = true;
+
+    // PlusPnP 的偏航搜索，以 Garage 中同 ID 上一次观测的偏航热启动
+    yaw_search_enabled      = (*param)["Points"]["PnP"]["YawSearch"]["Enable"];
+    yaw_search_validate     = (*param)["Points"]["PnP"]["YawSearch"]["Validate"];
+    yaw_search_max_interval = (*param)["Points"]["PnP"]["YawSearch"]["MaxInterval"];
+    yaw_search_param.armor_pitch    = (*param)["Points"]["PnP"]["YawSearch"]["ArmorPitch"];
+    yaw_search_param.warm_window    = (*param)["Points"]["PnP"]["YawSearch"]["WarmWindow"];
+    yaw_search_param.tolerance      = (*param)["Points"]["PnP"]["YawSearch"]["Tolerance"];
+    yaw_search_param.max_iterations = (*param)["Points"]["PnP"]["YawSearch"]["MaxIterations"];
+    double yaw_search_parity = (*param)["Points"]["PnP"]["YawSearch"]["ParityThresh"];
+
+    // 在合成位姿上与 rm::solveYawPnP 比较，任一相机偏差超限时整体回退到 OpenRM
+    for (auto camera : Data::camera) {
+        if (!yaw_search_enabled || camera == nullptr) break;
+        double max_diff;
+        if (!checkYawPnP(camera, *SmallArmorRed3D, yaw_search_param, max_diff) || max_diff > yaw_search_parity) {
+            std::cout << "[YAW-PNP] 与 rm::solveYawPnP 偏航偏差超限 (" << max_diff
+                      << " deg)，回退到 rm::solveYawPnP" << std::endl;
+            yaw_search_enabled = false;
+        }
+    }
+
+    if (Data::benchmark_flag && !Data::camera.empty() && Data::camera[0] != nullptr) {
+        benchmarkPlanarPnP(Data::camera[0], *SmallArmorRed3D, 100);
+        benchmarkUndistortMap(0, 10000);
+        benchmarkYawPnP(Data::camera[0], *SmallArmorRed3D, yaw_search_param, 100);
+    }
 }
 
 bool Pipeline::locater(std::shared_ptr<rm::Frame> frame) {
     auto garage = Garage::get_instance();
     
-    cv::Mat rvec, tvec, rotate_cv;
-    std::vector<cv::Point3f> *Armor3D;
+    TrackerScratch& scratch = TrackerScratch::local();
+    cv::Mat& rvec = scratch.rvec;
+    cv::Mat& tvec = scratch.tvec;
+    cv::Mat& rotate_cv = scratch.rotate_cv;
+    const std::vector<cv::Point3f> *Armor3D;
 
     Eigen::Vector4d pose_pnp, pose_head, pose_world;
     Eigen::Matrix3d rotate_pnp, rotate_world;
@@ -74,7 +149,19 @@ bool Pipeline::locater(std::shared_ptr<rm::Frame> frame) {
     rm::tf_trans_head2world(trans_head2world, frame->yaw, frame->pitch, frame->roll);
 
 
-    for(auto& armor : frame->armor_list) {
+    // 先为每块装甲板选定模型点，非 PlusPnP 模式下一帧内的装甲板一次求解
+    std::vector<PlanarPnPInput>& pnp_inputs = scratch.pnp_inputs;
+    std::vector<PlanarPose>& pnp_poses = scratch.pnp_poses;
+    pnp_inputs.clear();
+
+    // 有去畸变表时四点先查表到归一化平面，rm::solveYawPnP 仍使用原始像素点
+    const UndistortMap* undistort_map = getUndistortMap(frame->camera_id);
+    std::vector<std::vector<cv::Point2f>>& normalized_points = scratch.normalized_points;
+    if (normalized_points.size() < frame->armor_list.size()) normalized_points.resize(frame->armor_list.size());
+
+    for(size_t i = 0; i < frame->armor_list.size(); i++) {
+        auto& armor = frame->armor_list[i];
+        pnp_inputs.push_back({nullptr, &armor.four_points});
         if(armor.four_points.size() != 4) { 
             continue;
         }
@@ -96,23 +183,100 @@ bool Pipeline::locater(std::shared_ptr<rm::Frame> frame) {
         } else {
             continue;
         }
+        pnp_inputs.back().object = Armor3D;
+
+        if (undistort_map != nullptr) {
+            undistort_map->lookup(armor.four_points, normalized_points[i]);
+            pnp_inputs.back().image = &normalized_points[i];
+        }
+    }
+
+    bool planar_frame = planar_enabled && !Data::plus_pnp
+        && frame->camera_id < (int)planar_cameras.size() && planar_passed[frame->camera_id]
+        && (undistort_map != nullptr || planar_cameras[frame->camera_id].supported);
+    if (planar_frame) {
+        const PnPCamera& pnp_camera = undistort_map ? normalized_camera : planar_cameras[frame->camera_id];
+        TimePoint tp1 = getTime();
+        solvePlanarPnP(pnp_camera, pnp_inputs, pnp_poses);
+        TimePoint tp2 = getTime();
+        if (Data::pipeline_delay_flag) rm::message("planar pnp", getDoubleOfS(tp1, tp2) * 1000);
+    }
+
+    for (size_t i = 0; i < frame->armor_list.size(); i++) {
+        auto& armor = frame->armor_list[i];
+        Armor3D = pnp_inputs[i].object;
+        if (Armor3D == nullptr) continue;
 
         rm::Target target;
         target.armor_id = armor.id;
         target.armor_size = armor.size;
 
-        if (Data::plus_pnp) {
+        if (Data::plus_pnp && yaw_search_enabled && !plus_pnp_cost_image) {
+            std::vector<cv::Point2f>& normalized = normalized_points[i];
+            if (undistort_map == nullptr) {
+                cv::undistortPoints(armor.four_points, normalized, camera->intrinsic_matrix, camera->distortion_coeffs);
+            }
+
+            // 离线模式下各帧并行定位，不使用跨帧热启动
+            const double* warm_yaw = nullptr;
+            auto objptr = garage->getObj(armor.id);
+            double interval = getDoubleOfS(objptr->last_t_, frame->time_point);
+            if (!offline_mode_ && interval >= 0 && interval < yaw_search_max_interval) warm_yaw = &objptr->last_yaw_;
+
+            TimePoint tp1 = getTime();
+            YawPose yaw_pose = searchArmorYaw(*Armor3D, normalized, rotate_head2world * rotate_pnp2head, yaw_search_param, warm_yaw);
+            TimePoint tp2 = getTime();
+            if (Data::pipeline_delay_flag) rm::message("yaw pnp", getDoubleOfS(tp1, tp2) * 1000);
+            rm::message("yaw pnp iters", yaw_pose.iterations);
+            rm::message("yaw pnp warm", yaw_pose.warm);
+
+            if (yaw_pose.valid) {
+                target.armor_yaw_world = yaw_pose.armor_yaw;
+                pose_pnp << yaw_pose.translation, 1.0;
+                target.pose_world = trans_head2world * trans_pnp2head * pose_pnp;
+            }
+
+            // 校验模式下与 OpenRM 的偏航搜索对比并输出其结果，搜索失败时同样采用其结果
+            if (yaw_search_validate || !yaw_pose.valid) {
+                double armor_yaw = rm::solveYawPnP(
+                    frame->yaw, camera, pose_world, *Armor3D, armor.four_points,
+                    rotate_head2world, trans_head2world, armor.id, false);
+                if (yaw_pose.valid) {
+                    double yaw_diff = std::remainder(yaw_pose.armor_yaw - armor_yaw, 2 * M_PI);
+                    rm::message("yaw pnp diff", std::fabs(yaw_diff) * 180.0 / M_PI);
+                    rm::message("yaw pnp dist diff", (target.pose_world - pose_world).head<3>().norm());
+                }
+                target.armor_yaw_world = armor_yaw;
+                target.pose_world = pose_world;
+            }
+
+        } else if (Data::plus_pnp) {
             target.armor_yaw_world = rm::solveYawPnP(
                 frame->yaw, camera, pose_world, *Armor3D, armor.four_points, 
                 rotate_head2world, trans_head2world, armor.id, plus_pnp_cost_image);
             target.pose_world = pose_world;
             
+        } else if (planar_frame && pnp_poses[i].valid && !planar_validate) {
+            rotate_pnp = pnp_poses[i].rotation;
+            rotate_world = rotate_head2world * rotate_pnp2head * rotate_pnp;
+            target.armor_yaw_world = rm::tf_rotation2armoryaw(rotate_world);
+
+            pose_pnp << pnp_poses[i].translation, 1.0;
+            pose_world = trans_head2world * trans_pnp2head * pose_pnp;
+            target.pose_world = pose_world;
+
         } else {
             try {
-                cv::solvePnP(*Armor3D, armor.four_points,
-                            Data::camera[frame->camera_id]->intrinsic_matrix,
-                            Data::camera[frame->camera_id]->distortion_coeffs,
-                            rvec, tvec, false, cv::SOLVEPNP_IPPE);
+                if (undistort_map != nullptr) {
+                    cv::solvePnP(*Armor3D, *pnp_inputs[i].image,
+                                getNormalizedIntrinsic(), getNormalizedDistortion(),
+                                rvec, tvec, false, cv::SOLVEPNP_IPPE);
+                } else {
+                    cv::solvePnP(*Armor3D, armor.four_points,
+                                Data::camera[frame->camera_id]->intrinsic_matrix,
+                                Data::camera[frame->camera_id]->distortion_coeffs,
+                                rvec, tvec, false, cv::SOLVEPNP_IPPE);
+                }
             } catch (cv::Exception e) {
                 rm::message("solvePnP error", rm::MSG_ERROR);
                 continue;
@@ -126,6 +290,17 @@ bool Pipeline::locater(std::shared_ptr<rm::Frame> frame) {
             rm::tf_Vec4d(tvec, pose_pnp);
             pose_world = trans_head2world * trans_pnp2head * pose_pnp;
             target.pose_world = pose_world;
+
+            // 与 OpenCV IPPE 结果对比闭式解的旋转夹角与平移距离
+            if (planar_frame && planar_validate && pnp_poses[i].valid) {
+                PlanarPose ref;
+                ref.rotation = rotate_pnp;
+                ref.translation = pose_pnp.head<3>();
+                double angle_diff, trans_diff;
+                getPoseDiff(pnp_poses[i], ref, angle_diff, trans_diff);
+                rm::message("planar angle diff", angle_diff);
+                rm::message("planar trans diff", trans_diff);
+            }
         }
         
         frame->target_list.push_back(target);
@@ -1,4 +1,16 @@
 #include "threads/pipeline.h"
+#include "threads/pipeline/roi_kernel.h"
+#include "threads/pipeline/run_length.h"
+#include "threads/pipeline/lightbar_pair.h"
+#include "threads/pipeline/motion.h"
+#include "threads/pipeline/scratch.h"
+#include "threads/pipeline/roi_cache.h"
+#include "data_manager/config.h"
+#include <map>
+#include <array>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
 
 using namespace rm;
 
@@ -7,11 +19,15 @@ static double roi_extend_h;
 static double point_line_dist;
 static double point_radius_ratio;
 
-static double lb_min_rect_side;
-static double lb_max_rect_side;
-static double lb_min_area;
-static double lb_min_ratio_area;
-static double lb_max_angle;
+// 每帧取自配置快照的阈值，离线模式下 pointer 按帧并行调用，因此按调用传递而不写入静态变量
+struct LightbarThresholds {
+    double binary_ratio;
+    double min_rect_side;
+    double max_rect_side;
+    double min_area;
+    double min_ratio_area;
+    double max_angle;
+};
 
 static double armor_max_ratio_length;
 static double armor_max_ratio_area;
@@ -34,12 +50,50 @@ static float big_blue_height;
 static float small_blue_width;
 static float small_blue_height;
 
-static double binary_ratio;
 static double enemy_split;
 
 static std::vector<int> armor_class_map;
 static std::vector<int> armor_color_map;
 
+static bool fused_enabled;
+static bool run_length_enabled;
+static bool run_length_validate;
+static std::atomic<int> run_length_total{0};
+static std::atomic<int> run_length_match{0};
+static bool fused_color;
+static int  fused_color_floor;
+
+static bool pair_sweep_enabled;
+static bool pair_sweep_validate;
+static bool line_refine_enabled;
+static std::atomic<int> pair_sweep_total{0};
+static std::atomic<int> pair_sweep_match{0};
+
+// 时序搜索窗口: 按装甲板 ID 记录上一帧找到的四点及当时的云台角度
+struct LightbarTrack {
+    std::array<cv::Point2f, 4> four_points;
+    TimePoint time_point;
+    float yaw, pitch;
+    int camera_id;
+};
+
+static bool temporal_enabled;
+static double temporal_max_interval;
+static double temporal_margin;
+static std::map<rm::ArmorID, std::vector<LightbarTrack>> lightbar_tracks;
+static std::map<rm::ArmorID, std::vector<LightbarTrack>> next_tracks;
+static const std::string temporal_fallback_msg = "temporal fallback";
+static int temporal_total = 0;
+static int temporal_fallback = 0;
+
+enum PointStatus {
+    POINT_OK,
+    POINT_NO_PAIR,
+    POINT_COLOR_SKIP,
+    POINT_AREA_INVALID,
+    POINT_NO_FOUR_POINTS
+};
+
 // 外部声明：更新全局装甲板数据
 extern void update_global_armors(const std::vector<rm::Armor>& armors);
 
@@ -58,11 +112,8 @@ void Pipeline::init_pointer() {
     point_line_dist        = (*param)["Points"]["Extend"]["PointLineDist"];
     point_radius_ratio     = (*param)["Points"]["Extend"]["PointRadiusRatio"];
 
-    lb_min_rect_side       = (*param)["Points"]["Lightbar"]["MinRectSide"];
-    lb_max_rect_side       = (*param)["Points"]["Lightbar"]["MaxRectSide"];
-    lb_min_area            = (*param)["Points"]["Lightbar"]["MinArea"];
-    lb_min_ratio_area      = (*param)["Points"]["Lightbar"]["MinRatioArea"];
-    lb_max_angle           = (*param)["Points"]["Lightbar"]["MaxAngle"];
+    run_length_enabled     = (*param)["Points"]["Lightbar"]["RunLength"]["Enable"];
+    run_length_validate    = (*param)["Points"]["Lightbar"]["RunLength"]["Validate"];
 
     armor_max_ratio_length = (*param)["Points"]["Armor"]["MaxRatioLength"];
     armor_max_ratio_area   = (*param)["Points"]["Armor"]["MaxRatioArea"];
@@ -89,23 +140,298 @@ void Pipeline::init_pointer() {
     small_blue_height      = (*param)["Points"]["PnP"]["Blue"]["SmallArmor"]["Height"];
 
     enemy_split = (*param)["Points"]["Threshold"]["EnemySplit"];
+
+    // 融合 ROI 内核: 启动时在合成 ROI 上与 OpenRM 逐步实现比较灰度与阈值，不一致时回退
+    fused_enabled     = (*param)["Points"]["Fused"]["Enable"];
+    fused_color       = (*param)["Points"]["Fused"]["Color"];
+    fused_color_floor = (*param)["Points"]["Fused"]["ColorFloor"];
+    int parity_samples = (*param)["Points"]["Fused"]["ParitySamples"];
+    double ratio_red   = (*param)["Points"]["Threshold"]["RatioRed"];
+    double ratio_blue  = (*param)["Points"]["Threshold"]["RatioBlue"];
+    if (fused_enabled) {
+        fused_enabled = checkRoiKernelParity(parity_samples, rm::ARMOR_COLOR_RED, ratio_red)
+                     && checkRoiKernelParity(parity_samples, rm::ARMOR_COLOR_BLUE, ratio_blue);
+        std::cout << "[POINTER] 融合 ROI 内核: " << (fused_enabled ? "启用" : "校验失败，回退到逐步实现") << std::endl;
+    }
+    if (Data::benchmark_flag) benchmarkRoiKernel(rm::ARMOR_COLOR_RED, ratio_red, 1000);
+    if (Data::benchmark_flag) benchmarkRunLength(1000);
+
+    // 灯条配对扫描剪枝与端点重心内核，端点内核启动时与 OpenRM 逐像素实现比较，偏差超限时回退
+    pair_sweep_enabled  = (*param)["Points"]["Pairing"]["Sweep"];
+    pair_sweep_validate = (*param)["Points"]["Pairing"]["Validate"];
+    line_refine_enabled = (*param)["Points"]["Pairing"]["LineRefine"];
+    double refine_tolerance = (*param)["Points"]["Pairing"]["RefineTolerance"];
+    int refine_samples      = (*param)["Points"]["Pairing"]["ParitySamples"];
+    if (line_refine_enabled) {
+        line_refine_enabled = checkLightbarEndpointParity(refine_samples, point_line_dist, point_radius_ratio, refine_tolerance);
+        std::cout << "[POINTER] 端点重心内核: " << (line_refine_enabled ? "启用" : "校验失败，回退到逐像素实现") << std::endl;
+    }
+    if (Data::benchmark_flag) {
+        benchmarkLightbarPair(
+            armor_max_ratio_length, armor_max_ratio_area, armor_min_ratio_side, armor_max_ratio_side,
+            armor_max_angle_diff, armor_max_angle_avg, armor_max_offset,
+            point_line_dist, point_radius_ratio, 1000);
+    }
+
+    temporal_enabled      = (*param)["Points"]["Temporal"]["Enable"];
+    temporal_max_interval = (*param)["Points"]["Temporal"]["MaxInterval"];
+    temporal_margin       = (*param)["Points"]["Temporal"]["Margin"];
 }
 
-bool Pipeline::pointer(std::shared_ptr<rm::Frame> frame) {
-    auto param = Param::get_instance();
-    if(Data::enemy_color == rm::ARMOR_COLOR_RED) {
-        binary_ratio = (*param)["Points"]["Threshold"]["RatioRed"];
+// 上一帧同 ID 的四点经云台补偿后落在本次 ROI 内时，以其外接矩形外扩 Margin 倍灯条长度作为搜索窗口
+static bool getTemporalWindow(const rm::Frame& frame, const rm::Armor& armor, cv::Rect& window) {
+    auto it = lightbar_tracks.find(armor.id);
+    if (it == lightbar_tracks.end()) return false;
+
+    const LightbarTrack* best = nullptr;
+    cv::Point2f best_shift;
+    double best_dist = 1e9;
+    cv::Point2f roi_center(armor.rect.x + armor.rect.width / 2.0f, armor.rect.y + armor.rect.height / 2.0f);
+    for (const auto& track : it->second) {
+        if (track.camera_id != frame.camera_id) continue;
+        if (getDoubleOfS(track.time_point, frame.time_point) > temporal_max_interval) continue;
+
+        cv::Point2f shift = getGimbalShift(
+            Data::camera[frame.camera_id], track.yaw, track.pitch, frame.yaw, frame.pitch);
+        cv::Point2f center(0, 0);
+        for (const auto& point : track.four_points) center += point;
+        center = center * 0.25f + shift;
+        if (!armor.rect.contains(cv::Point((int)center.x, (int)center.y))) continue;
+
+        double dist = std::hypot(center.x - roi_center.x, center.y - roi_center.y);
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = &track;
+            best_shift = shift;
+        }
+    }
+    if (best == nullptr) return false;
+
+    std::array<cv::Point2f, 4> points;
+    for (int i = 0; i < 4; i++) points[i] = best->four_points[i] + best_shift;
+    const cv::Point2f& p0 = points[0];
+    const cv::Point2f& p1 = points[1];
+    const cv::Point2f& p2 = points[2];
+    const cv::Point2f& p3 = points[3];
+    double length = std::max(std::hypot(p0.x - p1.x, p0.y - p1.y), std::hypot(p2.x - p3.x, p2.y - p3.y));
+    int margin = (int)std::ceil(length * temporal_margin);
+
+    cv::Rect bound = cv::boundingRect(points);
+    window = cv::Rect(bound.x - margin, bound.y - margin, bound.width + 2 * margin, bound.height + 2 * margin) & armor.rect;
+    return window.width >= 8 && window.height >= 8;
+}
+
+// 在检测框 ROI 的 armor.rect 范围内计算灰度与二值平面，同一矩形已计算过时直接复用
+static RoiPlanes& getArmorPlanes(DetectionRoi& detection, const cv::Rect& rect, double binary_ratio) {
+    RoiPlanes& planes = detection.planes(rect);
+    if (planes.ready) return planes;
+
+    cv::Mat roi = detection.bgr(rect);
+    planes.gray = getScratchMat(planes.gray_buffer, roi.rows, roi.cols, CV_8UC1);
+    planes.binary = getScratchMat(planes.binary_buffer, roi.rows, roi.cols, CV_8UC1);
+    int area = roi.rows * roi.cols;
+    if (fused_enabled) {
+        fuseRoiGray(roi, planes.gray, planes.stats, fused_color_floor);
+        planes.threshold = getThresholdFromRoiHist(planes.stats, 8, binary_ratio);
+        detection.touch(area);
+    } else {
+        rm::getGrayScale(roi, planes.gray, Data::enemy_color, rm::GRAY_SCALE_METHOD_CVT);
+        planes.threshold = rm::getThresholdFromHist(roi, 8, binary_ratio);
+        detection.touch(2 * area);
+    }
+    planes.threshold = std::clamp(planes.threshold, 10, 100);
+    rm::getBinary(planes.gray, planes.binary, planes.threshold, rm::BINARY_METHOD_DIRECT_THRESHOLD);
+    detection.touch(area);
+    planes.ready = true;
+    return planes;
+}
+
+// 在 armor.rect 范围内寻找灯条对、判断颜色并设置四点
+static PointStatus findArmorPoints(DetectionRoi& detection, rm::Armor& armor, const LightbarThresholds& lb) {
+    cv::Mat roi = detection.bgr(armor.rect);
+    RoiPlanes& planes = getArmorPlanes(detection, armor.rect, lb.binary_ratio);
+    const cv::Mat& gray = planes.gray;
+    const cv::Mat& binary = planes.binary;
+    const RoiStats& roi_stats = planes.stats;
+
+    // 轮廓与灯条容器取自线程复用缓冲区，沿用上一次的容量
+    TrackerScratch& scratch = TrackerScratch::local();
+
+    if (Data::image_flag && Data::binary_flag) {
+        cv::imshow("gray", gray);
+        cv::imshow("binary", binary);
+        cv::waitKey(1);
+    }
+
+    if (Data::image_flag && Data::histogram_flag) {
+        cv::Mat showHist;
+        rm::getThresholdFromHist(roi, showHist, 8, lb.binary_ratio);
+        cv::imshow("histogram", showHist);
+        cv::waitKey(1);
+    }
+
+    // 游程连通域标记替代边界跟踪，像素数不足 MinArea 一半的连通域其轮廓面积与外接矩形面积均不可能达标
+    std::vector<std::vector<cv::Point>>& contours = scratch.contours;
+    if (run_length_enabled) {
+        getRunLengthContours(binary, contours, scratch.components, (int)(lb.min_area / 2));
     } else {
-        binary_ratio = (*param)["Points"]["Threshold"]["RatioBlue"];
+        cv::findContours(binary, contours, cv::RETR_LIST, cv::CHAIN_APPROX_NONE);
     }
 
-    for (auto& yolo_rect : frame->yolo_list) {
+
+    std::vector<rm::Lightbar>& lightbar_list = scratch.lightbar_list;
+    lightbar_list.clear();
+    rm::getLightbarsFromContours(
+        contours, 
+        lightbar_list, 
+        lb.min_rect_side,
+        lb.max_rect_side,
+        lb.min_area,
+        lb.min_ratio_area,
+        lb.max_angle);
+
+    if (run_length_enabled && run_length_validate) {
+        std::vector<std::vector<cv::Point>> ref_contours;
+        std::vector<rm::Lightbar> ref_lightbar_list;
+        cv::findContours(binary, ref_contours, cv::RETR_LIST, cv::CHAIN_APPROX_NONE);
+        rm::getLightbarsFromContours(
+            ref_contours, ref_lightbar_list, lb.min_rect_side, lb.max_rect_side,
+            lb.min_area, lb.min_ratio_area, lb.max_angle);
+
+        // 两种方法得到的灯条按中心一一对应 (1 像素以内) 视为一致
+        bool match = (lightbar_list.size() == ref_lightbar_list.size());
+        for (const auto& ref_lightbar : ref_lightbar_list) {
+            if (!match) break;
+            match = std::any_of(lightbar_list.begin(), lightbar_list.end(), [&](const rm::Lightbar& lightbar) {
+                return std::hypot(lightbar.center.x - ref_lightbar.center.x, lightbar.center.y - ref_lightbar.center.y) <= 1.0;
+            });
+        }
+        run_length_total++;
+        if (match) run_length_match++;
+        rm::message("run-length match", (double)run_length_match / run_length_total);
+
+        // 校验模式下仍输出边界跟踪的结果
+        lightbar_list.swap(ref_lightbar_list);
+    }
+
+    rm::LightbarPair best_pair;
+
+    // 按 x 扫描剔除没有可配对邻居的灯条，反光较多时显著减少 OpenRM 的两两比较
+    std::vector<rm::Lightbar>& candidate_list = scratch.candidate_list;
+    TimePoint tp0 = getTime();
+    if (pair_sweep_enabled) {
+        sweepLightbarCandidates(lightbar_list, candidate_list, armor_max_ratio_length, armor_max_ratio_side);
+    } else {
+        candidate_list = lightbar_list;
+    }
+    rm::Armor armor_ref;
+    if (pair_sweep_validate) armor_ref = armor;
+
+    bool flag = rm::getBestMatchedLightbarPair(
+        candidate_list, 
+        armor, 
+        best_pair, 
+        armor_max_ratio_length,
+        armor_max_ratio_area,
+        armor_min_ratio_side,
+        armor_max_ratio_side,
+        armor_max_angle_diff,
+        armor_max_angle_avg,
+        armor_max_offset);
+
+    if (pair_sweep_enabled && pair_sweep_validate) {
+        TimePoint tp1 = getTime();
+        rm::LightbarPair ref_pair;
+        bool ref_flag = rm::getBestMatchedLightbarPair(
+            lightbar_list, armor_ref, ref_pair, armor_max_ratio_length, armor_max_ratio_area,
+            armor_min_ratio_side, armor_max_ratio_side, armor_max_angle_diff, armor_max_angle_avg,
+            armor_max_offset);
+        TimePoint tp2 = getTime();
+
+        bool match = (flag == ref_flag) && (!flag ||
+            (best_pair.first.center == ref_pair.first.center && best_pair.second.center == ref_pair.second.center));
+        pair_sweep_total++;
+        if (match) pair_sweep_match++;
+        rm::message("pair sweep match", (double)pair_sweep_match / pair_sweep_total);
+        rm::message("pair candidates", (int)(lightbar_list.size() - candidate_list.size()));
+        rm::message("pair sweep saved", (getDoubleOfS(tp1, tp2) - getDoubleOfS(tp0, tp1)) * 1000);
+
+        // 校验模式下仍输出对全部灯条配对的结果
+        flag = ref_flag;
+        best_pair = ref_pair;
+        armor = armor_ref;
+    }
+
+    if (fused_enabled && fused_color) {
+        armor.color = flag ? getLightbarPairColor(roi_stats, best_pair) : rm::ARMOR_COLOR_NONE;
+    } else {
+        armor.color = rm::getArmorColorFromHSV(roi, best_pair);
+    }
+
+    if (!flag) return POINT_NO_PAIR;
+
+    bool color_skip_flag = false;
+    
+    #ifdef TJURM_SENTRY
+    color_skip_flag = color_skip_flag || !rm::isArmorColorEnemy(roi, best_pair, Data::enemy_color, enemy_split);
+    color_skip_flag = color_skip_flag || (armor.color != Data::enemy_color);
+    #endif
+    
+    #if defined(TJURM_INFANTRY) || defined(TJURM_BALANCE) || defined(TJURM_HERO) || defined(TJURM_DRONSE)
+    color_skip_flag = color_skip_flag || (armor.color == Data::self_color);
+    color_skip_flag = color_skip_flag || (armor.color == rm::ARMOR_COLOR_NONE);
+    #endif
+
+    if (Data::auto_enemy && color_skip_flag) return POINT_COLOR_SKIP;
+
+    rm::setArmorFourPoints(
+        armor, 
+        line_refine_enabled
+            ? findLightbarEndpoints(best_pair.first, gray, point_line_dist, point_radius_ratio)
+            : findPointPairBarycenter(best_pair.first, gray, point_line_dist, point_radius_ratio),
+        line_refine_enabled
+            ? findLightbarEndpoints(best_pair.second, gray, point_line_dist, point_radius_ratio)
+            : findPointPairBarycenter(best_pair.second, gray, point_line_dist, point_radius_ratio)
+    );
+
+    if (rm::isLightBarAreaPercentValid(armor, armor_min_area_percent)) return POINT_AREA_INVALID;
+    if (armor.four_points.size() != 4) return POINT_NO_FOUR_POINTS;
+    return POINT_OK;
+}
+
+bool Pipeline::pointer(std::shared_ptr<rm::Frame> frame) {
+    // 阈值每帧取自配置快照，热更新后下一帧生效
+    ConfigPtr config = getConfigSnapshot();
+    LightbarThresholds lb;
+    lb.binary_ratio   = (Data::enemy_color == rm::ARMOR_COLOR_RED) ? config->ratio_red : config->ratio_blue;
+    lb.min_rect_side  = config->lb_min_rect_side;
+    lb.max_rect_side  = config->lb_max_rect_side;
+    lb.min_area       = config->lb_min_area;
+    lb.min_ratio_area = config->lb_min_ratio_area;
+    lb.max_angle      = config->lb_max_angle;
+
+    // 帧内临时数组的单调分配区在每帧开始时整体重置
+    FrameArena::local().reset();
+    if (temporal_enabled && !offline_mode_) {
+        for (auto& it : next_tracks) it.second.clear();
+    }
+
+    // 本帧检测框 ROI 由后续 classifier 与显示复用；绘制会改写原图，绘制前先取得分类器输入
+    FrameRois& rois = roi_cache_.acquire(*frame);
+    if (Data::image_flag && Data::ui_flag && classifier_enabled_) {
+        cv::Size patch_size(classifier_infer_width_, classifier_infer_height_);
+        for (size_t i = 0; i < rois.size(); i++) rois[i].patch(patch_size, classifier_padding_);
+    }
+
+    for (size_t i = 0; i < frame->yolo_list.size(); i++) {
+        const rm::YoloRect& yolo_rect = frame->yolo_list[i];
+        DetectionRoi& detection = rois[i];
         rm::Armor armor;
         armor.id = (rm::ArmorID)(armor_class_map[yolo_rect.class_id]);
         armor.color = (rm::ArmorColor)(armor_color_map[yolo_rect.color_id]);
         setArmorExtendRectIOU(armor, yolo_rect.box, frame->width, frame->height, roi_extend_w, roi_extend_h);
-        static int ptr_count = 0;
-        ptr_count++;
+        static std::atomic<int> ptr_total{0};
+        int ptr_count = ++ptr_total;
         if (ptr_count % 30 == 1) {
             std::cout << "[PTR#" << ptr_count << "] yolo_class=" << yolo_rect.class_id << " armor_id=" << (int)armor.id << " state=" << (int)Data::state << std::endl;
         }
@@ -118,97 +444,35 @@ bool Pipeline::pointer(std::shared_ptr<rm::Frame> frame) {
         #endif
 
         if (!isRectValidInImage(*frame->image, armor.rect)) continue;
-        cv::Mat roi = (*frame->image)(armor.rect);
-
-        cv::Mat gray, binary;
-        rm::getGrayScale(roi, gray, Data::enemy_color, rm::GRAY_SCALE_METHOD_CVT);
-
-        int threshold_from_hist = rm::getThresholdFromHist(roi, 8, binary_ratio);
-        threshold_from_hist = std::clamp(threshold_from_hist, 10, 100);
-        rm::getBinary(gray, binary, threshold_from_hist, rm::BINARY_METHOD_DIRECT_THRESHOLD);
-
-        if (Data::image_flag && Data::binary_flag) {
-            cv::imshow("gray", gray);
-            cv::imshow("binary", binary);
-            cv::waitKey(1);
-        }
-
-        if (Data::image_flag && Data::histogram_flag) {
-            cv::Mat showHist;
-            rm::getThresholdFromHist(roi, showHist, 8, binary_ratio);
-            cv::imshow("histogram", showHist);
-            cv::waitKey(1);
-        }
-
-        std::vector<std::vector<cv::Point>> contours;
-        cv::findContours(binary, contours, cv::RETR_LIST, cv::CHAIN_APPROX_NONE);
-
-
-        std::vector<rm::Lightbar> lightbar_list;
-        rm::getLightbarsFromContours(
-            contours, 
-            lightbar_list, 
-            lb_min_rect_side,
-            lb_max_rect_side,
-            lb_min_area,
-            lb_min_ratio_area,
-            lb_max_angle);
-
-        rm::LightbarPair best_pair;
-
-        bool flag = rm::getBestMatchedLightbarPair(
-            lightbar_list, 
-            armor, 
-            best_pair, 
-            armor_max_ratio_length,
-            armor_max_ratio_area,
-            armor_min_ratio_side,
-            armor_max_ratio_side,
-            armor_max_angle_diff,
-            armor_max_angle_avg,
-            armor_max_offset);
 
-        armor.color = rm::getArmorColorFromHSV(roi, best_pair);
-
-        if (!flag) {
-            if (Data::point_skip_flag) rm::message("No lightbar pair found", rm::MSG_NOTE);
-            if (Data::image_flag && Data::ui_flag) {
-                rm::displaySingleArmorClass(*(frame->image), armor);
-                rm::displaySingleArmorRect(*(frame->image), armor);
+        // 先在上一帧灯条附近的小窗口内搜索，几何条件失败时回退到完整 ROI，颜色判断失败不回退
+        TimePoint tp1 = getTime();
+        cv::Rect full_rect = armor.rect;
+        cv::Rect window;
+        PointStatus status;
+        if (temporal_enabled && !offline_mode_ && getTemporalWindow(*frame, armor, window)) {
+            armor.rect = window;
+            status = findArmorPoints(detection, armor, lb);
+            armor.rect = full_rect;
+            temporal_total++;
+            if (status != POINT_OK && status != POINT_COLOR_SKIP) {
+                temporal_fallback++;
+                status = findArmorPoints(detection, armor, lb);
             }
-            continue;
+            rm::message(temporal_fallback_msg, (double)temporal_fallback / temporal_total);
+        } else {
+            status = findArmorPoints(detection, armor, lb);
         }
-
-        bool color_skip_flag = false;
-        
-        #ifdef TJURM_SENTRY
-        color_skip_flag = color_skip_flag || !rm::isArmorColorEnemy(roi, best_pair, Data::enemy_color, enemy_split);
-        color_skip_flag = color_skip_flag || (armor.color != Data::enemy_color);
-        #endif
-        
-        #if defined(TJURM_INFANTRY) || defined(TJURM_BALANCE) || defined(TJURM_HERO) || defined(TJURM_DRONSE)
-        color_skip_flag = color_skip_flag || (armor.color == Data::self_color);
-        color_skip_flag = color_skip_flag || (armor.color == rm::ARMOR_COLOR_NONE);
-        #endif
-        
-
-        if (Data::auto_enemy && color_skip_flag) {
-            if (Data::point_skip_flag) rm::message("Color is on our part", rm::MSG_NOTE);
-            if (Data::image_flag && Data::ui_flag) {
-                rm::displaySingleArmorClass(*(frame->image), armor);
-                rm::displaySingleArmorRect(*(frame->image), armor);
+        TimePoint tp2 = getTime();
+        if (Data::pipeline_delay_flag) rm::message("pointer armor", getDoubleOfS(tp1, tp2) * 1000);
+
+        if (status != POINT_OK) {
+            if (Data::point_skip_flag) {
+                if (status == POINT_NO_PAIR) rm::message("No lightbar pair found", rm::MSG_NOTE);
+                if (status == POINT_COLOR_SKIP) rm::message("Color is on our part", rm::MSG_NOTE);
+                if (status == POINT_AREA_INVALID) rm::message("Area percent is invalid", rm::MSG_NOTE);
+                if (status == POINT_NO_FOUR_POINTS) rm::message("No four points found", rm::MSG_NOTE);
             }
-            continue;
-        }
-        
-        rm::setArmorFourPoints(
-            armor, 
-            findPointPairBarycenter(best_pair.first, gray, point_line_dist, point_radius_ratio),
-            findPointPairBarycenter(best_pair.second, gray, point_line_dist, point_radius_ratio)
-        );
-
-        if (rm::isLightBarAreaPercentValid(armor, armor_min_area_percent)) {
-            if (Data::point_skip_flag) rm::message("Area percent is invalid", rm::MSG_NOTE);
             if (Data::image_flag && Data::ui_flag) {
                 rm::displaySingleArmorClass(*(frame->image), armor);
                 rm::displaySingleArmorRect(*(frame->image), armor);
@@ -216,13 +480,14 @@ bool Pipeline::pointer(std::shared_ptr<rm::Frame> frame) {
             continue;
         }
 
-        if(armor.four_points.size() != 4) {
-            if (Data::point_skip_flag) rm::message("No four points found", rm::MSG_NOTE);
-            if (Data::image_flag && Data::ui_flag) {
-                rm::displaySingleArmorClass(*(frame->image), armor);
-                rm::displaySingleArmorRect(*(frame->image), armor);
-            }
-            continue;
+        if (temporal_enabled && !offline_mode_) {
+            LightbarTrack track;
+            std::copy(armor.four_points.begin(), armor.four_points.end(), track.four_points.begin());
+            track.time_point = frame->time_point;
+            track.yaw = frame->yaw;
+            track.pitch = frame->pitch;
+            track.camera_id = frame->camera_id;
+            next_tracks[armor.id].push_back(track);
         }
 
         #if defined(TJURM_SENTRY) || defined(TJURM_DRONSE)
@@ -246,6 +511,8 @@ bool Pipeline::pointer(std::shared_ptr<rm::Frame> frame) {
         }
     }
 
+    if (temporal_enabled && !offline_mode_) lightbar_tracks.swap(next_tracks);
+
     // 更新全局装甲板数据供显示线程使用（用于重投影）
     if (Data::reprojection_flag) {
         update_global_armors(frame->armor_list);
@@ -1,16 +1,31 @@
 #include "threads/pipeline.h"
 #include "threads/control.h"
+#include "garage/kalman_model.h"
+#include <fstream>
+#include <iomanip>
 using namespace rm;
 
 static std::vector<double> referee_offset;
 static std::vector<double> axis_offset;
 
+// 录制模式下把送入 Garage 的观测写入 Kalman.PushLog，供 benchmarkKalman 回放
+static std::string push_log_path;
+static std::ofstream push_log;
+static TimePoint push_log_t0;
+
 void Pipeline::init_updater() {
     auto param = Param::get_instance();
     std::vector<double> temp_referee_offset = (*param)["Car"]["RefereeOffset"];
     std::vector<double> temp_axis_offset    = (*param)["Car"]["AxisOffset"];
     referee_offset = temp_referee_offset;
     axis_offset    = temp_axis_offset;
+    std::string temp_push_log = (*param)["Kalman"]["PushLog"];
+    push_log_path  = temp_push_log;
+
+    if (Data::benchmark_flag) benchmarkGarageUpdate(1000);
+    if (Data::benchmark_flag) benchmarkKalman(100);
+    if (Data::benchmark_flag) benchmarkFilterBank(20);
+    if (Data::benchmark_flag) stressGuardedModel(1.0);
 }
 
 bool Pipeline::updater(std::shared_ptr<rm::Frame> frame) {
@@ -22,6 +37,17 @@ bool Pipeline::updater(std::shared_ptr<rm::Frame> frame) {
         rm::ArmorID armor_id = target.armor_id;
         ObjPtr objptr = garage->getObj(armor_id);
         objptr->push(target, frame->time_point);
+        if (Data::record_mode && !push_log_path.empty()) {
+            if (!push_log.is_open()) {
+                push_log.open(push_log_path);
+                push_log << std::fixed << std::setprecision(4);
+                push_log_t0 = frame->time_point;
+            }
+            push_log << (int)armor_id << " " << getDoubleOfS(push_log_t0, frame->time_point) << " "
+                     << target.pose_world(0, 0) << " " << target.pose_world(1, 0) << " " << target.pose_world(2, 0) << " "
+                     << target.armor_yaw_world << "\n";
+        }
+        garage->markActive(armor_id, frame->time_point);
 
         double angle = rm::getAngleOffsetTargetToReferee(
             control->get_yaw(), control->get_pitch(),
@@ -33,8 +59,14 @@ bool Pipeline::updater(std::shared_ptr<rm::Frame> frame) {
         Data::attack->push(armor_id, angle, frame->time_point);
     }
 
-    for (auto& objptr : garage->obj_)
-        objptr->update();
+    TimePoint tp1 = getTime();
+    int updated = garage->updateActive(frame->time_point);
+    if (Data::pipeline_delay_flag) {
+        double update_time = getDoubleOfS(tp1, getTime()) * 1000;
+        rm::message("updater time", update_time);
+        rm::message("updater objs", updated);
+        if (updated > 0) rm::message("updater per obj", update_time / updated);
+    }
     
     if ((frame->target_list).empty()) return false;
     return true;
@@ -2,6 +2,7 @@
 #include <atomic>
 extern std::atomic<bool> g_running;
 #include "threads/control.h"
+#include "data_manager/alloc_counter.h"
 
 // 外部声明 - 更新显示线程的检测结果
 extern void update_global_detections(const std::vector<rm::YoloRect>& detections);
@@ -77,6 +78,10 @@ void Pipeline::tracker_baseline_thread(
         lock_in.unlock();
 
         tp1 = getTime();
+        garage->applyConfig();
+        #ifdef TJURM_ALLOC_COUNT
+        uint64_t alloc_begin = getThreadAllocCount();
+        #endif
         bool track_flag = true;
         if (track_flag) track_flag = pointer(frame);
         if (track_flag) track_flag = classifier(frame);  // 使用 tiny_resnet 分类
@@ -89,8 +94,15 @@ void Pipeline::tracker_baseline_thread(
         if (track_flag) track_flag = locater(frame);
         if (track_flag) track_flag = updater(frame);
         tp2 = getTime();
+        first_frame_ready_ = true;
+
+        #ifdef TJURM_ALLOC_COUNT
+        rm::message("tracker allocs", (int)(getThreadAllocCount() - alloc_begin));
+        #endif
 
         if (Data::pipeline_delay_flag) rm::message("tracker time", getDoubleOfS(tp1, tp2) * 1000);
+        FrameRois* rois = roi_cache_.find(*frame);
+        if (rois != nullptr && rois->size() > 0) rm::message("roi pixels", rois->getPixelsPerRoi());
         if (track_flag) delay_list.push(getDoubleOfS(tp0, tp2));
 
         tp0 = tp2;
@@ -101,6 +113,7 @@ void Pipeline::tracker_baseline_thread(
             if (Data::ui_flag) UI(frame);
             imshow(frame);
         }
+        roi_cache_.release(*frame);
     }
     std::cout << "[tracker_thread] Exiting..." << std::endl;
 }
@@ -45,6 +45,7 @@ void Pipeline::detector_fourpoints_thread(
 
 
         tp1 = getTime();
+        garage->applyConfig();
 
         detectOutput(
             armor_output_host_buffer_,
@@ -90,8 +91,7 @@ void Pipeline::detector_fourpoints_thread(
         } 
 
         fourpoints(frame);
-        for (auto& objptr : garage->obj_)
-            objptr->update();
+        garage->updateActive(frame->time_point);
         if (Data::imshow_flag) imshow(frame);
 
         tp2 = getTime();
@@ -1,5 +1,6 @@
 #include "threads/pipeline.h"
 #include "threads/control.h"
+#include "data_manager/undistort.h"
 
 static double armor_size_ratio;
 
@@ -75,6 +76,7 @@ bool Pipeline::fourpoints(std::shared_ptr<rm::Frame> frame) {
     auto control = Control::get_instance();
 
     cv::Mat rvec, tvec, rotate_cv;
+    std::vector<cv::Point2f> normalized_points;
     Eigen::Vector4d pose_pnp, pose_world;
     Eigen::Vector4d predict_pnp, predict_world;
     Eigen::Matrix3d rotate_pnp, rotate_world;
@@ -139,10 +141,18 @@ bool Pipeline::fourpoints(std::shared_ptr<rm::Frame> frame) {
         
         // 使用solvePnP求解旋转和平移参数
         try {
-            cv::solvePnP(*Armor3D, armor.four_points,
-                Data::camera[frame->camera_id]->intrinsic_matrix,
-                Data::camera[frame->camera_id]->distortion_coeffs,
-                rvec, tvec, false, cv::SOLVEPNP_EPNP);
+            const UndistortMap* undistort_map = getUndistortMap(frame->camera_id);
+            if (undistort_map != nullptr) {
+                undistort_map->lookup(armor.four_points, normalized_points);
+                cv::solvePnP(*Armor3D, normalized_points,
+                    getNormalizedIntrinsic(), getNormalizedDistortion(),
+                    rvec, tvec, false, cv::SOLVEPNP_EPNP);
+            } else {
+                cv::solvePnP(*Armor3D, armor.four_points,
+                    Data::camera[frame->camera_id]->intrinsic_matrix,
+                    Data::camera[frame->camera_id]->distortion_coeffs,
+                    rvec, tvec, false, cv::SOLVEPNP_EPNP);
+            }
         } catch (cv::Exception& e) {
             rm::message("solvePnP error", rm::MSG_ERROR);
             continue;
@@ -169,6 +179,7 @@ bool Pipeline::fourpoints(std::shared_ptr<rm::Frame> frame) {
         // 从车库中获取目标
         ObjPtr objptr = garage->getObj(armor_id);
         objptr->push(target, frame->time_point);
+        garage->markActive(armor_id, frame->time_point);
 
         // 计算目标与图传的角度偏差
         double angle = rm::getAngleOffsetTargetToReferee(
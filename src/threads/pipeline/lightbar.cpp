@@ -0,0 +1,169 @@
+#include "threads/pipeline/lightbar.h"
+#include "data_manager/param.h"
+#include <cmath>
+#include <algorithm>
+
+LightbarDetectConfig getLightbarDetectConfig() {
+    auto param = Param::get_instance();
+    LightbarDetectConfig config;
+    config.scale            = (*param)["Model"]["YoloArmor"]["Classical"]["Scale"];
+    config.threshold        = (*param)["Model"]["YoloArmor"]["Classical"]["Threshold"];
+    config.box_height_ratio = (*param)["Model"]["YoloArmor"]["Classical"]["BoxHeightRatio"];
+    config.class_id         = (*param)["Model"]["YoloArmor"]["Classical"]["ClassId"];
+
+    std::string yolo_type = (*param)["Model"]["YoloArmor"]["Type"];
+    std::vector<int> color_map = (*param)["Model"]["YoloArmor"][yolo_type]["ColorMap"];
+    config.color_map = color_map;
+
+    config.lb_min_rect_side  = (*param)["Points"]["Lightbar"]["MinRectSide"];
+    config.lb_max_rect_side  = (*param)["Points"]["Lightbar"]["MaxRectSide"];
+    config.lb_min_area       = (*param)["Points"]["Lightbar"]["MinArea"];
+    config.lb_min_ratio_area = (*param)["Points"]["Lightbar"]["MinRatioArea"];
+    config.lb_max_angle      = (*param)["Points"]["Lightbar"]["MaxAngle"];
+
+    config.armor_max_ratio_length = (*param)["Points"]["Armor"]["MaxRatioLength"];
+    config.armor_min_ratio_side   = (*param)["Points"]["Armor"]["RatioSide"]["Min"];
+    config.armor_max_ratio_side   = (*param)["Points"]["Armor"]["RatioSide"]["Max"];
+    config.armor_max_angle_diff   = (*param)["Points"]["Armor"]["MaxAngleDiff"];
+    config.armor_max_offset       = (*param)["Points"]["Armor"]["MaxOffset"];
+    return config;
+}
+
+struct LightbarMatch {
+    int first, second;
+    double cost;
+};
+
+void lightbarDetect(
+    const cv::Mat& image,
+    std::vector<rm::YoloRect>& yolo_list,
+    rm::ArmorColor enemy_color,
+    const LightbarDetectConfig& config
+) {
+    yolo_list.clear();
+    if (image.empty() || image.channels() != 3) return;
+
+    // 缩放后敌方颜色通道减去另一通道，抑制白色过曝区域与己方灯条
+    cv::Mat small, enemy, other, diff, binary;
+    if (config.scale > 0 && config.scale < 1.0) {
+        cv::resize(image, small, cv::Size(), config.scale, config.scale, cv::INTER_LINEAR);
+    } else {
+        small = image;
+    }
+    bool enemy_red = (enemy_color == rm::ARMOR_COLOR_RED);
+    cv::extractChannel(small, enemy, enemy_red ? 2 : 0);
+    cv::extractChannel(small, other, enemy_red ? 0 : 2);
+    cv::subtract(enemy, other, diff);
+    cv::threshold(diff, binary, config.threshold, 255, cv::THRESH_BINARY);
+
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(binary, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
+
+    // 面积阈值按缩放比例换算到缩放后的图像
+    double scale = (config.scale > 0 && config.scale < 1.0) ? config.scale : 1.0;
+    std::vector<rm::Lightbar> lightbar_list;
+    rm::getLightbarsFromContours(
+        contours,
+        lightbar_list,
+        config.lb_min_rect_side,
+        config.lb_max_rect_side,
+        config.lb_min_area * scale * scale,
+        config.lb_min_ratio_area,
+        config.lb_max_angle);
+
+    // 枚举所有满足几何约束的灯条对，按代价贪心选取，每个灯条至多使用一次
+    std::vector<LightbarMatch> match_list;
+    for (int i = 0; i < (int)lightbar_list.size(); i++) {
+        for (int j = i + 1; j < (int)lightbar_list.size(); j++) {
+            const rm::Lightbar& a = lightbar_list[i];
+            const rm::Lightbar& b = lightbar_list[j];
+            double len_max = std::max(a.length, b.length);
+            double len_min = std::min(a.length, b.length);
+            if (len_min <= 0 || len_max / len_min > config.armor_max_ratio_length) continue;
+
+            double len_avg = (a.length + b.length) / 2.0;
+            double dx = std::fabs(a.center.x - b.center.x);
+            double dy = std::fabs(a.center.y - b.center.y);
+            double ratio_side = dx / len_avg;
+            if (ratio_side < config.armor_min_ratio_side || ratio_side > config.armor_max_ratio_side) continue;
+
+            double offset = dy / len_avg;
+            if (offset > config.armor_max_offset) continue;
+
+            double angle_diff = std::fabs(a.angle - b.angle);
+            if (angle_diff > config.armor_max_angle_diff) continue;
+
+            double cost = len_max / len_min - 1.0 + offset + angle_diff / config.armor_max_angle_diff;
+            match_list.push_back({i, j, cost});
+        }
+    }
+    std::sort(match_list.begin(), match_list.end(),
+        [](const LightbarMatch& a, const LightbarMatch& b) { return a.cost < b.cost; });
+
+    int color_id = 0;
+    for (int i = 0; i < (int)config.color_map.size(); i++) {
+        if (config.color_map[i] == (int)enemy_color) {
+            color_id = i;
+            break;
+        }
+    }
+
+    cv::Rect image_rect(0, 0, image.cols, image.rows);
+    std::vector<char> used(lightbar_list.size(), 0);
+    for (const auto& match : match_list) {
+        if (used[match.first] || used[match.second]) continue;
+        used[match.first] = used[match.second] = 1;
+
+        const rm::Lightbar* left = &lightbar_list[match.first];
+        const rm::Lightbar* right = &lightbar_list[match.second];
+        if (left->center.x > right->center.x) std::swap(left, right);
+
+        // 坐标还原到原图，四点顺序与 YOLO 输出一致: 左上、左下、右下、右上
+        cv::Point2f lc = left->center * (float)(1.0 / scale);
+        cv::Point2f rc = right->center * (float)(1.0 / scale);
+        float lh = left->length / scale / 2.0f;
+        float rh = right->length / scale / 2.0f;
+        float len_avg = lh + rh;
+
+        rm::YoloRect yolo_rect;
+        yolo_rect.four_points = {
+            cv::Point2f(lc.x, lc.y - lh),
+            cv::Point2f(lc.x, lc.y + lh),
+            cv::Point2f(rc.x, rc.y + rh),
+            cv::Point2f(rc.x, rc.y - rh)
+        };
+        cv::Point2f center = (lc + rc) * 0.5f;
+        float box_width = (rc.x - lc.x) + len_avg * 0.5f;
+        float box_height = len_avg * config.box_height_ratio;
+        yolo_rect.box = cv::Rect(
+            (int)(center.x - box_width / 2), (int)(center.y - box_height / 2),
+            (int)box_width, (int)box_height) & image_rect;
+        if (yolo_rect.box.area() <= 0) continue;
+
+        yolo_rect.confidence = (float)(1.0 / (1.0 + match.cost));
+        yolo_rect.class_id = config.class_id;
+        yolo_rect.color_id = color_id;
+        yolo_list.push_back(yolo_rect);
+    }
+}
+
+double getYoloRecall(
+    const std::vector<rm::YoloRect>& candidates,
+    const std::vector<rm::YoloRect>& reference,
+    double iou_thresh
+) {
+    if (reference.empty()) return -1.0;
+
+    int hit = 0;
+    for (const auto& ref_rect : reference) {
+        for (const auto& candidate : candidates) {
+            double inter = (ref_rect.box & candidate.box).area();
+            double iou = inter / (ref_rect.box.area() + candidate.box.area() - inter);
+            if (iou > iou_thresh) {
+                hit++;
+                break;
+            }
+        }
+    }
+    return (double)hit / reference.size();
+}
@@ -0,0 +1,259 @@
+#include "threads/pipeline/lightbar_pair.h"
+#include "threads/pipeline/scratch.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <iostream>
+#include <numeric>
+#include <cmath>
+#include <algorithm>
+
+void sweepLightbarCandidates(
+    const std::vector<rm::Lightbar>& lightbar_list,
+    std::vector<rm::Lightbar>& candidate_list,
+    double max_ratio_length,
+    double max_ratio_side
+) {
+    candidate_list.clear();
+    int n = lightbar_list.size();
+    if (n < 2) return;
+
+    std::pmr::memory_resource* arena = FrameArena::local().resource();
+    std::pmr::vector<int> order(n, arena);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return lightbar_list[a].center.x < lightbar_list[b].center.x;
+    });
+    double max_length = 0.0;
+    for (const auto& lightbar : lightbar_list) max_length = std::max(max_length, (double)lightbar.length);
+
+    // 中心距 / 灯条长度的归一化长度不超过两者中的较长者，故 x 方向间距超过 max_ratio_side * max_length 后不再有可配对邻居
+    double max_dx = max_ratio_side * max_length;
+    std::pmr::vector<char> keep(n, 0, arena);
+    for (int i = 0; i < n; i++) {
+        const rm::Lightbar& a = lightbar_list[order[i]];
+        for (int j = i + 1; j < n; j++) {
+            const rm::Lightbar& b = lightbar_list[order[j]];
+            if (b.center.x - a.center.x > max_dx) break;
+            if (keep[order[i]] && keep[order[j]]) continue;
+
+            double len_max = std::max(a.length, b.length);
+            double len_min = std::min(a.length, b.length);
+            if (len_min <= 0 || len_max / len_min > max_ratio_length) continue;
+            double distance = std::hypot(a.center.x - b.center.x, a.center.y - b.center.y);
+            if (distance > max_ratio_side * len_max) continue;
+
+            keep[order[i]] = keep[order[j]] = 1;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        if (keep[i]) candidate_list.push_back(lightbar_list[i]);
+    }
+}
+
+// 一行连续像素的灰度和与以区间起点为原点的一阶矩
+static void sumRowSpan(const uint8_t* row, int n, uint64_t& sum_w, uint64_t& sum_wk) {
+    int k = 0;
+#if CV_SIMD
+    const int lanes = cv::v_uint32::nlanes;
+    if (n >= lanes) {
+        unsigned index[cv::v_uint32::nlanes];
+        for (int i = 0; i < lanes; i++) index[i] = i;
+        cv::v_uint32 idx = cv::vx_load(index);
+        cv::v_uint32 step = cv::vx_setall_u32(lanes);
+        cv::v_uint32 acc_w = cv::vx_setzero_u32();
+        cv::v_uint32 acc_wk = cv::vx_setzero_u32();
+        for (; k <= n - lanes; k += lanes) {
+            cv::v_uint32 w = cv::vx_load_expand_q(row + k);
+            acc_w += w;
+            acc_wk += w * idx;
+            idx += step;
+        }
+        sum_w += cv::v_reduce_sum(acc_w);
+        sum_wk += cv::v_reduce_sum(acc_wk);
+    }
+#endif
+    for (; k < n; k++) {
+        sum_w += row[k];
+        sum_wk += (uint64_t)row[k] * k;
+    }
+}
+
+static cv::Point2f getBarycenter(
+    const cv::Mat& gray,
+    const cv::Point2f& center,
+    const cv::Point2f& axis_point,
+    const cv::Point2f& dir,
+    double radius,
+    double line_dist
+) {
+    int y0 = std::max(0, (int)std::ceil(center.y - radius));
+    int y1 = std::min(gray.rows - 1, (int)std::floor(center.y + radius));
+
+    double sum_w = 0.0, sum_wx = 0.0, sum_wy = 0.0;
+    for (int y = y0; y <= y1; y++) {
+        double dy = y - center.y;
+        double half = std::sqrt(std::max(0.0, radius * radius - dy * dy));
+        double lo = center.x - half, hi = center.x + half;
+
+        // 与轴线距离不超过 line_dist 的像素在每行构成一个区间
+        double cross = (y - axis_point.y) * dir.x;
+        if (std::fabs(dir.y) > 1e-6) {
+            double xa = axis_point.x + (cross - line_dist) / dir.y;
+            double xb = axis_point.x + (cross + line_dist) / dir.y;
+            lo = std::max(lo, std::min(xa, xb));
+            hi = std::min(hi, std::max(xa, xb));
+        } else if (std::fabs(cross) > line_dist) {
+            continue;
+        }
+
+        int x0 = std::max(0, (int)std::ceil(lo));
+        int x1 = std::min(gray.cols - 1, (int)std::floor(hi));
+        if (x1 < x0) continue;
+
+        uint64_t w = 0, wk = 0;
+        sumRowSpan(gray.ptr<uint8_t>(y) + x0, x1 - x0 + 1, w, wk);
+        sum_w += w;
+        sum_wx += (double)x0 * w + wk;
+        sum_wy += (double)y * w;
+    }
+    if (sum_w <= 0) return center;
+    return cv::Point2f(sum_wx / sum_w, sum_wy / sum_w);
+}
+
+std::pair<cv::Point2f, cv::Point2f> findLightbarEndpoints(
+    const rm::Lightbar& lightbar,
+    const cv::Mat& gray,
+    double line_dist,
+    double radius_ratio
+) {
+    // angle 为灯条与竖直方向夹角，端点按 y 排序，先上后下
+    double rad = lightbar.angle * M_PI / 180.0;
+    cv::Point2f dir(std::sin(rad), -std::cos(rad));
+    cv::Point2f half = dir * (float)(lightbar.length / 2.0);
+    cv::Point2f top = lightbar.center + half;
+    cv::Point2f bottom = lightbar.center - half;
+    if (top.y > bottom.y) std::swap(top, bottom);
+
+    double radius = std::max(1.0, lightbar.length * radius_ratio);
+    return std::make_pair(
+        getBarycenter(gray, top, lightbar.center, dir, radius, line_dist),
+        getBarycenter(gray, bottom, lightbar.center, dir, radius, line_dist));
+}
+
+// 暗背景上单根随机倾斜的亮条，灯条参数由 OpenRM 从轮廓中提取，保证与运行时的角度约定一致
+static bool makeSampleLightbar(cv::RNG& rng, cv::Mat& gray, rm::Lightbar& lightbar) {
+    gray = cv::Mat::zeros(cv::Size(160, 160), CV_8UC1);
+    cv::RotatedRect bar(
+        cv::Point2f(rng.uniform(50.f, 110.f), rng.uniform(50.f, 110.f)),
+        cv::Size2f(rng.uniform(2.f, 8.f), rng.uniform(15.f, 80.f)),
+        rng.uniform(-30.f, 30.f));
+    cv::Point2f corners[4];
+    bar.points(corners);
+    std::vector<cv::Point> polygon(corners, corners + 4);
+    cv::fillConvexPoly(gray, polygon, cv::Scalar(rng.uniform(120, 256)));
+
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<rm::Lightbar> lightbar_list;
+    cv::findContours(gray.clone(), contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_NONE);
+    rm::getLightbarsFromContours(contours, lightbar_list, 1.0, 1e4, 1.0, 0.0, 90.0);
+    if (lightbar_list.size() != 1) return false;
+    lightbar = lightbar_list[0];
+    return true;
+}
+
+bool checkLightbarEndpointParity(int samples, double line_dist, double radius_ratio, double tolerance) {
+    cv::RNG rng(0x5eed);
+    cv::Mat gray;
+    rm::Lightbar lightbar;
+
+    for (int i = 0; i < samples; i++) {
+        if (!makeSampleLightbar(rng, gray, lightbar)) continue;
+
+        auto points = findLightbarEndpoints(lightbar, gray, line_dist, radius_ratio);
+        auto points_ref = rm::findPointPairBarycenter(lightbar, gray, line_dist, radius_ratio);
+        double error = std::max(
+            std::hypot(points.first.x - points_ref.first.x, points.first.y - points_ref.first.y),
+            std::hypot(points.second.x - points_ref.second.x, points.second.y - points_ref.second.y));
+        if (!(error <= tolerance)) {
+            std::cout << "[LIGHTBAR-PAIR] 端点不一致: 偏差 " << error << " 像素" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void benchmarkLightbarPair(
+    double max_ratio_length,
+    double max_ratio_area,
+    double min_ratio_side,
+    double max_ratio_side,
+    double max_angle_diff,
+    double max_angle_avg,
+    double max_offset,
+    double line_dist,
+    double radius_ratio,
+    int iterations
+) {
+    const int counts[] = {4, 8, 16, 32, 64};
+    cv::RNG rng(0x5eed);
+
+    for (int count : counts) {
+        // 一对真实灯条加若干反光 / 背景噪声灯条，随机分布在 640x480 的 ROI 中
+        std::vector<rm::Lightbar> lightbar_list(count);
+        for (auto& lightbar : lightbar_list) {
+            lightbar.center = cv::Point2f(rng.uniform(0.f, 640.f), rng.uniform(0.f, 480.f));
+            lightbar.length = rng.uniform(5.f, 60.f);
+            lightbar.width = rng.uniform(1.f, 6.f);
+            lightbar.angle = rng.uniform(-30.f, 30.f);
+            lightbar.area = lightbar.length * lightbar.width;
+        }
+        lightbar_list[0].center = cv::Point2f(300.f, 240.f);
+        lightbar_list[1].center = cv::Point2f(360.f, 240.f);
+        lightbar_list[0].length = lightbar_list[1].length = 30.f;
+        lightbar_list[0].angle = lightbar_list[1].angle = 0.f;
+
+        std::vector<rm::Lightbar> candidate_list;
+        rm::LightbarPair pair, pair_ref;
+        bool flag = false, flag_ref = false;
+        cv::TickMeter sweep_meter, full_meter;
+        for (int i = 0; i < iterations; i++) {
+            rm::Armor armor, armor_ref;
+            sweep_meter.start();
+            FrameArena::local().reset();
+            sweepLightbarCandidates(lightbar_list, candidate_list, max_ratio_length, max_ratio_side);
+            flag = rm::getBestMatchedLightbarPair(
+                candidate_list, armor, pair, max_ratio_length, max_ratio_area, min_ratio_side,
+                max_ratio_side, max_angle_diff, max_angle_avg, max_offset);
+            sweep_meter.stop();
+
+            full_meter.start();
+            flag_ref = rm::getBestMatchedLightbarPair(
+                lightbar_list, armor_ref, pair_ref, max_ratio_length, max_ratio_area, min_ratio_side,
+                max_ratio_side, max_angle_diff, max_angle_avg, max_offset);
+            full_meter.stop();
+        }
+        bool same = (flag == flag_ref) && (!flag ||
+            (pair.first.center == pair_ref.first.center && pair.second.center == pair_ref.second.center));
+
+        std::cout << "[LIGHTBAR-PAIR] " << count << " 灯条 -> " << candidate_list.size() << " 候选 (" << iterations
+                  << " 次平均): sweep " << sweep_meter.getTimeMicro() / iterations
+                  << " us, openrm " << full_meter.getTimeMicro() / iterations
+                  << " us, 结果" << (same ? "一致" : "不一致") << std::endl;
+    }
+
+    cv::Mat gray;
+    rm::Lightbar lightbar;
+    while (!makeSampleLightbar(rng, gray, lightbar)) {}
+    cv::TickMeter line_meter, reference_meter;
+    for (int i = 0; i < iterations; i++) {
+        line_meter.start();
+        findLightbarEndpoints(lightbar, gray, line_dist, radius_ratio);
+        line_meter.stop();
+
+        reference_meter.start();
+        rm::findPointPairBarycenter(lightbar, gray, line_dist, radius_ratio);
+        reference_meter.stop();
+    }
+    std::cout << "[LIGHTBAR-PAIR] 端点重心 (" << iterations << " 次平均): line "
+              << line_meter.getTimeMicro() / iterations << " us, openrm "
+              << reference_meter.getTimeMicro() / iterations << " us" << std::endl;
+}
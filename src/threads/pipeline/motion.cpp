@@ -0,0 +1,120 @@
+#include "threads/pipeline/motion.h"
+#include <cmath>
+#include <algorithm>
+
+cv::Point2f getGimbalShift(const rm::Camera* camera, float yaw0, float pitch0, float yaw1, float pitch1) {
+    if (camera == nullptr || camera->intrinsic_matrix.empty()) return cv::Point2f(0, 0);
+
+    double fx = camera->intrinsic_matrix.at<double>(0, 0);
+    double fy = camera->intrinsic_matrix.at<double>(1, 1);
+    double dyaw = (yaw1 - yaw0) * M_PI / 180.0;
+    double dpitch = (pitch1 - pitch0) * M_PI / 180.0;
+    return cv::Point2f(-fx * std::tan(dyaw), -fy * std::tan(dpitch));
+}
+
+static std::vector<cv::Point2f> getCorners(const rm::YoloRect& yolo_rect) {
+    if (yolo_rect.four_points.size() == 4) return yolo_rect.four_points;
+
+    const cv::Rect& box = yolo_rect.box;
+    return {
+        cv::Point2f(box.x, box.y),
+        cv::Point2f(box.x, box.y + box.height),
+        cv::Point2f(box.x + box.width, box.y + box.height),
+        cv::Point2f(box.x + box.width, box.y)
+    };
+}
+
+std::vector<rm::YoloRect> propagateYoloRects(
+    const cv::Mat& prev_image,
+    const cv::Mat& image,
+    const std::vector<rm::YoloRect>& prev_list,
+    const cv::Point2f& shift,
+    double max_error
+) {
+    std::vector<rm::YoloRect> yolo_list;
+    cv::Rect image_rect(0, 0, image.cols, image.rows);
+
+    for (const auto& prev_rect : prev_list) {
+        // 搜索区域: 上一帧检测框向四周扩展一个框尺寸，并与云台补偿后的位置取并集
+        const cv::Rect& box = prev_rect.box;
+        cv::Rect search(box.x - box.width, box.y - box.height, box.width * 3, box.height * 3);
+        cv::Rect shifted = search;
+        shifted.x += (int)std::round(shift.x);
+        shifted.y += (int)std::round(shift.y);
+        cv::Rect roi = (search | shifted) & image_rect;
+        if (roi.width < 8 || roi.height < 8) continue;
+
+        cv::Mat prev_gray, gray;
+        cv::cvtColor(prev_image(roi), prev_gray, cv::COLOR_BGR2GRAY);
+        cv::cvtColor(image(roi), gray, cv::COLOR_BGR2GRAY);
+
+        std::vector<cv::Point2f> prev_points = getCorners(prev_rect);
+        std::vector<cv::Point2f> points, back_points;
+        cv::Point2f offset(roi.x, roi.y);
+        for (auto& point : prev_points) {
+            point = point - offset;
+            points.push_back(point + shift);
+        }
+        back_points = prev_points;
+
+        std::vector<uint8_t> status, back_status;
+        std::vector<float> error, back_error;
+        cv::TermCriteria criteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, 0.03);
+        cv::calcOpticalFlowPyrLK(
+            prev_gray, gray, prev_points, points, status, error,
+            cv::Size(15, 15), 2, criteria, cv::OPTFLOW_USE_INITIAL_FLOW);
+        cv::calcOpticalFlowPyrLK(
+            gray, prev_gray, points, back_points, back_status, back_error,
+            cv::Size(15, 15), 2, criteria, cv::OPTFLOW_USE_INITIAL_FLOW);
+
+        // 正反向一致性检查，任一角点跟踪失败即放弃该检测框
+        bool valid = true;
+        cv::Point2f motion(0, 0);
+        for (size_t i = 0; i < prev_points.size(); i++) {
+            cv::Point2f diff = back_points[i] - prev_points[i];
+            if (!status[i] || !back_status[i] || std::hypot(diff.x, diff.y) > max_error) {
+                valid = false;
+                break;
+            }
+            motion += points[i] - prev_points[i];
+        }
+        if (!valid) continue;
+        motion = motion * (1.0f / prev_points.size());
+
+        rm::YoloRect yolo_rect = prev_rect;
+        yolo_rect.box.x += (int)std::round(motion.x);
+        yolo_rect.box.y += (int)std::round(motion.y);
+        if (prev_rect.four_points.size() == 4) {
+            for (size_t i = 0; i < 4; i++) yolo_rect.four_points[i] = points[i] + offset;
+        }
+        yolo_list.push_back(yolo_rect);
+    }
+    return yolo_list;
+}
+
+double getYoloCornerError(const std::vector<rm::YoloRect>& propagated, const std::vector<rm::YoloRect>& detected) {
+    double error_sum = 0.0;
+    int count = 0;
+
+    for (const auto& yolo_rect : propagated) {
+        const rm::YoloRect* matched = nullptr;
+        double best_iou = 0.3;
+        for (const auto& detect_rect : detected) {
+            double inter = (yolo_rect.box & detect_rect.box).area();
+            double iou = inter / (yolo_rect.box.area() + detect_rect.box.area() - inter);
+            if (iou > best_iou) {
+                best_iou = iou;
+                matched = &detect_rect;
+            }
+        }
+        if (matched == nullptr) continue;
+
+        std::vector<cv::Point2f> a = getCorners(yolo_rect);
+        std::vector<cv::Point2f> b = getCorners(*matched);
+        for (size_t i = 0; i < 4; i++) {
+            error_sum += std::hypot(a[i].x - b[i].x, a[i].y - b[i].y);
+            count++;
+        }
+    }
+    return (count > 0) ? error_sum / count : -1.0;
+}
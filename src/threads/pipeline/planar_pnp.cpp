@@ -0,0 +1,257 @@
+#include "threads/pipeline/planar_pnp.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+PnPCamera getPnPCamera(const rm::Camera* camera) {
+    PnPCamera pnp_camera;
+    if (camera == nullptr || camera->intrinsic_matrix.empty()) return pnp_camera;
+
+    pnp_camera.fx = camera->intrinsic_matrix.at<double>(0, 0);
+    pnp_camera.fy = camera->intrinsic_matrix.at<double>(1, 1);
+    pnp_camera.cx = camera->intrinsic_matrix.at<double>(0, 2);
+    pnp_camera.cy = camera->intrinsic_matrix.at<double>(1, 2);
+
+    cv::Mat dist;
+    camera->distortion_coeffs.convertTo(dist, CV_64F);
+    dist = dist.reshape(1, 1);
+    double k[5] = {0, 0, 0, 0, 0};
+    pnp_camera.supported = true;
+    for (int i = 0; i < (int)dist.total(); i++) {
+        double value = dist.at<double>(0, i);
+        if (i < 5) k[i] = value;
+        else if (value != 0) pnp_camera.supported = false;
+    }
+    pnp_camera.k1 = k[0];
+    pnp_camera.k2 = k[1];
+    pnp_camera.p1 = k[2];
+    pnp_camera.p2 = k[3];
+    pnp_camera.k3 = k[4];
+    return pnp_camera;
+}
+
+// 与 cv::undistortPoints 默认终止条件一致的 5 次不动点迭代
+static Eigen::Vector2d undistortPoint(const PnPCamera& camera, const cv::Point2f& point) {
+    double x0 = (point.x - camera.cx) / camera.fx;
+    double y0 = (point.y - camera.cy) / camera.fy;
+    double x = x0, y = y0;
+    for (int i = 0; i < 5; i++) {
+        double r2 = x * x + y * y;
+        double icdist = 1.0 / (1 + ((camera.k3 * r2 + camera.k2) * r2 + camera.k1) * r2);
+        if (icdist < 0) {
+            x = x0;
+            y = y0;
+            break;
+        }
+        double delta_x = 2 * camera.p1 * x * y + camera.p2 * (r2 + 2 * x * x);
+        double delta_y = camera.p1 * (r2 + 2 * y * y) + 2 * camera.p2 * x * y;
+        x = (x0 - delta_x) * icdist;
+        y = (y0 - delta_y) * icdist;
+    }
+    return Eigen::Vector2d(x, y);
+}
+
+// 固定旋转下平移的线性最小二乘: x_i (R P_i + t)_z = (R P_i + t)_x，y 方向同理
+static Eigen::Vector3d solveTranslation(
+    const Eigen::Matrix3d& rotation,
+    const Eigen::Matrix<double, 3, 4>& object,
+    const Eigen::Matrix<double, 2, 4>& image
+) {
+    Eigen::Matrix3d ata = Eigen::Matrix3d::Zero();
+    Eigen::Vector3d atb = Eigen::Vector3d::Zero();
+    for (int i = 0; i < 4; i++) {
+        Eigen::Vector3d rp = rotation * object.col(i);
+        double x = image(0, i), y = image(1, i);
+        Eigen::Vector3d row_x(1, 0, -x), row_y(0, 1, -y);
+        ata += row_x * row_x.transpose() + row_y * row_y.transpose();
+        atb += row_x * (x * rp.z() - rp.x()) + row_y * (y * rp.z() - rp.y());
+    }
+    return ata.ldlt().solve(atb);
+}
+
+static double getReprojectError(
+    const Eigen::Matrix3d& rotation,
+    const Eigen::Vector3d& translation,
+    const Eigen::Matrix<double, 3, 4>& object,
+    const Eigen::Matrix<double, 2, 4>& image
+) {
+    double sum = 0.0;
+    for (int i = 0; i < 4; i++) {
+        Eigen::Vector3d p = rotation * object.col(i) + translation;
+        if (p.z() <= 0) return 1e9;
+        sum += (p.head<2>() / p.z() - image.col(i)).squaredNorm();
+    }
+    return std::sqrt(sum / 4.0);
+}
+
+static PlanarPose solveSingle(const PnPCamera& camera, const PlanarPnPInput& input) {
+    PlanarPose pose;
+    if (input.object == nullptr || input.image == nullptr) return pose;
+    if (input.object->size() != 4 || input.image->size() != 4) return pose;
+
+    Eigen::Matrix<double, 3, 4> object;
+    Eigen::Matrix<double, 2, 4> image;
+    Eigen::Vector2d mean = Eigen::Vector2d::Zero();
+    for (int i = 0; i < 4; i++) {
+        const cv::Point3f& p = (*input.object)[i];
+        object.col(i) = Eigen::Vector3d(p.x, p.y, p.z);
+        image.col(i) = undistortPoint(camera, (*input.image)[i]);
+        mean += object.col(i).head<2>();
+    }
+    mean /= 4.0;
+
+    // 中心化模型点到归一化像点的单应 (h22 = 1)，四点恰好确定
+    Eigen::Matrix<double, 8, 8> a;
+    Eigen::Matrix<double, 8, 1> b;
+    for (int i = 0; i < 4; i++) {
+        double x = object(0, i) - mean.x(), y = object(1, i) - mean.y();
+        double u = image(0, i), v = image(1, i);
+        a.row(2 * i)     << x, y, 1, 0, 0, 0, -u * x, -u * y;
+        a.row(2 * i + 1) << 0, 0, 0, x, y, 1, -v * x, -v * y;
+        b(2 * i) = u;
+        b(2 * i + 1) = v;
+    }
+    Eigen::Matrix<double, 8, 1> h = a.partialPivLu().solve(b);
+    if (!h.allFinite()) return pose;
+
+    // 单应在模型中心处的雅可比与中心的像点
+    Eigen::Matrix2d jacobian;
+    jacobian << h(0) - h(6) * h(2), h(1) - h(7) * h(2),
+                h(3) - h(6) * h(5), h(4) - h(7) * h(5);
+    double p = h(2), q = h(5);
+
+    // Rv 将 z 轴转到视线 (p, q, 1) 方向
+    Eigen::Matrix3d rv = Eigen::Quaterniond::FromTwoVectors(
+        Eigen::Vector3d::UnitZ(), Eigen::Vector3d(p, q, 1).normalized()).toRotationMatrix();
+    Eigen::Matrix<double, 2, 3> proj;
+    proj << 1, 0, -p,
+            0, 1, -q;
+    Eigen::Matrix2d bmat = proj * rv.leftCols<2>();
+    Eigen::Matrix2d amat = bmat.inverse() * jacobian;
+
+    // A 的最大奇异值
+    double ata00 = amat.row(0).squaredNorm();
+    double ata11 = amat.row(1).squaredNorm();
+    double ata01 = amat.row(0).dot(amat.row(1));
+    double gamma2 = 0.5 * (ata00 + ata11 + std::sqrt((ata00 - ata11) * (ata00 - ata11) + 4.0 * ata01 * ata01));
+    if (!(gamma2 > 0)) return pose;
+    Eigen::Matrix2d rtilde = amat / std::sqrt(gamma2);
+
+    double b0 = std::sqrt(std::max(0.0, 1.0 - rtilde.col(0).squaredNorm()));
+    double b1 = std::sqrt(std::max(0.0, 1.0 - rtilde.col(1).squaredNorm()));
+    if (-rtilde.col(0).dot(rtilde.col(1)) < 0) b1 = -b1;
+
+    double best_error = 1e9;
+    for (int sign : {1, -1}) {
+        Eigen::Vector3d c1(rtilde(0, 0), rtilde(1, 0), sign * b0);
+        Eigen::Vector3d c2(rtilde(0, 1), rtilde(1, 1), sign * b1);
+        Eigen::Matrix3d local;
+        local << c1, c2, c1.cross(c2);
+        Eigen::Matrix3d rotation = rv * local;
+
+        Eigen::Vector3d translation = solveTranslation(rotation, object, image);
+        double error = getReprojectError(rotation, translation, object, image);
+        if (error < best_error) {
+            best_error = error;
+            pose.rotation = rotation;
+            pose.translation = translation;
+        }
+    }
+    pose.error = best_error;
+    pose.valid = best_error < 1e9 && pose.translation.allFinite();
+    return pose;
+}
+
+void solvePlanarPnP(const PnPCamera& camera, const std::vector<PlanarPnPInput>& inputs, std::vector<PlanarPose>& poses) {
+    poses.resize(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) poses[i] = solveSingle(camera, inputs[i]);
+}
+
+void getPoseDiff(const PlanarPose& a, const PlanarPose& b, double& angle_diff, double& trans_diff) {
+    Eigen::Matrix3d delta = a.rotation.transpose() * b.rotation;
+    double cos_angle = std::clamp((delta.trace() - 1.0) / 2.0, -1.0, 1.0);
+    angle_diff = std::acos(cos_angle) * 180.0 / M_PI;
+    trans_diff = (a.translation - b.translation).norm();
+}
+
+// 随机位姿: 距离 1 ~ 8 m，装甲板朝向 ±60°，像点加 0.3 像素噪声
+static void makePlanarSamples(const rm::Camera* camera, const std::vector<cv::Point3f>& object,
+                              std::vector<std::vector<cv::Point2f>>& samples) {
+    cv::RNG rng(0x5eed);
+    samples.clear();
+    for (int i = 0; i < 64; i++) {
+        cv::Mat rvec = (cv::Mat_<double>(3, 1) << rng.uniform(-0.2, 0.2), rng.uniform(-1.0, 1.0), rng.uniform(-0.2, 0.2));
+        cv::Mat tvec = (cv::Mat_<double>(3, 1) << rng.uniform(-800.0, 800.0), rng.uniform(-400.0, 400.0), rng.uniform(1000.0, 8000.0));
+        std::vector<cv::Point2f> image;
+        cv::projectPoints(object, rvec, tvec, camera->intrinsic_matrix, camera->distortion_coeffs, image);
+        for (auto& point : image) point += cv::Point2f(rng.gaussian(0.3), rng.gaussian(0.3));
+        samples.push_back(image);
+    }
+}
+
+// cv::solvePnP(SOLVEPNP_IPPE) + Rodrigues，与闭式解输出同一约定
+static PlanarPose solveIppe(const rm::Camera* camera, const std::vector<cv::Point3f>& object, const std::vector<cv::Point2f>& image) {
+    cv::Mat rvec, tvec, rotate_cv;
+    cv::solvePnP(object, image, camera->intrinsic_matrix, camera->distortion_coeffs,
+                 rvec, tvec, false, cv::SOLVEPNP_IPPE);
+    cv::Rodrigues(rvec, rotate_cv);
+
+    PlanarPose pose;
+    rm::tf_Mat3d(rotate_cv, pose.rotation);
+    pose.translation = Eigen::Vector3d(tvec.at<double>(0), tvec.at<double>(1), tvec.at<double>(2));
+    pose.valid = true;
+    return pose;
+}
+
+bool checkPlanarPnP(const rm::Camera* camera, const std::vector<cv::Point3f>& object, double& max_angle, double& max_trans) {
+    max_angle = max_trans = 0.0;
+    PnPCamera pnp_camera = getPnPCamera(camera);
+    if (!pnp_camera.supported) return false;
+
+    std::vector<std::vector<cv::Point2f>> samples;
+    makePlanarSamples(camera, object, samples);
+    std::vector<PlanarPnPInput> inputs;
+    for (const auto& image : samples) inputs.push_back({&object, &image});
+    std::vector<PlanarPose> poses;
+    solvePlanarPnP(pnp_camera, inputs, poses);
+
+    for (size_t j = 0; j < samples.size(); j++) {
+        if (!poses[j].valid) return false;
+        double angle_diff, trans_diff;
+        getPoseDiff(poses[j], solveIppe(camera, object, samples[j]), angle_diff, trans_diff);
+        max_angle = std::max(max_angle, angle_diff);
+        max_trans = std::max(max_trans, trans_diff);
+    }
+    return true;
+}
+
+void benchmarkPlanarPnP(const rm::Camera* camera, const std::vector<cv::Point3f>& object, int iterations) {
+    double max_angle, max_trans;
+    if (!checkPlanarPnP(camera, object, max_angle, max_trans)) {
+        std::cout << "[PLANAR-PNP] 相机参数不可用或含高阶畸变，跳过" << std::endl;
+        return;
+    }
+    PnPCamera pnp_camera = getPnPCamera(camera);
+
+    std::vector<std::vector<cv::Point2f>> samples;
+    makePlanarSamples(camera, object, samples);
+    std::vector<PlanarPnPInput> inputs;
+    for (const auto& image : samples) inputs.push_back({&object, &image});
+    std::vector<PlanarPose> poses;
+    cv::TickMeter planar_meter, ippe_meter;
+    for (int i = 0; i < iterations; i++) {
+        planar_meter.start();
+        solvePlanarPnP(pnp_camera, inputs, poses);
+        planar_meter.stop();
+
+        ippe_meter.start();
+        for (const auto& image : samples) solveIppe(camera, object, image);
+        ippe_meter.stop();
+    }
+
+    int count = iterations * samples.size();
+    std::cout << "[PLANAR-PNP] 单块装甲板 (" << count << " 次平均): planar "
+              << planar_meter.getTimeMicro() / count << " us, opencv ippe "
+              << ippe_meter.getTimeMicro() / count << " us, 最大偏差 "
+              << max_angle << " deg / " << max_trans << std::endl;
+}
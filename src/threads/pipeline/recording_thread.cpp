@@ -1,4 +1,5 @@
 #include "threads/pipeline.h"
+#include "data_manager/config.h"
 #include <atomic>
 extern std::atomic<bool> g_running;
 #include <thread>
@@ -12,7 +13,7 @@ void Pipeline::record(std::shared_ptr<rm::Frame> frame_record) {
 }
 
 void Pipeline::recording_thread(std::mutex& mutex_in, bool& flag_in, std::shared_ptr<rm::Frame>& frame_in) {
-    auto param = Param::get_instance();
+    ConfigPtr config = getConfigSnapshot();
     unsigned long long int frame_count = 0;
 
     cv::VideoWriter writer;
@@ -35,7 +36,7 @@ void Pipeline::recording_thread(std::mutex& mutex_in, bool& flag_in, std::shared
 
         if(frame == nullptr) continue;
         if(frame_count == 0) {
-            std::string filedir = (*param)["Camera"]["VideoSaveDir"];
+            std::string filedir = config->video_save_dir;
             filedir = filedir +  "/" + getTimeStr() + ".avi";
             rm::message("Recording to " + filedir, rm::MSG_NOTE);
             
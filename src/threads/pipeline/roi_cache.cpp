@@ -0,0 +1,94 @@
+#include "threads/pipeline/roi_cache.h"
+#include <algorithm>
+
+void DetectionRoi::reset(const cv::Mat& image, const cv::Rect& box) {
+    image_ = image;
+    box_ = box;
+    for (int i = 0; i < planes_count_; i++) planes_[i].ready = false;
+    planes_count_ = 0;
+    last_planes_ = -1;
+    patch_ready_ = false;
+    pixels_ = 0;
+}
+
+RoiPlanes& DetectionRoi::planes(const cv::Rect& rect) {
+    for (int i = 0; i < planes_count_; i++) {
+        if (planes_[i].rect == rect) {
+            last_planes_ = i;
+            return planes_[i];
+        }
+    }
+    if ((int)planes_.size() <= planes_count_) planes_.emplace_back();
+    RoiPlanes& slot = planes_[planes_count_];
+    slot.rect = rect;
+    slot.ready = false;
+    last_planes_ = planes_count_++;
+    return slot;
+}
+
+const RoiPlanes* DetectionRoi::lastPlanes() const {
+    if (last_planes_ < 0 || !planes_[last_planes_].ready) return nullptr;
+    return &planes_[last_planes_];
+}
+
+const cv::Mat& DetectionRoi::patch(const cv::Size& size, int padding) {
+    if (patch_ready_) return patch_;
+
+    // 与原分类器裁剪一致: 起点截断到图像内，宽高保持外扩后的尺寸再截断到图像边界
+    cv::Rect rect;
+    rect.x = std::max(0, box_.x - padding);
+    rect.y = std::max(0, box_.y - padding);
+    rect.width = std::min(image_.cols - rect.x, box_.width + 2 * padding);
+    rect.height = std::min(image_.rows - rect.y, box_.height + 2 * padding);
+    if (rect.width <= 0 || rect.height <= 0) {
+        patch_.release();
+    } else {
+        cv::resize(image_(rect), patch_, size);
+        touch(rect.area());
+    }
+    patch_ready_ = true;
+    return patch_;
+}
+
+double FrameRois::getPixelsPerRoi() const {
+    if (count == 0) return 0.0;
+    long long pixels = 0;
+    for (size_t i = 0; i < count; i++) pixels += rois[i].pixels();
+    return (double)pixels / count;
+}
+
+FrameRois& RoiCache::acquire(const rm::Frame& frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unique_ptr<FrameRois>& rois = active_[&frame];
+    if (!rois) {
+        if (!pool_.empty()) {
+            rois = std::move(pool_.back());
+            pool_.pop_back();
+        } else {
+            rois = std::make_unique<FrameRois>();
+        }
+    }
+
+    rois->count = frame.yolo_list.size();
+    if (rois->rois.size() < rois->count) rois->rois.resize(rois->count);
+    for (size_t i = 0; i < rois->count; i++) rois->rois[i].reset(*frame.image, frame.yolo_list[i].box);
+    return *rois;
+}
+
+FrameRois* RoiCache::find(const rm::Frame& frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = active_.find(&frame);
+    return (it == active_.end()) ? nullptr : it->second.get();
+}
+
+void RoiCache::release(const rm::Frame& frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = active_.find(&frame);
+    if (it == active_.end()) return;
+
+    // 释放对原图的引用，缓冲区保留
+    for (size_t i = 0; i < it->second->count; i++) it->second->rois[i].reset(cv::Mat(), cv::Rect());
+    it->second->count = 0;
+    pool_.push_back(std::move(it->second));
+    active_.erase(it);
+}
@@ -0,0 +1,193 @@
+#include "threads/pipeline/roi_kernel.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+// 与 OpenCV RGB2Gray<uchar> 相同的 14 位定点系数与舍入
+static const int kGrayShift = 14;
+static const int kGrayB = 1868;
+static const int kGrayG = 9617;
+static const int kGrayR = 4899;
+
+#if CV_SIMD
+static inline cv::v_uint16 grayOf(const cv::v_uint16& b, const cv::v_uint16& g, const cv::v_uint16& r) {
+    const cv::v_uint32 cb = cv::vx_setall_u32(kGrayB);
+    const cv::v_uint32 cg = cv::vx_setall_u32(kGrayG);
+    const cv::v_uint32 cr = cv::vx_setall_u32(kGrayR);
+    const cv::v_uint32 half = cv::vx_setall_u32(1 << (kGrayShift - 1));
+
+    cv::v_uint32 b0, b1, g0, g1, r0, r1;
+    cv::v_expand(b, b0, b1);
+    cv::v_expand(g, g0, g1);
+    cv::v_expand(r, r0, r1);
+    cv::v_uint32 y0 = (b0 * cb + g0 * cg + r0 * cr + half) >> kGrayShift;
+    cv::v_uint32 y1 = (b1 * cb + g1 * cg + r1 * cr + half) >> kGrayShift;
+    return cv::v_pack(y0, y1);
+}
+#endif
+
+void fuseRoiGray(const cv::Mat& roi, cv::Mat& gray, RoiStats& stats, int color_floor) {
+    int rows = roi.rows, cols = roi.cols;
+    gray.create(rows, cols, CV_8UC1);
+    stats.col_count.assign(cols, 0);
+    stats.col_red.assign(cols, 0);
+    stats.col_blue.assign(cols, 0);
+
+    // 4 路子直方图打断相邻像素落入同一灰度级时的写后读依赖
+    int hist[4][256] = {};
+
+    for (int y = 0; y < rows; y++) {
+        const uint8_t* src = roi.ptr<uint8_t>(y);
+        uint8_t* dst = gray.ptr<uint8_t>(y);
+
+        int x = 0;
+#if CV_SIMD
+        for (; x <= cols - cv::v_uint8::nlanes; x += cv::v_uint8::nlanes) {
+            cv::v_uint8 b, g, r;
+            cv::v_load_deinterleave(src + 3 * x, b, g, r);
+            cv::v_uint16 b0, b1, g0, g1, r0, r1;
+            cv::v_expand(b, b0, b1);
+            cv::v_expand(g, g0, g1);
+            cv::v_expand(r, r0, r1);
+            cv::v_store(dst + x, cv::v_pack(grayOf(b0, g0, r0), grayOf(b1, g1, r1)));
+        }
+#endif
+        for (; x < cols; x++) {
+            const uint8_t* p = src + 3 * x;
+            dst[x] = (uint8_t)((p[0] * kGrayB + p[1] * kGrayG + p[2] * kGrayR + (1 << (kGrayShift - 1))) >> kGrayShift);
+        }
+
+        // 直方图与逐列颜色和为分散写入，逐像素处理，读取的行数据仍在 L1 中
+        for (x = 0; x < cols; x++) {
+            uint8_t v = dst[x];
+            hist[x & 3][v]++;
+            if (v >= color_floor) {
+                stats.col_count[x]++;
+                stats.col_red[x] += src[3 * x + 2];
+                stats.col_blue[x] += src[3 * x];
+            }
+        }
+    }
+
+    for (int i = 0; i < 256; i++) stats.hist[i] = hist[0][i] + hist[1][i] + hist[2][i] + hist[3][i];
+}
+
+int getThresholdFromRoiHist(const RoiStats& stats, int bin, double ratio) {
+    int total = 0;
+    for (int i = 0; i < 256; i++) total += stats.hist[i];
+    if (total == 0 || bin <= 0) return 0;
+
+    double target = total * ratio / 100.0;
+    int count = 0;
+    for (int k = (256 + bin - 1) / bin - 1; k >= 0; k--) {
+        int end = std::min(256, (k + 1) * bin);
+        for (int i = k * bin; i < end; i++) count += stats.hist[i];
+        if (count >= target) return k * bin;
+    }
+    return 0;
+}
+
+rm::ArmorColor getLightbarPairColor(const RoiStats& stats, const rm::LightbarPair& pair) {
+    int cols = (int)stats.col_count.size();
+    long long red = 0, blue = 0;
+    int count = 0;
+
+    for (const rm::Lightbar* lightbar : {&pair.first, &pair.second}) {
+        if (!std::isfinite(lightbar->center.x)) continue;
+        double half_width = std::max(1.0, (double)lightbar->width / 2.0);
+        int x0 = std::clamp((int)std::floor(lightbar->center.x - half_width), 0, cols);
+        int x1 = std::clamp((int)std::ceil(lightbar->center.x + half_width) + 1, 0, cols);
+        for (int x = x0; x < x1; x++) {
+            count += stats.col_count[x];
+            red += stats.col_red[x];
+            blue += stats.col_blue[x];
+        }
+    }
+    if (count == 0) return rm::ARMOR_COLOR_NONE;
+    return (red > blue) ? rm::ARMOR_COLOR_RED : rm::ARMOR_COLOR_BLUE;
+}
+
+// 暗背景上叠加若干随机颜色的亮条，取自更大图像的子区域以覆盖非连续内存
+static cv::Mat makeSampleRoi(cv::RNG& rng, cv::Mat& base, int width, int height) {
+    base.create(height + 8, width + 8, CV_8UC3);
+    cv::randu(base, cv::Scalar(0, 0, 0), cv::Scalar(60, 60, 60));
+    cv::Mat roi = base(cv::Rect(4, 4, width, height));
+
+    int bars = rng.uniform(1, 4);
+    for (int i = 0; i < bars; i++) {
+        int w = rng.uniform(1, std::max(2, width / 8));
+        int h = rng.uniform(2, height);
+        cv::Rect bar(rng.uniform(0, width - w + 1), rng.uniform(0, height - h + 1), w, h);
+        cv::Scalar color(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+        cv::rectangle(roi, bar, color, cv::FILLED);
+    }
+    return roi;
+}
+
+bool checkRoiKernelParity(int samples, rm::ArmorColor enemy_color, double ratio) {
+    cv::RNG rng(0x5eed);
+    cv::Mat base, gray, gray_ref;
+    RoiStats stats;
+
+    for (int i = 0; i < samples; i++) {
+        int width = rng.uniform(8, 320);
+        int height = rng.uniform(8, 240);
+        cv::Mat roi = makeSampleRoi(rng, base, width, height);
+
+        rm::getGrayScale(roi, gray_ref, enemy_color, rm::GRAY_SCALE_METHOD_CVT);
+        int threshold_ref = rm::getThresholdFromHist(roi, 8, ratio);
+
+        fuseRoiGray(roi, gray, stats, 255);
+        int threshold = getThresholdFromRoiHist(stats, 8, ratio);
+
+        if (gray.size() != gray_ref.size() || cv::norm(gray, gray_ref, cv::NORM_INF) != 0) {
+            std::cout << "[ROI-KERNEL] 灰度不一致: " << width << "x" << height << std::endl;
+            return false;
+        }
+        if (threshold != threshold_ref) {
+            std::cout << "[ROI-KERNEL] 阈值不一致: " << width << "x" << height
+                      << " fused=" << threshold << " openrm=" << threshold_ref << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void benchmarkRoiKernel(rm::ArmorColor enemy_color, double ratio, int iterations) {
+    const cv::Size sizes[] = {{32, 24}, {64, 48}, {128, 96}, {256, 192}, {512, 384}};
+    cv::RNG rng(0x5eed);
+    cv::Mat base, gray, binary;
+    RoiStats stats;
+
+    for (const auto& size : sizes) {
+        cv::Mat roi = makeSampleRoi(rng, base, size.width, size.height);
+
+        rm::LightbarPair pair;
+        pair.first.center = cv::Point2f(size.width * 0.25f, size.height * 0.5f);
+        pair.second.center = cv::Point2f(size.width * 0.75f, size.height * 0.5f);
+        pair.first.length = pair.second.length = size.height * 0.5f;
+        pair.first.width = pair.second.width = std::max(2.f, size.width / 16.f);
+
+        cv::TickMeter fused_meter, reference_meter;
+        for (int i = 0; i < iterations; i++) {
+            fused_meter.start();
+            fuseRoiGray(roi, gray, stats, 100);
+            int threshold = std::clamp(getThresholdFromRoiHist(stats, 8, ratio), 10, 100);
+            rm::getBinary(gray, binary, threshold, rm::BINARY_METHOD_DIRECT_THRESHOLD);
+            getLightbarPairColor(stats, pair);
+            fused_meter.stop();
+
+            reference_meter.start();
+            rm::getGrayScale(roi, gray, enemy_color, rm::GRAY_SCALE_METHOD_CVT);
+            threshold = std::clamp(rm::getThresholdFromHist(roi, 8, ratio), 10, 100);
+            rm::getBinary(gray, binary, threshold, rm::BINARY_METHOD_DIRECT_THRESHOLD);
+            rm::getArmorColorFromHSV(roi, pair);
+            reference_meter.stop();
+        }
+
+        std::cout << "[ROI-KERNEL] " << size.width << "x" << size.height << " (" << iterations
+                  << " 次平均): fused " << fused_meter.getTimeMicro() / iterations
+                  << " us, openrm " << reference_meter.getTimeMicro() / iterations << " us" << std::endl;
+    }
+}
@@ -0,0 +1,215 @@
+#include "threads/pipeline/run_length.h"
+#include "threads/pipeline/scratch.h"
+#include <iostream>
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+struct Run {
+    int y, x0, x1;  // 闭区间 [x0, x1]
+};
+
+static int findRoot(std::pmr::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// 0^2 + 1^2 + ... + k^2
+static long long sumSquare(long long k) {
+    return (k < 0) ? 0 : k * (k + 1) * (2 * k + 1) / 6;
+}
+
+void getRunLengthContours(
+    const cv::Mat& binary,
+    std::vector<std::vector<cv::Point>>& contours,
+    std::vector<RunComponent>& components,
+    int min_area
+) {
+    // 临时数组从线程单调分配区分配；多出的轮廓移入备用池，保留容量供后续复用
+    static thread_local std::vector<std::vector<cv::Point>> spare_contours;
+    std::pmr::memory_resource* arena = FrameArena::local().resource();
+    while (!contours.empty()) {
+        spare_contours.push_back(std::move(contours.back()));
+        contours.pop_back();
+    }
+    components.clear();
+
+    // 逐行提取游程，与上一行重叠或对角相邻的游程合并到同一连通域 (根为较小的游程下标)
+    std::pmr::vector<Run> runs(arena);
+    std::pmr::vector<int> parent(arena);
+    int prev_begin = 0, prev_end = 0;
+    for (int y = 0; y < binary.rows; y++) {
+        const uint8_t* row = binary.ptr<uint8_t>(y);
+        int cur_begin = runs.size();
+        int x = 0;
+        while (x < binary.cols) {
+            while (x < binary.cols && row[x] == 0) x++;
+            if (x >= binary.cols) break;
+            int x0 = x;
+            while (x < binary.cols && row[x] != 0) x++;
+            runs.push_back({y, x0, x - 1});
+            parent.push_back(runs.size() - 1);
+        }
+        int cur_end = runs.size();
+
+        int j = prev_begin;
+        for (int i = cur_begin; i < cur_end; i++) {
+            while (j < prev_end && runs[j].x1 < runs[i].x0 - 1) j++;
+            for (int k = j; k < prev_end && runs[k].x0 <= runs[i].x1 + 1; k++) {
+                int a = findRoot(parent, i);
+                int b = findRoot(parent, k);
+                if (a != b) parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+        prev_begin = cur_begin;
+        prev_end = cur_end;
+    }
+
+    // 按连通域累加面积、一阶与二阶矩
+    struct Accumulator {
+        long long area = 0, sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+        int top = INT_MAX, bottom = -1;
+    };
+    std::pmr::vector<int> label(runs.size(), -1, arena);
+    std::pmr::vector<int> root_label(runs.size(), -1, arena);
+    std::pmr::vector<Accumulator> acc(arena);
+    for (int i = 0; i < (int)runs.size(); i++) {
+        int root = findRoot(parent, i);
+        if (root_label[root] < 0) {
+            root_label[root] = acc.size();
+            acc.emplace_back();
+        }
+        label[i] = root_label[root];
+
+        const Run& run = runs[i];
+        Accumulator& a = acc[label[i]];
+        long long n = run.x1 - run.x0 + 1;
+        long long sum_x = n * (run.x0 + run.x1) / 2;
+        a.area += n;
+        a.sx += sum_x;
+        a.sy += n * run.y;
+        a.sxx += sumSquare(run.x1) - sumSquare(run.x0 - 1);
+        a.syy += n * run.y * run.y;
+        a.sxy += sum_x * run.y;
+        a.top = std::min(a.top, run.y);
+        a.bottom = std::max(a.bottom, run.y);
+    }
+
+    // 每行的最左与最右像素，8 邻域连通域的行范围连续，各连通域按 offset 存放在同一数组中
+    std::pmr::vector<int> offset(acc.size() + 1, 0, arena);
+    for (int c = 0; c < (int)acc.size(); c++) {
+        int rows = (acc[c].area < min_area) ? 0 : acc[c].bottom - acc[c].top + 1;
+        offset[c + 1] = offset[c] + rows;
+    }
+    std::pmr::vector<int> left(offset.back(), INT_MAX, arena), right(offset.back(), -1, arena);
+    for (int i = 0; i < (int)runs.size(); i++) {
+        int c = label[i];
+        if (offset[c + 1] == offset[c]) continue;
+        int r = offset[c] + runs[i].y - acc[c].top;
+        left[r] = std::min(left[r], runs[i].x0);
+        right[r] = std::max(right[r], runs[i].x1);
+    }
+
+    for (int c = 0; c < (int)acc.size(); c++) {
+        if (offset[c + 1] == offset[c]) continue;
+        const Accumulator& a = acc[c];
+
+        RunComponent component;
+        component.area = a.area;
+        component.top = a.top;
+        component.bottom = a.bottom;
+        component.cx = (double)a.sx / a.area;
+        component.cy = (double)a.sy / a.area;
+        // 像素视为单位正方形，方差补 1/12
+        component.mu20 = (double)a.sxx / a.area - component.cx * component.cx + 1.0 / 12.0;
+        component.mu02 = (double)a.syy / a.area - component.cy * component.cy + 1.0 / 12.0;
+        component.mu11 = (double)a.sxy / a.area - component.cx * component.cy;
+
+        double half_sum = (component.mu20 + component.mu02) / 2.0;
+        double half_diff = std::sqrt(std::pow((component.mu20 - component.mu02) / 2.0, 2) + std::pow(component.mu11, 2));
+        component.length = std::sqrt(12.0 * (half_sum + half_diff));
+        component.width = std::sqrt(12.0 * std::max(0.0, half_sum - half_diff));
+        double theta = 0.5 * std::atan2(2.0 * component.mu11, component.mu20 - component.mu02) * 180.0 / M_PI;
+        component.angle = (theta > 0) ? theta - 90.0 : theta + 90.0;
+        components.push_back(component);
+
+        // 左边界自上而下、右边界自下而上，补齐相邻行之间沿水平方向的边界像素
+        const int* l = left.data() + offset[c];
+        const int* r = right.data() + offset[c];
+        int rows = offset[c + 1] - offset[c];
+        if (spare_contours.empty()) {
+            contours.emplace_back();
+        } else {
+            contours.push_back(std::move(spare_contours.back()));
+            spare_contours.pop_back();
+        }
+        std::vector<cv::Point>& contour = contours.back();
+        contour.clear();
+        for (int i = 0; i < rows; i++) {
+            int y = a.top + i;
+            if (i > 0) {
+                int p = l[i - 1], q = l[i];
+                for (int x = p + 1; x < q; x++) contour.emplace_back(x, y - 1);
+                for (int x = p - 1; x > q; x--) contour.emplace_back(x, y);
+            }
+            contour.emplace_back(l[i], y);
+        }
+        for (int i = rows - 1; i >= 0; i--) {
+            int y = a.top + i;
+            if (i < rows - 1) {
+                int p = r[i + 1], q = r[i];
+                for (int x = p + 1; x < q; x++) contour.emplace_back(x, y);
+                for (int x = p - 1; x > q; x--) contour.emplace_back(x, y + 1);
+            }
+            // 单像素宽的首末行左右端点重合，不重复输出
+            if ((i == rows - 1 || i == 0) && r[i] == l[i]) continue;
+            contour.emplace_back(r[i], y);
+        }
+    }
+}
+
+void benchmarkRunLength(int iterations) {
+    const cv::Size sizes[] = {{64, 48}, {128, 96}, {256, 192}, {512, 384}};
+    cv::RNG rng(0x5eed);
+
+    for (const auto& size : sizes) {
+        // 随机倾斜的细长亮条，模拟 ROI 二值化后的灯条
+        cv::Mat binary = cv::Mat::zeros(size, CV_8UC1);
+        for (int i = 0; i < 6; i++) {
+            cv::RotatedRect bar(
+                cv::Point2f(rng.uniform(0.f, (float)size.width), rng.uniform(0.f, (float)size.height)),
+                cv::Size2f(rng.uniform(2.f, size.width / 16.f + 3.f), rng.uniform(size.height / 8.f, size.height / 2.f)),
+                rng.uniform(-30.f, 30.f));
+            cv::Point2f corners[4];
+            bar.points(corners);
+            std::vector<cv::Point> polygon(corners, corners + 4);
+            cv::fillConvexPoly(binary, polygon, cv::Scalar(255));
+        }
+
+        std::vector<std::vector<cv::Point>> contours, rle_contours;
+        std::vector<RunComponent> components;
+        cv::TickMeter contour_meter, rle_meter;
+        for (int i = 0; i < iterations; i++) {
+            contour_meter.start();
+            cv::findContours(binary, contours, cv::RETR_LIST, cv::CHAIN_APPROX_NONE);
+            contour_meter.stop();
+
+            rle_meter.start();
+            FrameArena::local().reset();
+            getRunLengthContours(binary, rle_contours, components, 1);
+            rle_meter.stop();
+        }
+
+        double area = 0.0, rle_area = 0.0;
+        for (const auto& contour : contours) area += cv::contourArea(contour);
+        for (const auto& contour : rle_contours) rle_area += cv::contourArea(contour);
+
+        std::cout << "[RUN-LENGTH] " << size.width << "x" << size.height << " (" << iterations
+                  << " 次平均): findContours " << contour_meter.getTimeMicro() / iterations
+                  << " us / " << contours.size() << " 条, run-length " << rle_meter.getTimeMicro() / iterations
+                  << " us / " << rle_contours.size() << " 条, 面积差 " << rle_area - area << std::endl;
+    }
+}
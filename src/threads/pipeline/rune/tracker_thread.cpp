@@ -1,5 +1,6 @@
 #include "threads/pipeline.h"
 #include "threads/control.h"
+#include "data_manager/undistort.h"
 using namespace std;
 using namespace rm;
 
@@ -23,6 +24,7 @@ void Pipeline::tracker_rune_thread(
     Rune3D.emplace_back(rune_height / 2, rune_width / 2, 0);
 
     cv::Mat rvec, tvec, rotate_cv;
+    std::vector<cv::Point2f> normalized_points;
     Eigen::Vector4d pose_pnp, pose_world;
     Eigen::Matrix3d rotate_pnp, rotate_world;
 
@@ -48,6 +50,7 @@ void Pipeline::tracker_rune_thread(
         lock_in.unlock();
 
         tp1 = getTime();
+        garage->applyConfig();
 
         rotate_pnp2head = Data::camera[frame->camera_id]->Rotate_pnp2head;
         rm::tf_rotate_head2world(rotate_head2world, frame->yaw, frame->pitch);
@@ -71,10 +74,18 @@ void Pipeline::tracker_rune_thread(
             }
             
             try {
-                cv::solvePnP(Rune3D, armor.four_points,
-                    Data::camera[frame->camera_id]->intrinsic_matrix,
-                    Data::camera[frame->camera_id]->distortion_coeffs,
-                    rvec, tvec, false, cv::SOLVEPNP_EPNP);
+                const UndistortMap* undistort_map = getUndistortMap(frame->camera_id);
+                if (undistort_map != nullptr) {
+                    undistort_map->lookup(armor.four_points, normalized_points);
+                    cv::solvePnP(Rune3D, normalized_points,
+                        getNormalizedIntrinsic(), getNormalizedDistortion(),
+                        rvec, tvec, false, cv::SOLVEPNP_EPNP);
+                } else {
+                    cv::solvePnP(Rune3D, armor.four_points,
+                        Data::camera[frame->camera_id]->intrinsic_matrix,
+                        Data::camera[frame->camera_id]->distortion_coeffs,
+                        rvec, tvec, false, cv::SOLVEPNP_EPNP);
+                }
             } catch (cv::Exception& e) {
                 rm::message("solvePnP error", rm::MSG_ERROR);
                 continue;
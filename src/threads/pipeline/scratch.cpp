@@ -0,0 +1,48 @@
+#include "threads/pipeline/scratch.h"
+#include <algorithm>
+
+static const size_t kArenaInitSize = 256 * 1024;
+
+void* FrameArena::Upstream::do_allocate(size_t bytes, size_t align) {
+    overflow += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+}
+
+void FrameArena::Upstream::do_deallocate(void* ptr, size_t bytes, size_t align) {
+    std::pmr::new_delete_resource()->deallocate(ptr, bytes, align);
+}
+
+bool FrameArena::Upstream::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+FrameArena::FrameArena() : buffer_(new std::byte[kArenaInitSize]), size_(kArenaInitSize) {
+    resource_ = std::make_unique<std::pmr::monotonic_buffer_resource>(buffer_.get(), size_, &upstream_);
+}
+
+FrameArena& FrameArena::local() {
+    static thread_local FrameArena arena;
+    return arena;
+}
+
+void FrameArena::reset() {
+    resource_->release();
+    if (upstream_.overflow == 0) return;
+
+    size_ = (size_ + upstream_.overflow) * 2;
+    upstream_.overflow = 0;
+    buffer_.reset(new std::byte[size_]);
+    resource_ = std::make_unique<std::pmr::monotonic_buffer_resource>(buffer_.get(), size_, &upstream_);
+}
+
+TrackerScratch& TrackerScratch::local() {
+    static thread_local TrackerScratch scratch;
+    return scratch;
+}
+
+cv::Mat getScratchMat(cv::Mat& buffer, int rows, int cols, int type) {
+    if (buffer.type() != type || buffer.rows < rows || buffer.cols < cols) {
+        buffer.create(std::max(rows, buffer.rows), std::max(cols, buffer.cols), type);
+    }
+    return buffer(cv::Rect(0, 0, cols, rows));
+}
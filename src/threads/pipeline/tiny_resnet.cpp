@@ -0,0 +1,492 @@
+#include "threads/pipeline/tiny_resnet.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <iostream>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <algorithm>
+
+// NEON (Jetson) 下为 4 路，x86 开启 AVX2 编译时为 8 路
+#if CV_SIMD
+static const int kLanes = cv::v_float32::nlanes;
+#else
+static const int kLanes = 1;
+#endif
+
+static int alignLanes(int c) {
+    return (c + kLanes - 1) / kLanes * kLanes;
+}
+
+static bool unsupported(const std::string& name, const std::string& reason) {
+    std::cout << "[TINY_RESNET] 不支持的层 " << name << ": " << reason << std::endl;
+    return false;
+}
+
+bool TinyResNet::load(const std::string& onnx_file, int infer_width, int infer_height, double scale, bool swap_rb) {
+    ready_ = false;
+    ops_.clear();
+    shapes_.clear();
+    tensors_.clear();
+
+    try {
+        net_ = cv::dnn::readNetFromONNX(onnx_file);
+    } catch (const cv::Exception& e) {
+        std::cout << "[TINY_RESNET] 无法读取 ONNX: " << e.what() << std::endl;
+        return false;
+    }
+    infer_width_ = infer_width;
+    infer_height_ = infer_height;
+    scale_ = scale;
+    swap_rb_ = swap_rb;
+
+    std::vector<cv::String> names = net_.getLayerNames();
+
+    // 统计每层的输入层与被引用次数，用于判断 BN / ReLU 能否融合进前驱
+    std::map<int, std::vector<int>> inputs;
+    std::map<int, int> consumers;
+    int input_channels = 0;
+    for (const auto& name : names) {
+        int id = net_.getLayerId(name);
+        for (const auto& in : net_.getLayerInputs(id)) {
+            int in_id = net_.getLayerId(in->name);
+            inputs[id].push_back(in_id);
+            consumers[in_id]++;
+        }
+        cv::Ptr<cv::dnn::Layer> layer = net_.getLayer(id);
+        if (input_channels == 0 && layer->type == "Convolution" && !layer->blobs.empty()) {
+            input_channels = layer->blobs[0].size[1];
+        }
+    }
+    if (input_channels != 1 && input_channels != 3) {
+        std::cout << "[TINY_RESNET] 输入通道数非法: " << input_channels << std::endl;
+        return false;
+    }
+
+    std::map<int, int> tensor_of;   // 层 id -> 张量下标
+    std::vector<int> producer;      // 张量下标 -> 产生该张量的算子下标，-1 为网络输入
+    auto new_tensor = [&](int c, int h, int w, int op) {
+        Shape shape;
+        shape.c = c; shape.h = h; shape.w = w; shape.cp = alignLanes(c);
+        shapes_.push_back(shape);
+        producer.push_back(op);
+        return (int)shapes_.size() - 1;
+    };
+    tensor_of[0] = new_tensor(input_channels, infer_height_, infer_width_, -1);
+
+    for (const auto& name : names) {
+        int id = net_.getLayerId(name);
+        cv::Ptr<cv::dnn::Layer> layer = net_.getLayer(id);
+        const std::string& type = layer->type;
+        const auto& in = inputs[id];
+        if (in.empty() || tensor_of.count(in[0]) == 0) return unsupported(name, "输入未知");
+
+        int src = tensor_of[in[0]];
+        const Shape is = shapes_[src];
+
+        if (type == "Convolution") {
+            auto conv = layer.dynamicCast<cv::dnn::ConvolutionLayer>();
+            const cv::Mat& w = layer->blobs[0];
+            if (conv.empty() || w.dims != 4 || w.size[1] != is.c) return unsupported(name, "分组卷积");
+            for (auto d : conv->dilations) if (d != 1) return unsupported(name, "空洞卷积");
+
+            Op op;
+            op.type = kConv;
+            op.src0 = src;
+            op.kh = w.size[2]; op.kw = w.size[3];
+            op.sh = (int)conv->strides[0]; op.sw = (int)conv->strides[1];
+            op.ph = (int)conv->pads_begin[0]; op.pw = (int)conv->pads_begin[1];
+            int oc = w.size[0];
+            int oh = (is.h + op.ph + (int)conv->pads_end[0] - op.kh) / op.sh + 1;
+            int ow = (is.w + op.pw + (int)conv->pads_end[1] - op.kw) / op.sw + 1;
+            op.dst = new_tensor(oc, oh, ow, (int)ops_.size());
+
+            // OIHW -> [kh][kw][ic][ocp]
+            int ocp = shapes_[op.dst].cp;
+            const float* wp = w.ptr<float>();
+            op.weight.assign((size_t)op.kh * op.kw * is.c * ocp, 0.f);
+            for (int o = 0; o < oc; o++)
+            for (int i = 0; i < is.c; i++)
+            for (int y = 0; y < op.kh; y++)
+            for (int x = 0; x < op.kw; x++) {
+                op.weight[((size_t)(y * op.kw + x) * is.c + i) * ocp + o] = wp[((o * is.c + i) * op.kh + y) * op.kw + x];
+            }
+            op.bias.assign(ocp, 0.f);
+            if (layer->blobs.size() > 1) {
+                const float* bp = layer->blobs[1].ptr<float>();
+                for (int o = 0; o < oc; o++) op.bias[o] = bp[o];
+            }
+            ops_.push_back(op);
+            tensor_of[id] = op.dst;
+
+        } else if (type == "BatchNorm") {
+            // 仅支持紧跟在卷积之后的 BN，直接折叠进卷积权重
+            auto bn = layer.dynamicCast<cv::dnn::BatchNormLayer>();
+            int op_index = producer[src];
+            if (bn.empty() || op_index < 0 || ops_[op_index].type != kConv
+                || ops_[op_index].relu || consumers[in[0]] != 1) return unsupported(name, "BN 无法折叠");
+
+            Op& op = ops_[op_index];
+            const float* mean = layer->blobs[0].ptr<float>();
+            const float* var = layer->blobs[1].ptr<float>();
+            const float* gamma = bn->hasWeights ? layer->blobs[2].ptr<float>() : nullptr;
+            const float* beta = bn->hasBias ? layer->blobs[bn->hasWeights ? 3 : 2].ptr<float>() : nullptr;
+            int ocp = is.cp;
+            for (int o = 0; o < is.c; o++) {
+                float k = (gamma ? gamma[o] : 1.f) / std::sqrt(var[o] + bn->epsilon);
+                for (size_t j = o; j < op.weight.size(); j += ocp) op.weight[j] *= k;
+                op.bias[o] = (op.bias[o] - mean[o]) * k + (beta ? beta[o] : 0.f);
+            }
+            tensor_of[id] = src;
+
+        } else if (type == "ReLU") {
+            auto relu = layer.dynamicCast<cv::dnn::ReLULayer>();
+            int op_index = producer[src];
+            if (relu.empty() || relu->negativeSlope != 0.f || op_index < 0
+                || ops_[op_index].relu || consumers[in[0]] != 1) return unsupported(name, "ReLU 无法融合");
+            ops_[op_index].relu = true;
+            tensor_of[id] = src;
+
+        } else if (type == "Pooling") {
+            auto pool = layer.dynamicCast<cv::dnn::PoolingLayer>();
+            if (pool.empty() || (pool->type != 0 && pool->type != 1)) return unsupported(name, "池化类型");
+
+            Op op;
+            op.type = (pool->type == 0) ? kMaxPool : kAvgPool;
+            op.src0 = src;
+            int oh = 1, ow = 1;
+            if (pool->globalPooling) {
+                op.kh = is.h; op.kw = is.w;
+            } else {
+                op.kh = (int)pool->kernel_size[0]; op.kw = (int)pool->kernel_size[1];
+                op.sh = (int)pool->strides[0]; op.sw = (int)pool->strides[1];
+                op.ph = (int)pool->pads_begin[0]; op.pw = (int)pool->pads_begin[1];
+                if (op.type == kAvgPool && (op.ph != 0 || op.pw != 0)) return unsupported(name, "带填充的均值池化");
+                int ceil_h = pool->ceilMode ? op.sh - 1 : 0;
+                int ceil_w = pool->ceilMode ? op.sw - 1 : 0;
+                oh = (is.h + op.ph + (int)pool->pads_end[0] - op.kh + ceil_h) / op.sh + 1;
+                ow = (is.w + op.pw + (int)pool->pads_end[1] - op.kw + ceil_w) / op.sw + 1;
+            }
+            op.dst = new_tensor(is.c, oh, ow, (int)ops_.size());
+            ops_.push_back(op);
+            tensor_of[id] = op.dst;
+
+        } else if (type == "Eltwise" || type == "NaryEltwise") {
+            // ResNet 残差相加
+            if (in.size() != 2 || tensor_of.count(in[1]) == 0) return unsupported(name, "残差输入");
+            int src1 = tensor_of[in[1]];
+            const Shape& is1 = shapes_[src1];
+            if (is1.c != is.c || is1.h != is.h || is1.w != is.w) return unsupported(name, "残差尺寸不一致");
+
+            Op op;
+            op.type = kAdd;
+            op.src0 = src;
+            op.src1 = src1;
+            op.dst = new_tensor(is.c, is.h, is.w, (int)ops_.size());
+            ops_.push_back(op);
+            tensor_of[id] = op.dst;
+
+        } else if (type == "Flatten" || type == "Reshape" || type == "Identity" || type == "Dropout") {
+            // HWC 布局下展平顺序的差异由全连接层的权重重排吸收
+            tensor_of[id] = src;
+
+        } else if (type == "InnerProduct") {
+            const cv::Mat& w = layer->blobs[0];
+            int oc = w.size[0];
+            if ((int)(w.total() / oc) != is.c * is.h * is.w) return unsupported(name, "全连接输入尺寸");
+
+            Op op;
+            op.type = kDense;
+            op.src0 = src;
+            op.dst = new_tensor(oc, 1, 1, (int)ops_.size());
+
+            // 权重按 CHW 展平，重排为 [h][w][ic][ocp]
+            int ocp = shapes_[op.dst].cp;
+            const float* wp = w.ptr<float>();
+            int hw = is.h * is.w;
+            op.weight.assign((size_t)hw * is.c * ocp, 0.f);
+            for (int o = 0; o < oc; o++)
+            for (int i = 0; i < is.c; i++)
+            for (int p = 0; p < hw; p++) {
+                op.weight[((size_t)p * is.c + i) * ocp + o] = wp[(size_t)o * is.c * hw + i * hw + p];
+            }
+            op.bias.assign(ocp, 0.f);
+            if (layer->blobs.size() > 1) {
+                const float* bp = layer->blobs[1].ptr<float>();
+                for (int o = 0; o < oc; o++) op.bias[o] = bp[o];
+            }
+            ops_.push_back(op);
+            tensor_of[id] = op.dst;
+
+        } else if (type == "Softmax") {
+            if (is.h != 1 || is.w != 1) return unsupported(name, "Softmax 维度");
+            Op op;
+            op.type = kSoftmax;
+            op.src0 = src;
+            op.dst = new_tensor(is.c, 1, 1, (int)ops_.size());
+            ops_.push_back(op);
+            tensor_of[id] = op.dst;
+
+        } else {
+            return unsupported(name, type);
+        }
+    }
+
+    output_tensor_ = tensor_of[net_.getLayerId(names.back())];
+    const Shape& out = shapes_[output_tensor_];
+    if (ops_.empty() || out.h != 1 || out.w != 1) {
+        std::cout << "[TINY_RESNET] 网络输出维度非法" << std::endl;
+        return false;
+    }
+    class_num_ = out.c;
+
+    tensors_.resize(shapes_.size());
+    for (size_t i = 0; i < shapes_.size(); i++) tensors_[i].assign(shapes_[i].size(), 0.f);
+
+    ready_ = true;
+    return true;
+}
+
+double TinyResNet::parity(
+    const std::vector<cv::Mat>& patches,
+    const std::function<void(const cv::Mat&, float*)>& reference
+) {
+    if (!ready_ || patches.empty()) return std::numeric_limits<double>::infinity();
+
+    double max_diff = 0.0;
+    int mismatch = 0;
+    std::vector<float> output(class_num_), ref(class_num_);
+    for (const auto& patch : patches) {
+        forward(patch, output.data());
+        reference(patch, ref.data());
+
+        int ref_class = 0, out_class = 0;
+        for (int i = 0; i < class_num_; i++) {
+            max_diff = std::max(max_diff, (double)std::fabs(ref[i] - output[i]));
+            if (ref[i] > ref[ref_class]) ref_class = i;
+            if (output[i] > output[out_class]) out_class = i;
+        }
+        if (ref_class != out_class) mismatch++;
+    }
+    std::cout << "[TINY_RESNET] 一致性校验: " << patches.size() << " 组样本, 最大误差 " << max_diff
+              << ", 类别不一致 " << mismatch << " 组" << std::endl;
+    return (mismatch > 0) ? std::numeric_limits<double>::infinity() : max_diff;
+}
+
+void TinyResNet::benchmark(int iterations) {
+    if (!ready_ || iterations <= 0) return;
+
+    std::vector<float> output(class_num_);
+    cv::Mat image(infer_height_, infer_width_, CV_8UC3);
+    cv::randu(image, 0, 256);
+
+    cv::TickMeter native_meter;
+    for (int n = 0; n < iterations; n++) {
+        native_meter.start();
+        forward(image, output.data());
+        native_meter.stop();
+    }
+
+    cv::TickMeter reference_meter;
+    cv::Mat reference_input = image;
+    if (shapes_[0].c == 1) cv::cvtColor(image, reference_input, cv::COLOR_BGR2GRAY);
+    for (int n = 0; n < iterations; n++) {
+        reference_meter.start();
+        cv::Mat blob = cv::dnn::blobFromImage(
+            reference_input, scale_, cv::Size(infer_width_, infer_height_), cv::Scalar(), swap_rb_, false);
+        net_.setInput(blob);
+        net_.forward();
+        reference_meter.stop();
+    }
+
+    std::cout << "[TINY_RESNET] 单 ROI 耗时 (" << iterations << " 次平均): native "
+              << native_meter.getTimeMilli() / iterations << " ms, cv::dnn "
+              << reference_meter.getTimeMilli() / iterations << " ms" << std::endl;
+}
+
+void TinyResNet::forward(const cv::Mat& roi, float* output) {
+    setInput(roi);
+    for (const auto& op : ops_) {
+        switch (op.type) {
+            case kConv:    runConv(op);    break;
+            case kMaxPool:
+            case kAvgPool: runPool(op);    break;
+            case kAdd:     runAdd(op);     break;
+            case kDense:   runDense(op);   break;
+            case kSoftmax: runSoftmax(op); break;
+        }
+    }
+    std::copy(tensors_[output_tensor_].begin(), tensors_[output_tensor_].begin() + class_num_, output);
+}
+
+void TinyResNet::setInput(const cv::Mat& roi) {
+    const Shape& s = shapes_[0];
+    float* dst = tensors_[0].data();
+    float scale = (float)scale_;
+
+    if (s.c == 1) {
+        cv::cvtColor(roi, input_, cv::COLOR_BGR2GRAY);
+        for (int y = 0; y < s.h; y++) {
+            const uint8_t* p = input_.ptr<uint8_t>(y);
+            for (int x = 0; x < s.w; x++) dst[((size_t)y * s.w + x) * s.cp] = p[x] * scale;
+        }
+        return;
+    }
+
+    int r = swap_rb_ ? 2 : 0;
+    int b = swap_rb_ ? 0 : 2;
+    for (int y = 0; y < s.h; y++) {
+        const uint8_t* p = roi.ptr<uint8_t>(y);
+        for (int x = 0; x < s.w; x++, p += 3) {
+            float* d = dst + ((size_t)y * s.w + x) * s.cp;
+            d[0] = p[r] * scale;
+            d[1] = p[1] * scale;
+            d[2] = p[b] * scale;
+        }
+    }
+}
+
+void TinyResNet::runConv(const Op& op) {
+    const Shape& is = shapes_[op.src0];
+    const Shape& os = shapes_[op.dst];
+    const float* in = tensors_[op.src0].data();
+    float* out = tensors_[op.dst].data();
+
+    for (int oy = 0; oy < os.h; oy++)
+    for (int ox = 0; ox < os.w; ox++) {
+        float* o = out + ((size_t)oy * os.w + ox) * os.cp;
+        int iy0 = oy * op.sh - op.ph;
+        int ix0 = ox * op.sw - op.pw;
+        int ky0 = std::max(0, -iy0), ky1 = std::min(op.kh, is.h - iy0);
+        int kx0 = std::max(0, -ix0), kx1 = std::min(op.kw, is.w - ix0);
+
+        for (int oc = 0; oc < os.cp; oc += kLanes) {
+#if CV_SIMD
+            cv::v_float32 acc = cv::vx_load(op.bias.data() + oc);
+            for (int ky = ky0; ky < ky1; ky++)
+            for (int kx = kx0; kx < kx1; kx++) {
+                const float* ip = in + ((size_t)(iy0 + ky) * is.w + ix0 + kx) * is.cp;
+                const float* wp = op.weight.data() + (size_t)(ky * op.kw + kx) * is.c * os.cp + oc;
+                for (int ic = 0; ic < is.c; ic++, wp += os.cp) {
+                    acc = cv::v_fma(cv::vx_setall_f32(ip[ic]), cv::vx_load(wp), acc);
+                }
+            }
+            if (op.relu) acc = cv::v_max(acc, cv::vx_setzero_f32());
+            cv::v_store(o + oc, acc);
+#else
+            float acc = op.bias[oc];
+            for (int ky = ky0; ky < ky1; ky++)
+            for (int kx = kx0; kx < kx1; kx++) {
+                const float* ip = in + ((size_t)(iy0 + ky) * is.w + ix0 + kx) * is.cp;
+                const float* wp = op.weight.data() + (size_t)(ky * op.kw + kx) * is.c * os.cp + oc;
+                for (int ic = 0; ic < is.c; ic++, wp += os.cp) acc += ip[ic] * (*wp);
+            }
+            o[oc] = op.relu ? std::max(acc, 0.f) : acc;
+#endif
+        }
+    }
+}
+
+void TinyResNet::runPool(const Op& op) {
+    const Shape& is = shapes_[op.src0];
+    const Shape& os = shapes_[op.dst];
+    const float* in = tensors_[op.src0].data();
+    float* out = tensors_[op.dst].data();
+    bool is_max = (op.type == kMaxPool);
+
+    for (int oy = 0; oy < os.h; oy++)
+    for (int ox = 0; ox < os.w; ox++) {
+        float* o = out + ((size_t)oy * os.w + ox) * os.cp;
+        int iy0 = oy * op.sh - op.ph;
+        int ix0 = ox * op.sw - op.pw;
+        int ky0 = std::max(0, -iy0), ky1 = std::min(op.kh, is.h - iy0);
+        int kx0 = std::max(0, -ix0), kx1 = std::min(op.kw, is.w - ix0);
+        // ceil 模式下末尾窗口越出输入，均值池化只按落在输入内的单元计数
+        float area = 1.f / std::max(1, (ky1 - ky0) * (kx1 - kx0));
+
+        for (int c = 0; c < os.cp; c += kLanes) {
+#if CV_SIMD
+            cv::v_float32 acc = is_max ? cv::vx_setall_f32(-std::numeric_limits<float>::max()) : cv::vx_setzero_f32();
+            for (int ky = ky0; ky < ky1; ky++)
+            for (int kx = kx0; kx < kx1; kx++) {
+                cv::v_float32 v = cv::vx_load(in + ((size_t)(iy0 + ky) * is.w + ix0 + kx) * is.cp + c);
+                acc = is_max ? cv::v_max(acc, v) : acc + v;
+            }
+            if (!is_max) acc = acc * cv::vx_setall_f32(area);
+            if (op.relu) acc = cv::v_max(acc, cv::vx_setzero_f32());
+            cv::v_store(o + c, acc);
+#else
+            float acc = is_max ? -std::numeric_limits<float>::max() : 0.f;
+            for (int ky = ky0; ky < ky1; ky++)
+            for (int kx = kx0; kx < kx1; kx++) {
+                float v = in[((size_t)(iy0 + ky) * is.w + ix0 + kx) * is.cp + c];
+                acc = is_max ? std::max(acc, v) : acc + v;
+            }
+            if (!is_max) acc *= area;
+            o[c] = op.relu ? std::max(acc, 0.f) : acc;
+#endif
+        }
+    }
+}
+
+void TinyResNet::runAdd(const Op& op) {
+    const float* a = tensors_[op.src0].data();
+    const float* b = tensors_[op.src1].data();
+    float* out = tensors_[op.dst].data();
+    size_t size = shapes_[op.dst].size();
+
+    for (size_t i = 0; i < size; i += kLanes) {
+#if CV_SIMD
+        cv::v_float32 v = cv::vx_load(a + i) + cv::vx_load(b + i);
+        if (op.relu) v = cv::v_max(v, cv::vx_setzero_f32());
+        cv::v_store(out + i, v);
+#else
+        float v = a[i] + b[i];
+        out[i] = op.relu ? std::max(v, 0.f) : v;
+#endif
+    }
+}
+
+void TinyResNet::runDense(const Op& op) {
+    const Shape& is = shapes_[op.src0];
+    const Shape& os = shapes_[op.dst];
+    const float* in = tensors_[op.src0].data();
+    float* out = tensors_[op.dst].data();
+    int hw = is.h * is.w;
+
+    for (int oc = 0; oc < os.cp; oc += kLanes) {
+#if CV_SIMD
+        cv::v_float32 acc = cv::vx_load(op.bias.data() + oc);
+        const float* wp = op.weight.data() + oc;
+        for (int p = 0; p < hw; p++) {
+            const float* ip = in + (size_t)p * is.cp;
+            for (int ic = 0; ic < is.c; ic++, wp += os.cp) {
+                acc = cv::v_fma(cv::vx_setall_f32(ip[ic]), cv::vx_load(wp), acc);
+            }
+        }
+        if (op.relu) acc = cv::v_max(acc, cv::vx_setzero_f32());
+        cv::v_store(out + oc, acc);
+#else
+        float acc = op.bias[oc];
+        const float* wp = op.weight.data() + oc;
+        for (int p = 0; p < hw; p++) {
+            const float* ip = in + (size_t)p * is.cp;
+            for (int ic = 0; ic < is.c; ic++, wp += os.cp) acc += ip[ic] * (*wp);
+        }
+        out[oc] = op.relu ? std::max(acc, 0.f) : acc;
+#endif
+    }
+}
+
+void TinyResNet::runSoftmax(const Op& op) {
+    const float* in = tensors_[op.src0].data();
+    float* out = tensors_[op.dst].data();
+    int c = shapes_[op.dst].c;
+
+    float max_value = *std::max_element(in, in + c);
+    float sum = 0.f;
+    for (int i = 0; i < c; i++) {
+        out[i] = std::exp(in[i] - max_value);
+        sum += out[i];
+    }
+    for (int i = 0; i < c; i++) out[i] /= sum;
+}
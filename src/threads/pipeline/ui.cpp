@@ -50,6 +50,30 @@ static bool UI_CheckYaw(std::shared_ptr<rm::Frame> frame) {
     return true;
 }
 
+// 在画面左上角依次贴出各检测框的分类器输入与二值平面，直接取自 ROI 缓存，不重新裁剪
+static void UI_RoiPatches(std::shared_ptr<rm::Frame> frame, const FrameRois* rois) {
+    if (rois == nullptr) return;
+    cv::Mat& image = *(frame->image);
+    int x = 4;
+    for (size_t i = 0; i < rois->size(); i++) {
+        const DetectionRoi& detection = (*rois)[i];
+        const RoiPlanes* planes = detection.lastPlanes();
+        if (detection.hasPatch() && !detection.cachedPatch().empty()) {
+            const cv::Mat& patch = detection.cachedPatch();
+            if (x + patch.cols > image.cols || 4 + patch.rows > image.rows) break;
+            cv::Mat patch_area = image(cv::Rect(x, 4, patch.cols, patch.rows));
+            patch.copyTo(patch_area);
+            if (planes != nullptr && 8 + 2 * patch.rows <= image.rows) {
+                cv::Mat binary;
+                cv::resize(planes->binary, binary, patch.size(), 0, 0, cv::INTER_NEAREST);
+                cv::Mat binary_area = image(cv::Rect(x, 8 + patch.rows, patch.cols, patch.rows));
+                cv::cvtColor(binary, binary_area, cv::COLOR_GRAY2BGR);
+            }
+            x += patch.cols + 4;
+        }
+    }
+}
+
 bool Pipeline::UI(std::shared_ptr<rm::Frame> frame) {
     auto garage = Garage::get_instance();
 
@@ -58,6 +82,7 @@ bool Pipeline::UI(std::shared_ptr<rm::Frame> frame) {
     rm::tf_trans_head2world(trans_head2world, frame->yaw, frame->pitch, frame->roll);
 
     
+    UI_RoiPatches(frame, roi_cache_.find(*frame));
     if (!UI_TargetX(frame)) return false;
     if (!UI_CheckYaw(frame)) return false;
     return true;
@@ -0,0 +1,334 @@
+#include "threads/pipeline/yaw_pnp.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#if CV_SIMD
+static const int kLanes = cv::v_float32::nlanes;
+#else
+static const int kLanes = 4;
+#endif
+// 每轮评估的候选数，区间每轮收缩为 2 / (kCandidates + 1)
+static const int kCandidates = 2 * kLanes;
+
+static double wrapAngle(double angle) {
+    while (angle > M_PI) angle -= 2 * M_PI;
+    while (angle < -M_PI) angle += 2 * M_PI;
+    return angle;
+}
+
+// p_i(yaw) = cos * pc[i] + sin * ps[i] + p0[i]，为相机系下第 i 个模型点
+struct YawModel {
+    Eigen::Vector3d pc[4], ps[4], p0[4];
+    Eigen::Vector3d tc, ts, t0;
+    Eigen::Matrix3d base;           // 偏航为 0 时的世界系姿态
+    Eigen::Matrix3d world2pnp;
+    float x[4], y[4];
+};
+
+static Eigen::Matrix3d rotateZ(double yaw) {
+    Eigen::Matrix3d rz;
+    rz << std::cos(yaw), -std::sin(yaw), 0,
+          std::sin(yaw),  std::cos(yaw), 0,
+          0,              0,             1;
+    return rz;
+}
+
+// 固定旋转下平移的线性最小二乘对旋转后的模型点是线性的，分别对 cos / sin / 常数项求解
+static void buildYawModel(
+    YawModel& model,
+    const std::vector<cv::Point3f>& object,
+    const std::vector<cv::Point2f>& normalized,
+    const Eigen::Matrix3d& rotate_pnp2world,
+    double armor_pitch
+) {
+    // 偏航为 0 时外法线指向世界系 +x 并仰起 armor_pitch，模型 z 轴 (背向观察者) 与之相反，x 轴水平
+    double theta = armor_pitch * M_PI / 180.0;
+    Eigen::Vector3d z_axis(-std::cos(theta), 0, -std::sin(theta));
+    Eigen::Vector3d x_axis(0, 1, 0);
+    Eigen::Vector3d y_axis = z_axis.cross(x_axis);
+    model.base << x_axis, y_axis, z_axis;
+    model.world2pnp = rotate_pnp2world.transpose();
+
+    Eigen::Matrix3d ata = Eigen::Matrix3d::Zero();
+    Eigen::Matrix3d atb = Eigen::Matrix3d::Zero();      // 三列分别对应 cos / sin / 常数项
+    for (int i = 0; i < 4; i++) {
+        Eigen::Vector3d v = model.base * Eigen::Vector3d(object[i].x, object[i].y, object[i].z);
+        model.pc[i] = model.world2pnp * Eigen::Vector3d(v.x(), v.y(), 0);
+        model.ps[i] = model.world2pnp * Eigen::Vector3d(-v.y(), v.x(), 0);
+        model.p0[i] = model.world2pnp * Eigen::Vector3d(0, 0, v.z());
+        model.x[i] = normalized[i].x;
+        model.y[i] = normalized[i].y;
+
+        double x = normalized[i].x, y = normalized[i].y;
+        Eigen::Vector3d row_x(1, 0, -x), row_y(0, 1, -y);
+        ata += row_x * row_x.transpose() + row_y * row_y.transpose();
+        const Eigen::Vector3d* terms[3] = {&model.pc[i], &model.ps[i], &model.p0[i]};
+        for (int k = 0; k < 3; k++) {
+            const Eigen::Vector3d& rp = *terms[k];
+            atb.col(k) += row_x * (x * rp.z() - rp.x()) + row_y * (y * rp.z() - rp.y());
+        }
+    }
+    Eigen::Matrix3d t = ata.ldlt().solve(atb);
+    model.tc = t.col(0);
+    model.ts = t.col(1);
+    model.t0 = t.col(2);
+    for (int i = 0; i < 4; i++) {
+        model.pc[i] += model.tc;
+        model.ps[i] += model.ts;
+        model.p0[i] += model.t0;
+    }
+}
+
+static double getYawCost(const YawModel& model, double yaw) {
+    double c = std::cos(yaw), s = std::sin(yaw);
+    double cost = 0.0;
+    for (int i = 0; i < 4; i++) {
+        Eigen::Vector3d p = c * model.pc[i] + s * model.ps[i] + model.p0[i];
+        if (p.z() <= 1e-6) return 1e9;
+        double du = p.x() / p.z() - model.x[i];
+        double dv = p.y() / p.z() - model.y[i];
+        cost += du * du + dv * dv;
+    }
+    return cost;
+}
+
+// 同时评估 kCandidates 个偏航的重投影代价
+static void getYawCosts(const YawModel& model, const double* yaws, float* costs) {
+    float c[kCandidates], s[kCandidates];
+    for (int k = 0; k < kCandidates; k++) {
+        c[k] = std::cos(yaws[k]);
+        s[k] = std::sin(yaws[k]);
+    }
+#if CV_SIMD
+    for (int k = 0; k < kCandidates; k += kLanes) {
+        cv::v_float32 vc = cv::vx_load(c + k), vs = cv::vx_load(s + k);
+        cv::v_float32 cost = cv::vx_setzero_f32();
+        cv::v_float32 invalid = cv::vx_setzero_f32();
+        for (int i = 0; i < 4; i++) {
+            const Eigen::Vector3d& pc = model.pc[i];
+            const Eigen::Vector3d& ps = model.ps[i];
+            const Eigen::Vector3d& p0 = model.p0[i];
+            cv::v_float32 px = cv::v_fma(vc, cv::vx_setall_f32(pc.x()), cv::v_fma(vs, cv::vx_setall_f32(ps.x()), cv::vx_setall_f32(p0.x())));
+            cv::v_float32 py = cv::v_fma(vc, cv::vx_setall_f32(pc.y()), cv::v_fma(vs, cv::vx_setall_f32(ps.y()), cv::vx_setall_f32(p0.y())));
+            cv::v_float32 pz = cv::v_fma(vc, cv::vx_setall_f32(pc.z()), cv::v_fma(vs, cv::vx_setall_f32(ps.z()), cv::vx_setall_f32(p0.z())));
+            invalid = invalid | (pz <= cv::vx_setall_f32(1e-6f));
+            cv::v_float32 du = px / pz - cv::vx_setall_f32(model.x[i]);
+            cv::v_float32 dv = py / pz - cv::vx_setall_f32(model.y[i]);
+            cost = cv::v_fma(du, du, cv::v_fma(dv, dv, cost));
+        }
+        cv::v_store(costs + k, cv::v_select(invalid, cv::vx_setall_f32(1e9f), cost));
+    }
+#else
+    for (int k = 0; k < kCandidates; k++) {
+        float cost = 0.f;
+        for (int i = 0; i < 4; i++) {
+            float px = c[k] * model.pc[i].x() + s[k] * model.ps[i].x() + model.p0[i].x();
+            float py = c[k] * model.pc[i].y() + s[k] * model.ps[i].y() + model.p0[i].y();
+            float pz = c[k] * model.pc[i].z() + s[k] * model.ps[i].z() + model.p0[i].z();
+            if (pz <= 1e-6f) { cost = 1e9f; break; }
+            float du = px / pz - model.x[i], dv = py / pz - model.y[i];
+            cost += du * du + dv * dv;
+        }
+        costs[k] = cost;
+    }
+#endif
+}
+
+// 在 [lo, hi] 内取 kCandidates 个等距内点，区间收缩到最优候选的两个相邻点之间
+// 返回最优解是否落在初始区间的端点格上
+static bool searchBracket(const YawModel& model, double lo, double hi, const YawSearchParam& param,
+                          double& best_yaw, double& best_cost, int& iterations) {
+    double tolerance = param.tolerance * M_PI / 180.0;
+    double yaws[kCandidates];
+    float costs[kCandidates];
+    double h = 0.0;
+    bool edge = false;
+    best_cost = 1e9;
+
+    for (int iter = 0; iter < param.max_iterations && hi - lo > tolerance; iter++) {
+        h = (hi - lo) / (kCandidates + 1);
+        for (int k = 0; k < kCandidates; k++) yaws[k] = lo + (k + 1) * h;
+        getYawCosts(model, yaws, costs);
+        int best = std::min_element(costs, costs + kCandidates) - costs;
+        if (iter == 0) edge = (best == 0 || best == kCandidates - 1);
+
+        best_yaw = yaws[best];
+        best_cost = costs[best];
+        lo = best_yaw - h;
+        hi = best_yaw + h;
+        iterations++;
+    }
+    if (h <= 0) return edge;
+
+    // 以最后一轮的三点拟合抛物线，顶点在 ±h 内且代价更低时采用
+    double f0 = getYawCost(model, best_yaw);
+    double fm = getYawCost(model, best_yaw - h);
+    double fp = getYawCost(model, best_yaw + h);
+    double denom = fm - 2 * f0 + fp;
+    best_cost = f0;
+    if (denom > 0) {
+        double delta = std::clamp(0.5 * h * (fm - fp) / denom, -h, h);
+        double f = getYawCost(model, best_yaw + delta);
+        if (f < f0) {
+            best_yaw += delta;
+            best_cost = f;
+        }
+    }
+    return edge;
+}
+
+YawPose searchArmorYaw(
+    const std::vector<cv::Point3f>& object,
+    const std::vector<cv::Point2f>& normalized,
+    const Eigen::Matrix3d& rotate_pnp2world,
+    const YawSearchParam& param,
+    const double* warm_yaw
+) {
+    YawPose pose;
+    if (object.size() != 4 || normalized.size() != 4) return pose;
+
+    YawModel model;
+    buildYawModel(model, object, normalized, rotate_pnp2world, param.armor_pitch);
+
+    // 搜索变量为外法线方位角，与 tf_rotation2armoryaw 的偏航只差一个常数
+    double yaw_offset = rm::tf_rotation2armoryaw(model.base);
+
+    double best_yaw = 0.0, best_cost = 1e9;
+    bool found = false;
+    if (warm_yaw != nullptr) {
+        double center = wrapAngle(*warm_yaw - yaw_offset);
+        double window = param.warm_window * M_PI / 180.0;
+        bool edge = searchBracket(model, center - window, center + window, param, best_yaw, best_cost, pose.iterations);
+        found = !edge && best_cost < 1e9;
+        pose.warm = found;
+    }
+    if (!found) {
+        // 可见装甲板的外法线方位在视线反方向 ±90° 内
+        Eigen::Vector3d ray(0, 0, 0);
+        for (const auto& point : normalized) ray += Eigen::Vector3d(point.x, point.y, 1.0);
+        Eigen::Vector3d dir = rotate_pnp2world * ray;
+        double facing = std::atan2(-dir.y(), -dir.x());
+        searchBracket(model, facing - M_PI / 2, facing + M_PI / 2, param, best_yaw, best_cost, pose.iterations);
+    }
+    if (!(best_cost < 1e9)) return pose;
+
+    double c = std::cos(best_yaw), s = std::sin(best_yaw);
+    Eigen::Matrix3d rotate_world = rotateZ(best_yaw) * model.base;
+    pose.rotation = model.world2pnp * rotate_world;
+    pose.translation = c * model.tc + s * model.ts + model.t0;
+    pose.armor_yaw = rm::tf_rotation2armoryaw(rotate_world);
+    pose.error = best_cost;
+    pose.valid = pose.translation.allFinite();
+    return pose;
+}
+
+struct YawSample {
+    std::vector<cv::Point2f> image, normalized;
+    double yaw;
+};
+
+// 随机位姿: 距离 1 ~ 8 m，外法线偏离视线 ±60°，像点加 0.3 像素噪声
+static void makeYawSamples(rm::Camera* camera, const std::vector<cv::Point3f>& object, const YawSearchParam& param,
+                           const Eigen::Matrix3d& rotate_pnp2world, std::vector<YawSample>& samples) {
+    cv::RNG rng(0x5eed);
+    YawModel reference;
+    std::vector<cv::Point2f> dummy(4);
+    buildYawModel(reference, object, dummy, rotate_pnp2world, param.armor_pitch);
+    samples.clear();
+    for (int i = 0; i < 64; i++) {
+        Eigen::Vector3d position(rng.uniform(-400.0, 400.0), rng.uniform(-200.0, 200.0), rng.uniform(1000.0, 8000.0));
+        Eigen::Vector3d dir = rotate_pnp2world * position;
+        double yaw = std::atan2(-dir.y(), -dir.x()) + rng.uniform(-1.0, 1.0);
+        Eigen::Matrix3d rotate_pnp = reference.world2pnp * rotateZ(yaw) * reference.base;
+
+        YawSample sample;
+        for (const auto& p : object) {
+            Eigen::Vector3d q = rotate_pnp * Eigen::Vector3d(p.x, p.y, p.z) + position;
+            sample.normalized.emplace_back(q.x() / q.z(), q.y() / q.z());
+        }
+        std::vector<cv::Point3f> rays;
+        for (const auto& p : sample.normalized) rays.emplace_back(p.x, p.y, 1.0f);
+        cv::projectPoints(rays, cv::Mat::zeros(3, 1, CV_64F), cv::Mat::zeros(3, 1, CV_64F),
+                          camera->intrinsic_matrix, camera->distortion_coeffs, sample.image);
+        for (auto& point : sample.image) point += cv::Point2f(rng.gaussian(0.3), rng.gaussian(0.3));
+        cv::undistortPoints(sample.image, sample.normalized, camera->intrinsic_matrix, camera->distortion_coeffs);
+        sample.yaw = rm::tf_rotation2armoryaw(rotateZ(yaw) * reference.base);
+        samples.push_back(sample);
+    }
+}
+
+bool checkYawPnP(rm::Camera* camera, const std::vector<cv::Point3f>& object, const YawSearchParam& param, double& max_diff) {
+    max_diff = 0.0;
+    if (camera == nullptr || camera->intrinsic_matrix.empty()) return false;
+
+    Eigen::Matrix3d rotate_head2world;
+    Eigen::Matrix4d trans_head2world;
+    rm::tf_rotate_head2world(rotate_head2world, 0.0, 0.0, 0.0);
+    rm::tf_trans_head2world(trans_head2world, 0.0, 0.0, 0.0);
+    Eigen::Matrix3d rotate_pnp2world = rotate_head2world * camera->Rotate_pnp2head;
+
+    std::vector<YawSample> samples;
+    makeYawSamples(camera, object, param, rotate_pnp2world, samples);
+    for (const auto& sample : samples) {
+        YawPose cold = searchArmorYaw(object, sample.normalized, rotate_pnp2world, param, nullptr);
+        if (!cold.valid) return false;
+
+        Eigen::Vector4d pose_world;
+        double yaw_openrm = rm::solveYawPnP(0.0, camera, pose_world, object, sample.image,
+                                            rotate_head2world, trans_head2world, rm::ARMOR_ID_INFANTRY_3, false);
+        max_diff = std::max(max_diff, std::fabs(wrapAngle(cold.armor_yaw - yaw_openrm)) * 180.0 / M_PI);
+    }
+    return true;
+}
+
+void benchmarkYawPnP(rm::Camera* camera, const std::vector<cv::Point3f>& object, const YawSearchParam& param, int iterations) {
+    if (camera == nullptr || camera->intrinsic_matrix.empty()) return;
+
+    Eigen::Matrix3d rotate_head2world;
+    Eigen::Matrix4d trans_head2world;
+    rm::tf_rotate_head2world(rotate_head2world, 0.0, 0.0, 0.0);
+    rm::tf_trans_head2world(trans_head2world, 0.0, 0.0, 0.0);
+    Eigen::Matrix3d rotate_pnp2world = rotate_head2world * camera->Rotate_pnp2head;
+
+    std::vector<YawSample> samples;
+    makeYawSamples(camera, object, param, rotate_pnp2world, samples);
+
+    cv::TickMeter cold_meter, warm_meter, openrm_meter;
+    int cold_iterations = 0, warm_iterations = 0;
+    double max_cold = 0.0, max_openrm = 0.0;
+    for (int i = 0; i < iterations; i++) {
+        for (const auto& sample : samples) {
+            cold_meter.start();
+            YawPose cold = searchArmorYaw(object, sample.normalized, rotate_pnp2world, param, nullptr);
+            cold_meter.stop();
+
+            // 热启动量为真值附近 2° 内的上一帧偏航
+            double warm_yaw = sample.yaw + 0.03;
+            warm_meter.start();
+            YawPose warm = searchArmorYaw(object, sample.normalized, rotate_pnp2world, param, &warm_yaw);
+            warm_meter.stop();
+
+            Eigen::Vector4d pose_world;
+            openrm_meter.start();
+            double yaw_openrm = rm::solveYawPnP(0.0, camera, pose_world, object, sample.image,
+                                                rotate_head2world, trans_head2world, rm::ARMOR_ID_INFANTRY_3, false);
+            openrm_meter.stop();
+
+            if (i == 0) {
+                cold_iterations += cold.iterations;
+                warm_iterations += warm.iterations;
+                max_cold = std::max(max_cold, std::fabs(wrapAngle(cold.armor_yaw - sample.yaw)));
+                max_openrm = std::max(max_openrm, std::fabs(wrapAngle(cold.armor_yaw - yaw_openrm)));
+            }
+        }
+    }
+
+    int count = iterations * samples.size();
+    std::cout << "[YAW-PNP] 单块装甲板 (" << count << " 次平均): cold "
+              << cold_meter.getTimeMicro() / count << " us / " << (double)cold_iterations / samples.size()
+              << " 轮, warm " << warm_meter.getTimeMicro() / count << " us / " << (double)warm_iterations / samples.size()
+              << " 轮, openrm " << openrm_meter.getTimeMicro() / count << " us, 偏航偏差 真值 "
+              << max_cold * 180.0 / M_PI << " deg / openrm " << max_openrm * 180.0 / M_PI << " deg" << std::endl;
+}
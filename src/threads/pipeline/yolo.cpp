@@ -0,0 +1,304 @@
+#include "threads/pipeline/yolo.h"
+#include "data_manager/param.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+YoloConfig getYoloConfig(const std::string& yolo_type) {
+    auto param = Param::get_instance();
+    YoloConfig config;
+    config.type              = yolo_type;
+    config.onnx_file         = (*param)["Model"]["YoloArmor"][yolo_type]["DirONNX"];
+    config.engine_file       = (*param)["Model"]["YoloArmor"][yolo_type]["DirEngine"];
+    config.infer_width       = (*param)["Model"]["YoloArmor"][yolo_type]["InferWidth"];
+    config.infer_height      = (*param)["Model"]["YoloArmor"][yolo_type]["InferHeight"];
+    config.class_num         = (*param)["Model"]["YoloArmor"][yolo_type]["ClassNum"];
+    config.bboxes_num        = (*param)["Model"]["YoloArmor"][yolo_type]["BboxesNum"];
+    config.confidence_thresh = (*param)["Model"]["YoloArmor"][yolo_type]["ConfThresh"];
+    config.nms_thresh        = (*param)["Model"]["YoloArmor"][yolo_type]["NMSThresh"];
+
+    int locate_num = (*param)["Model"]["YoloArmor"][yolo_type]["LocateNum"];
+    int color_num  = (*param)["Model"]["YoloArmor"][yolo_type]["ColorNum"];
+    config.yolo_struct_size = sizeof(float) * static_cast<size_t>(locate_num + 1 + color_num + config.class_num);
+    return config;
+}
+
+bool yoloArmorNMS(
+    const std::string& yolo_type,
+    std::vector<rm::YoloRect>& yolo_list,
+    float* output_host_buffer,
+    int bboxes_num,
+    int class_num,
+    double confidence_thresh,
+    double nms_thresh,
+    int width,
+    int height,
+    int infer_width,
+    int infer_height
+) {
+    if (yolo_type == "V5") {
+        yolo_list = rm::yoloArmorNMS_V5(
+            output_host_buffer, bboxes_num, class_num, confidence_thresh, nms_thresh,
+            width, height, infer_width, infer_height);
+    } else if (yolo_type == "FP") {
+        yolo_list = rm::yoloArmorNMS_FP(
+            output_host_buffer, bboxes_num, class_num, confidence_thresh, nms_thresh,
+            width, height, infer_width, infer_height);
+    } else if (yolo_type == "FPX") {
+        yolo_list = rm::yoloArmorNMS_FPX(
+            output_host_buffer, bboxes_num, class_num, confidence_thresh, nms_thresh,
+            width, height, infer_width, infer_height);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 单方向上的切片起点，首尾切片贴边，中间切片均匀分布
+static std::vector<int> getTileStarts(int length, int tile_length, double overlap) {
+    std::vector<int> starts;
+    if (length <= tile_length) {
+        starts.push_back(0);
+        return starts;
+    }
+
+    int stride = std::max(1, static_cast<int>(tile_length * (1.0 - overlap)));
+    int num = (length - tile_length + stride - 1) / stride + 1;
+    for (int i = 0; i < num; i++) {
+        starts.push_back((length - tile_length) * i / (num - 1));
+    }
+    return starts;
+}
+
+std::vector<cv::Rect> getYoloTiles(int width, int height, int tile_width, int tile_height, double overlap) {
+    std::vector<cv::Rect> tiles;
+    overlap = std::clamp(overlap, 0.0, 0.9);
+
+    std::vector<int> xs = getTileStarts(width, tile_width, overlap);
+    std::vector<int> ys = getTileStarts(height, tile_height, overlap);
+
+    for (int y : ys) {
+        for (int x : xs) {
+            tiles.emplace_back(x, y, std::min(tile_width, width - x), std::min(tile_height, height - y));
+        }
+    }
+    return tiles;
+}
+
+void offsetYoloRect(rm::YoloRect& yolo_rect, const cv::Point& offset) {
+    yolo_rect.box.x += offset.x;
+    yolo_rect.box.y += offset.y;
+    for (auto& point : yolo_rect.four_points) {
+        point.x += offset.x;
+        point.y += offset.y;
+    }
+}
+
+void mergeYoloRects(std::vector<rm::YoloRect>& yolo_list, double merge_thresh) {
+    std::sort(yolo_list.begin(), yolo_list.end(),
+        [](const rm::YoloRect& a, const rm::YoloRect& b) { return a.confidence > b.confidence; });
+
+    // 切片边缘处的装甲板会被截断，用交集与较小框面积之比判断重复
+    std::vector<rm::YoloRect> merged;
+    for (const auto& yolo_rect : yolo_list) {
+        bool duplicate = false;
+        for (const auto& kept : merged) {
+            if (kept.class_id != yolo_rect.class_id) continue;
+            double inter = (kept.box & yolo_rect.box).area();
+            double min_area = std::min(kept.box.area(), yolo_rect.box.area());
+            if (min_area > 0 && inter / min_area > merge_thresh) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) merged.push_back(yolo_rect);
+    }
+    yolo_list.swap(merged);
+}
+
+// 水平方向查找表: 每个输出列对应的两个采样点下标与插值权重 (与 cv::resize 的像素中心对齐方式一致)
+struct LetterboxColumn {
+    int x0, x1;
+    float a;
+};
+
+static void getLetterboxSize(
+    int src_width, int src_height, int infer_width, int infer_height,
+    int& new_width, int& new_height, int& pad_x, int& pad_y
+) {
+    double scale = std::min((double)infer_width / src_width, (double)infer_height / src_height);
+    new_width = std::min(infer_width, (int)std::round(src_width * scale));
+    new_height = std::min(infer_height, (int)std::round(src_height * scale));
+    pad_x = (infer_width - new_width) / 2;
+    pad_y = (infer_height - new_height) / 2;
+}
+
+static void getLinearIndex(int dst, double ratio, int length, int& i0, int& i1, float& a) {
+    double f = (dst + 0.5) * ratio - 0.5;
+    i0 = (int)std::floor(f);
+    a = (float)(f - i0);
+    if (i0 < 0) { i0 = 0; a = 0.f; }
+    if (i0 >= length - 1) { i0 = length - 1; a = 0.f; }
+    i1 = std::min(i0 + 1, length - 1);
+}
+
+void letterboxBlob(
+    const cv::Mat& src,
+    float* dst,
+    int infer_width,
+    int infer_height,
+    bool swap_rb,
+    float pad_value,
+    float norm_scale
+) {
+    // Bayer 图像按 2x2 单元直接采样 RGB，缩放倍率远大于 2 时与先去马赛克再缩放几乎无差别
+    bool bayer = (src.channels() == 1);
+    int grid_width = bayer ? src.cols / 2 : src.cols;
+    int grid_height = bayer ? src.rows / 2 : src.rows;
+
+    int new_width, new_height, pad_x, pad_y;
+    getLetterboxSize(src.cols, src.rows, infer_width, infer_height, new_width, new_height, pad_x, pad_y);
+
+    std::vector<LetterboxColumn> columns(new_width);
+    double ratio_x = (double)grid_width / new_width;
+    double ratio_y = (double)grid_height / new_height;
+    for (int x = 0; x < new_width; x++) {
+        getLinearIndex(x, ratio_x, grid_width, columns[x].x0, columns[x].x1, columns[x].a);
+    }
+
+    size_t plane = (size_t)infer_width * infer_height;
+    float pad = pad_value * norm_scale;
+    int r_index = swap_rb ? 0 : 2;
+    int b_index = swap_rb ? 2 : 0;
+
+    // 对一行采样网格做水平插值，结果按输出通道顺序写入 line[3][new_width]
+    auto sample_row = [&](int gy, float* line) {
+        float* lr = line + r_index * new_width;
+        float* lg = line + new_width;
+        float* lb = line + b_index * new_width;
+        if (bayer) {
+            const uint8_t* p0 = src.ptr<uint8_t>(gy * 2);
+            const uint8_t* p1 = src.ptr<uint8_t>(gy * 2 + 1);
+            for (int x = 0; x < new_width; x++) {
+                const LetterboxColumn& c = columns[x];
+                int i0 = c.x0 * 2, i1 = c.x1 * 2;
+                float b0 = 1.f - c.a;
+                lr[x] = p0[i0] * b0 + p0[i1] * c.a;
+                lg[x] = ((p0[i0 + 1] + p1[i0]) * b0 + (p0[i1 + 1] + p1[i1]) * c.a) * 0.5f;
+                lb[x] = p1[i0 + 1] * b0 + p1[i1 + 1] * c.a;
+            }
+        } else {
+            const uint8_t* p = src.ptr<uint8_t>(gy);
+            for (int x = 0; x < new_width; x++) {
+                const LetterboxColumn& c = columns[x];
+                const uint8_t* q0 = p + c.x0 * 3;
+                const uint8_t* q1 = p + c.x1 * 3;
+                float b0 = 1.f - c.a;
+                lb[x] = q0[0] * b0 + q1[0] * c.a;
+                lg[x] = q0[1] * b0 + q1[1] * c.a;
+                lr[x] = q0[2] * b0 + q1[2] * c.a;
+            }
+        }
+    };
+
+    // 按行带并行，每个行带持有自己的两行水平插值缓存
+    cv::parallel_for_(cv::Range(0, infer_height), [&](const cv::Range& range) {
+        std::vector<float> line0(3 * new_width), line1(3 * new_width);
+        int cached0 = -1, cached1 = -1;
+
+        for (int y = range.start; y < range.end; y++) {
+            int gy = y - pad_y;
+            if (gy < 0 || gy >= new_height) {
+                for (int c = 0; c < 3; c++) std::fill_n(dst + c * plane + (size_t)y * infer_width, infer_width, pad);
+                continue;
+            }
+
+            int y0, y1;
+            float a;
+            getLinearIndex(gy, ratio_y, grid_height, y0, y1, a);
+            if (cached0 != y0) {
+                if (cached1 == y0) { line0.swap(line1); std::swap(cached0, cached1); }
+                else { sample_row(y0, line0.data()); cached0 = y0; }
+            }
+            if (cached1 != y1) { sample_row(y1, line1.data()); cached1 = y1; }
+
+            // 垂直插值与归一化向量化，直接写入平面张量
+            for (int c = 0; c < 3; c++) {
+                float* out = dst + c * plane + (size_t)y * infer_width;
+                const float* l0 = line0.data() + c * new_width;
+                const float* l1 = line1.data() + c * new_width;
+                std::fill_n(out, pad_x, pad);
+                std::fill_n(out + pad_x + new_width, infer_width - pad_x - new_width, pad);
+                out += pad_x;
+
+                int x = 0;
+#if CV_SIMD
+                cv::v_float32 va = cv::vx_setall_f32(a);
+                cv::v_float32 vs = cv::vx_setall_f32(norm_scale);
+                for (; x <= new_width - cv::v_float32::nlanes; x += cv::v_float32::nlanes) {
+                    cv::v_float32 v0 = cv::vx_load(l0 + x);
+                    cv::v_float32 v1 = cv::vx_load(l1 + x);
+                    cv::v_store(out + x, cv::v_fma(v1 - v0, va, v0) * vs);
+                }
+#endif
+                for (; x < new_width; x++) out[x] = (l0[x] + (l1[x] - l0[x]) * a) * norm_scale;
+            }
+        }
+    }, 8);
+}
+
+// OpenCV 逐步实现，作为基准与误差参考
+static void letterboxBlobReference(
+    const cv::Mat& src, float* dst, int infer_width, int infer_height, bool swap_rb, float pad_value, float norm_scale
+) {
+    int new_width, new_height, pad_x, pad_y;
+    getLetterboxSize(src.cols, src.rows, infer_width, infer_height, new_width, new_height, pad_x, pad_y);
+
+    cv::Mat resized, padded, float_image;
+    cv::resize(src, resized, cv::Size(new_width, new_height), 0, 0, cv::INTER_LINEAR);
+    cv::copyMakeBorder(
+        resized, padded,
+        pad_y, infer_height - new_height - pad_y,
+        pad_x, infer_width - new_width - pad_x,
+        cv::BORDER_CONSTANT, cv::Scalar(pad_value, pad_value, pad_value));
+    if (swap_rb) cv::cvtColor(padded, padded, cv::COLOR_BGR2RGB);
+    padded.convertTo(float_image, CV_32F, norm_scale);
+
+    size_t plane = (size_t)infer_width * infer_height;
+    std::vector<cv::Mat> planes;
+    for (int c = 0; c < 3; c++) planes.emplace_back(infer_height, infer_width, CV_32FC1, dst + c * plane);
+    cv::split(float_image, planes);
+}
+
+void benchmarkLetterbox(int src_width, int src_height, int infer_width, int infer_height, int iterations) {
+    cv::Mat src(src_height, src_width, CV_8UC3);
+    cv::randu(src, cv::Scalar(0, 0, 0), cv::Scalar(256, 256, 256));
+
+    auto param = Param::get_instance();
+    bool swap_rb    = (*param)["Model"]["YoloArmor"]["CPU"]["SwapRB"];
+    float pad_value = (*param)["Model"]["YoloArmor"]["CPU"]["PadValue"];
+
+    size_t size = (size_t)3 * infer_width * infer_height;
+    std::vector<float> fused(size), reference(size);
+
+    cv::TickMeter fused_meter, reference_meter;
+    for (int i = 0; i < iterations; i++) {
+        fused_meter.start();
+        letterboxBlob(src, fused.data(), infer_width, infer_height, swap_rb, pad_value, 1.f / 255.f);
+        fused_meter.stop();
+
+        reference_meter.start();
+        letterboxBlobReference(src, reference.data(), infer_width, infer_height, swap_rb, pad_value, 1.f / 255.f);
+        reference_meter.stop();
+    }
+
+    // cv::resize 对 8 位图像使用定点权重，与浮点插值存在 1 个灰度级以内的差异
+    double max_diff = 0.0;
+    for (size_t i = 0; i < size; i++) max_diff = std::max(max_diff, (double)std::fabs(fused[i] - reference[i]));
+
+    std::cout << "[LETTERBOX] " << src_width << "x" << src_height << " -> " << infer_width << "x" << infer_height
+              << " (" << iterations << " 次平均): fused " << fused_meter.getTimeMilli() / iterations
+              << " ms, opencv " << reference_meter.getTimeMilli() / iterations
+              << " ms, 最大误差 " << max_diff * 255 << " 灰度级" << std::endl;
+}